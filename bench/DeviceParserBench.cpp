@@ -0,0 +1,268 @@
+#include "EspGenerator.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/resource.h>
+#endif
+
+// Parse throughput, allocations, peak heap and property lookup latency of DeviceMod on synthetic plugins.
+// Results are printed as JSON, so they can be stored and compared between commits
+
+namespace
+{
+    //=== allocation tracking. Every allocation have header with its size, so current and peak heap can be tracked
+    struct AllocStats
+    {
+        std::atomic<uint64_t> count     = 0;
+        std::atomic<uint64_t> bytes     = 0;
+        std::atomic<uint64_t> current   = 0;
+        std::atomic<uint64_t> peak      = 0;
+    };
+    AllocStats g_alloc;
+
+    constexpr size_t AllocHeader = 16;
+
+    void* TrackedAlloc(size_t a_size)
+    {
+        uint8_t* loc_ptr = static_cast<uint8_t*>(std::malloc(a_size + AllocHeader));
+        if (loc_ptr == nullptr) throw std::bad_alloc();
+        *reinterpret_cast<size_t*>(loc_ptr) = a_size;
+        g_alloc.count.fetch_add(1,std::memory_order_relaxed);
+        g_alloc.bytes.fetch_add(a_size,std::memory_order_relaxed);
+        const uint64_t loc_current = g_alloc.current.fetch_add(a_size,std::memory_order_relaxed) + a_size;
+        uint64_t loc_peak = g_alloc.peak.load(std::memory_order_relaxed);
+        while (loc_current > loc_peak && !g_alloc.peak.compare_exchange_weak(loc_peak,loc_current,std::memory_order_relaxed)) {}
+        return loc_ptr + AllocHeader;
+    }
+
+    void TrackedFree(void* a_ptr)
+    {
+        if (a_ptr == nullptr) return;
+        uint8_t* loc_ptr = static_cast<uint8_t*>(a_ptr) - AllocHeader;
+        g_alloc.current.fetch_sub(*reinterpret_cast<size_t*>(loc_ptr),std::memory_order_relaxed);
+        std::free(loc_ptr);
+    }
+
+    void ResetAllocStats()
+    {
+        g_alloc.count   = 0;
+        g_alloc.bytes   = 0;
+        g_alloc.peak    = g_alloc.current.load();
+    }
+
+    struct Options
+    {
+        size_t      plugins     = 4;
+        size_t      devices     = 2000;
+        size_t      properties  = 16;
+        size_t      lookups     = 200000;
+        size_t      repeats     = 5;
+        uint32_t    seed        = 1U;
+        std::string out;
+        std::string corpus;     //folder to which generated plugins are written, for use as fuzz seeds
+    };
+
+    Options ParseOptions(int a_argc, char** a_argv)
+    {
+        Options loc_res;
+        for (int i = 1; i + 1 < a_argc; i += 2)
+        {
+            const std::string_view loc_name = a_argv[i];
+            const char* loc_value = a_argv[i + 1];
+            if      (loc_name == "--plugins")       loc_res.plugins     = std::strtoull(loc_value,nullptr,10);
+            else if (loc_name == "--devices")       loc_res.devices     = std::strtoull(loc_value,nullptr,10);
+            else if (loc_name == "--properties")    loc_res.properties  = std::strtoull(loc_value,nullptr,10);
+            else if (loc_name == "--lookups")       loc_res.lookups     = std::strtoull(loc_value,nullptr,10);
+            else if (loc_name == "--repeats")       loc_res.repeats     = std::max<size_t>(std::strtoull(loc_value,nullptr,10),1);
+            else if (loc_name == "--seed")          loc_res.seed        = static_cast<uint32_t>(std::strtoul(loc_value,nullptr,10));
+            else if (loc_name == "--out")           loc_res.out         = loc_value;
+            else if (loc_name == "--corpus")        loc_res.corpus      = loc_value;
+            else std::fprintf(stderr,"Unknown option %s\n",a_argv[i]);
+        }
+        return loc_res;
+    }
+
+    double Percentile(std::vector<double>& a_values, double a_percentile)
+    {
+        if (a_values.empty()) return 0.0;
+        const size_t loc_index = std::min(a_values.size() - 1,static_cast<size_t>(a_percentile/100.0*a_values.size()));
+        std::nth_element(a_values.begin(),a_values.begin() + loc_index,a_values.end());
+        return a_values[loc_index];
+    }
+
+    // Calls getter which matches property type, so every type of property is measured
+    size_t LookupProperty(const DeviousDevices::DeviceHandle& a_handle, const DeviousDevices::Bench::EspGenerator::PropertyInfo& a_property)
+    {
+        using Types = DeviousDevices::Property::PropertyTypes;
+        switch (a_property.type)
+        {
+            case Types::kObject:        return a_handle.GetPropertyOBJ(a_property.name,0,true);
+            case Types::kWString:       return a_handle.GetPropertySTR(a_property.name,"").size();
+            case Types::kInt:           return static_cast<size_t>(a_handle.GetPropertyINT(a_property.name,0));
+            case Types::kFloat:         return static_cast<size_t>(a_handle.GetPropertyFLT(a_property.name,0.0f));
+            case Types::kBool:          return a_handle.GetPropertyBOL(a_property.name,false);
+            case Types::kArrayObject:   return a_handle.GetPropertyOBJA(a_property.name).size();
+            case Types::kArrayWString:  return a_handle.GetPropertySTRA(a_property.name).size();
+            case Types::kArrayInt:      return a_handle.GetPropertyINTA(a_property.name).size();
+            case Types::kArrayFloat:    return a_handle.GetPropertyFLTA(a_property.name).size();
+            case Types::kArrayBool:     return a_handle.GetPropertyBOLA(a_property.name).size();
+        }
+        return 0;
+    }
+}
+
+void* operator new(size_t a_size) { return TrackedAlloc(a_size); }
+void* operator new[](size_t a_size) { return TrackedAlloc(a_size); }
+void operator delete(void* a_ptr) noexcept { TrackedFree(a_ptr); }
+void operator delete[](void* a_ptr) noexcept { TrackedFree(a_ptr); }
+void operator delete(void* a_ptr, size_t) noexcept { TrackedFree(a_ptr); }
+void operator delete[](void* a_ptr, size_t) noexcept { TrackedFree(a_ptr); }
+
+int main(int a_argc, char** a_argv)
+{
+    using namespace DeviousDevices;
+    using Clock = std::chrono::steady_clock;
+
+    const Options loc_options = ParseOptions(a_argc,a_argv);
+
+    Bench::EspGenerator::Settings loc_settings;
+    loc_settings.devices    = loc_options.devices;
+    loc_settings.properties = loc_options.properties;
+    loc_settings.seed       = loc_options.seed;
+    Bench::EspGenerator loc_generator(loc_settings);
+
+    const std::vector<std::string> loc_masters = {"Skyrim.esm","Devious Devices - Assets.esm","Devious Devices - Integration.esm"};
+    std::vector<std::vector<uint8_t>> loc_plugins;
+    size_t loc_totalBytes = 0;
+    for (size_t i = 0; i < loc_options.plugins; i++)
+    {
+        const Fixtures::EspBuilder loc_plugin = loc_generator.Generate(loc_masters);
+        if (!loc_options.corpus.empty() && !loc_plugin.WriteFile(std::filesystem::path(loc_options.corpus) / ("BenchMod" + std::to_string(i) + ".esp")))
+        {
+            std::fprintf(stderr,"Failed to write plugin to %s\n",loc_options.corpus.c_str());
+            return 1;
+        }
+        loc_plugins.push_back(loc_plugin.Build());
+        loc_totalBytes += loc_plugins.back().size();
+    }
+
+    //malformed seeds are only written to corpus, so they don't change measured results
+    if (!loc_options.corpus.empty())
+    {
+        const auto loc_truncated = loc_generator.GenerateTruncated(loc_masters,7);
+        for (size_t i = 0; i < loc_truncated.size(); i++)
+        {
+            if (!loc_truncated[i].WriteFile(std::filesystem::path(loc_options.corpus) / ("TruncatedVmad" + std::to_string(i) + ".esp")))
+            {
+                std::fprintf(stderr,"Failed to write plugin to %s\n",loc_options.corpus.c_str());
+                return 1;
+            }
+        }
+    }
+
+    //=== parse
+    std::vector<double> loc_parseTimes;
+    uint64_t loc_allocCount = 0;
+    uint64_t loc_allocBytes = 0;
+    uint64_t loc_peakHeap   = 0;
+    size_t   loc_records    = 0;
+    std::vector<std::unique_ptr<DeviceMod>> loc_mods;
+    for (size_t r = 0; r < loc_options.repeats; r++)
+    {
+        loc_mods.clear();
+
+        //DeviceMod takes ownership of raw data, so it is copied before measurement
+        std::vector<uint8_t*> loc_raw;
+        for (auto&& it : loc_plugins)
+        {
+            loc_raw.push_back(new uint8_t[it.size()]);
+            std::memcpy(loc_raw.back(),it.data(),it.size());
+        }
+
+        const uint64_t loc_baseHeap = g_alloc.current.load();
+        ResetAllocStats();
+        const auto loc_start = Clock::now();
+        for (size_t i = 0; i < loc_plugins.size(); i++)
+        {
+            loc_mods.push_back(std::make_unique<DeviceMod>("BenchMod" + std::to_string(i) + ".esp",loc_raw[i],loc_plugins[i].size()));
+        }
+        loc_parseTimes.push_back(std::chrono::duration<double>(Clock::now() - loc_start).count());
+
+        loc_allocCount = g_alloc.count.load();
+        loc_allocBytes = g_alloc.bytes.load();
+        loc_peakHeap   = g_alloc.peak.load() - loc_baseHeap;
+    }
+    for (auto&& it : loc_mods)
+    {
+        //generated devices point to themselves, so wrong parse results are caught before they are reported
+        for (auto&& it2 : it->devicerecords)
+        {
+            if (it2->GetPropertyOBJ("deviceInventory",0,true) != it2->record.formId)
+            {
+                std::fprintf(stderr,"Device 0x%08X parsed incorrectly\n",it2->record.formId);
+                return 2;
+            }
+        }
+        loc_records += it->devicerecords.size();
+    }
+    std::vector<double> loc_sortedParse = loc_parseTimes;
+    const double loc_parseMedian = Percentile(loc_sortedParse,50.0);
+
+    //=== property lookups on random devices
+    const auto& loc_properties = loc_generator.GetProperties();
+    std::vector<const DeviceHandle*> loc_handles;
+    for (auto&& it : loc_mods) for (auto&& it2 : it->devicerecords) loc_handles.push_back(it2.get());
+
+    std::mt19937 loc_random(loc_options.seed);
+    std::vector<double> loc_latencies;
+    loc_latencies.reserve(loc_options.lookups);
+    size_t loc_sink = 0;
+    const auto loc_lookupStart = Clock::now();
+    for (size_t i = 0; i < loc_options.lookups && !loc_handles.empty(); i++)
+    {
+        const DeviceHandle& loc_handle = *loc_handles[loc_random() % loc_handles.size()];
+        const auto& loc_property = loc_properties[loc_random() % loc_properties.size()];
+        const auto loc_start = Clock::now();
+        loc_sink += LookupProperty(loc_handle,loc_property);
+        loc_latencies.push_back(std::chrono::duration<double,std::nano>(Clock::now() - loc_start).count());
+    }
+    const double loc_lookupTotal = std::chrono::duration<double,std::nano>(Clock::now() - loc_lookupStart).count();
+
+    long loc_maxRss = 0;
+#if defined(__unix__) || defined(__APPLE__)
+    rusage loc_usage = {};
+    if (getrusage(RUSAGE_SELF,&loc_usage) == 0) loc_maxRss = loc_usage.ru_maxrss;
+#endif
+
+    //=== report
+    char loc_buffer[2048];
+    std::snprintf(loc_buffer,sizeof(loc_buffer),
+        "{\n"
+        "  \"benchmark\": \"DeviceParser\",\n"
+        "  \"config\": {\"plugins\": %zu, \"devices\": %zu, \"properties\": %zu, \"lookups\": %zu, \"repeats\": %zu, \"seed\": %u},\n"
+        "  \"parse\": {\"bytes\": %zu, \"records\": %zu, \"time_ms_median\": %.3f, \"time_ms_best\": %.3f, \"throughput_mb_s\": %.2f},\n"
+        "  \"allocations\": {\"count\": %llu, \"bytes\": %llu, \"per_record\": %.1f, \"peak_heap_bytes\": %llu, \"max_rss_kb\": %ld},\n"
+        "  \"lookup\": {\"mean_ns\": %.1f, \"p50_ns\": %.1f, \"p99_ns\": %.1f, \"max_ns\": %.1f},\n"
+        "  \"checksum\": %zu\n"
+        "}\n",
+        loc_options.plugins,loc_options.devices,loc_properties.size(),loc_options.lookups,loc_options.repeats,loc_options.seed,
+        loc_totalBytes,loc_records,loc_parseMedian*1000.0,*std::min_element(loc_parseTimes.begin(),loc_parseTimes.end())*1000.0,
+        loc_totalBytes/loc_parseMedian/(1024.0*1024.0),
+        static_cast<unsigned long long>(loc_allocCount),static_cast<unsigned long long>(loc_allocBytes),
+        loc_records ? static_cast<double>(loc_allocCount)/loc_records : 0.0,static_cast<unsigned long long>(loc_peakHeap),loc_maxRss,
+        loc_latencies.empty() ? 0.0 : loc_lookupTotal/loc_latencies.size(),Percentile(loc_latencies,50.0),Percentile(loc_latencies,99.0),
+        loc_latencies.empty() ? 0.0 : *std::max_element(loc_latencies.begin(),loc_latencies.end()),
+        loc_sink);
+
+    std::fputs(loc_buffer,stdout);
+    if (!loc_options.out.empty())
+    {
+        std::ofstream loc_file(loc_options.out,std::ios::out | std::ios::trunc);
+        if (!loc_file.is_open())
+        {
+            std::fprintf(stderr,"Failed to open %s\n",loc_options.out.c_str());
+            return 1;
+        }
+        loc_file << loc_buffer;
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "EspBuilder.h"
+
+namespace DeviousDevices::Bench
+{
+    // Generates synthetic DD plugins with random property values. Every device record has EDID, VMAD with one script
+    // and KSIZ/KWDA fields, so it goes through the same parser paths as real DD devices
+    class EspGenerator
+    {
+    public:
+        struct Settings
+        {
+            size_t      devices     = 1000;
+            size_t      properties  = 16;   //per device, including deviceInventory and deviceRendered
+            size_t      keywords    = 4;
+            uint32_t    seed        = 1U;
+        };
+
+        struct PropertyInfo
+        {
+            std::string                     name;
+            Property::PropertyTypes         type;
+        };
+
+        explicit EspGenerator(const Settings& a_settings) : _settings(a_settings), _random(a_settings.seed)
+        {
+            static constexpr std::array<Property::PropertyTypes,9> loc_types =
+            {
+                Property::PropertyTypes::kInt,          Property::PropertyTypes::kFloat,        Property::PropertyTypes::kBool,
+                Property::PropertyTypes::kWString,      Property::PropertyTypes::kArrayObject,  Property::PropertyTypes::kArrayInt,
+                Property::PropertyTypes::kArrayFloat,   Property::PropertyTypes::kArrayBool,    Property::PropertyTypes::kArrayWString
+            };
+            _properties.push_back({"deviceInventory",Property::PropertyTypes::kObject});
+            _properties.push_back({"deviceRendered",Property::PropertyTypes::kObject});
+            for (size_t i = 2; i < std::max<size_t>(a_settings.properties,2); i++)
+            {
+                _properties.push_back({"zad_Property" + std::to_string(i),loc_types[i % loc_types.size()]});
+            }
+        }
+
+        const std::vector<PropertyInfo>& GetProperties() const { return _properties; }
+
+        Fixtures::EspBuilder Generate(const std::vector<std::string>& a_masters)
+        {
+            Fixtures::EspBuilder loc_res;
+            for (auto&& it : a_masters) loc_res.AddMaster(it);
+
+            for (size_t i = 0; i < _settings.devices; i++)
+            {
+                const uint32_t loc_inventory = loc_res.GetFormID(static_cast<uint32_t>(0x800 + 2*i));
+                loc_res.AddRecord(Fixtures::RecordBuilder("ARMO",loc_inventory)
+                    .SetEditorID("zadBenchDevice" + std::to_string(i))
+                    .SetScripts(MakeScripts(loc_inventory))
+                    .SetKeywords(MakeKeywords()));
+            }
+            return loc_res;
+        }
+
+        // Plugins with device which scripts are cut inside VMAD, one plugin per every a_step bytes. Cut device is
+        // followed by valid one. Used as fuzz seeds of malformed scripts
+        std::vector<Fixtures::EspBuilder> GenerateTruncated(const std::vector<std::string>& a_masters, size_t a_step)
+        {
+            std::vector<Fixtures::EspBuilder> loc_res;
+            Fixtures::EspBuilder loc_base;
+            for (auto&& it : a_masters) loc_base.AddMaster(it);
+
+            const uint32_t                  loc_inventory   = loc_base.GetFormID(0x800);
+            const Fixtures::VmadBuilder     loc_vmad        = MakeScripts(loc_inventory);
+            const std::vector<uint32_t>     loc_keywords    = MakeKeywords();
+            const size_t                    loc_size        = loc_vmad.Build().size();
+            for (size_t loc_cut = 0; loc_cut < loc_size; loc_cut += std::max<size_t>(a_step,1))
+            {
+                Fixtures::EspBuilder& loc_plugin = loc_res.emplace_back(loc_base);
+                loc_plugin.AddRecord(Fixtures::RecordBuilder("ARMO",loc_inventory)
+                    .SetEditorID("zadTruncatedDevice")
+                    .SetTruncatedScripts(loc_vmad,loc_cut)
+                    .SetKeywords(loc_keywords));
+                loc_plugin.AddRecord(Fixtures::RecordBuilder("ARMO",loc_inventory + 2)
+                    .SetEditorID("zadBenchDevice")
+                    .SetScripts(MakeScripts(loc_inventory + 2))
+                    .SetKeywords(loc_keywords));
+            }
+            return loc_res;
+        }
+
+    private:
+        Fixtures::VmadBuilder MakeScripts(uint32_t a_inventory)
+        {
+            Fixtures::VmadBuilder loc_res;
+            loc_res.AddScript("zadEquipScript");
+            for (auto&& it : _properties)
+            {
+                if (it.name == "deviceInventory")       loc_res.AddObject(it.name,a_inventory);
+                else if (it.name == "deviceRendered")   loc_res.AddObject(it.name,a_inventory + 1);
+                else AddValue(loc_res,it);
+            }
+            return loc_res;
+        }
+
+        std::vector<uint32_t> MakeKeywords()
+        {
+            std::vector<uint32_t> loc_res;
+            for (size_t k = 0; k < _settings.keywords; k++) loc_res.push_back(RandomForm());
+            return loc_res;
+        }
+
+        uint32_t    RandomForm()    { return 0x01000000U | (_random() & 0xFFFFFF); }
+        std::string RandomString()  { return "value" + std::to_string(_random() % 1000); }
+        float       RandomFloat()   { return static_cast<float>(_random() % 1000)/10.0f; }
+
+        void AddValue(Fixtures::VmadBuilder& a_vmad, const PropertyInfo& a_property)
+        {
+            const size_t loc_count = 1 + _random() % 4;
+            auto loc_array = [&](auto a_generator)
+            {
+                std::vector<decltype(a_generator())> loc_res;
+                for (size_t i = 0; i < loc_count; i++) loc_res.push_back(a_generator());
+                return loc_res;
+            };
+            switch (a_property.type)
+            {
+                case Property::PropertyTypes::kObject:          a_vmad.AddObject(a_property.name,RandomForm()); break;
+                case Property::PropertyTypes::kWString:         a_vmad.AddString(a_property.name,RandomString()); break;
+                case Property::PropertyTypes::kInt:             a_vmad.AddInt(a_property.name,static_cast<int32_t>(_random() % 100)); break;
+                case Property::PropertyTypes::kFloat:           a_vmad.AddFloat(a_property.name,RandomFloat()); break;
+                case Property::PropertyTypes::kBool:            a_vmad.AddBool(a_property.name,_random() & 1); break;
+                case Property::PropertyTypes::kArrayObject:     a_vmad.AddObjectArray(a_property.name,loc_array([&]{ return RandomForm(); })); break;
+                case Property::PropertyTypes::kArrayWString:    a_vmad.AddStringArray(a_property.name,loc_array([&]{ return RandomString(); })); break;
+                case Property::PropertyTypes::kArrayInt:        a_vmad.AddIntArray(a_property.name,loc_array([&]{ return static_cast<int32_t>(_random() % 100); })); break;
+                case Property::PropertyTypes::kArrayFloat:      a_vmad.AddFloatArray(a_property.name,loc_array([&]{ return RandomFloat(); })); break;
+                case Property::PropertyTypes::kArrayBool:       a_vmad.AddBoolArray(a_property.name,loc_array([&]{ return (_random() & 1) != 0; })); break;
+            }
+        }
+
+        Settings                    _settings;
+        std::mt19937                _random;
+        std::vector<PropertyInfo>   _properties;
+    };
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+// Replacement of src/PCH.h for host builds. Only standard library is available, and plugin logging is removed
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#define LOG(...)    {}
+#define DEBUG(...)  {}
+#define WARN(...)   {}
+#define ERROR(...)  {}
+#define CLOG(...)   {}
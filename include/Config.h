@@ -6,26 +6,111 @@
 #include <boost/lexical_cast.hpp>
 #include "Utils.h"
 
+// Registered config variables - X(section, name, type, default value)
+#define DD_CONFIG_VARIABLES(X)                                              \
+    X(Main,             bPrintDB,               bool,   false)              \
+    X(Main,             iLogging,               int,    1)                  \
+    X(Main,             bSyncLogging,           bool,   false)              \
+    X(Main,             iConfigPollTime,        int,    2000)               \
+    X(Main,             bLockStats,             bool,   false)              \
+    X(Main,             bProfiling,             bool,   false)              \
+    X(Main,             bTracing,               bool,   false)              \
+    X(Main,             iTraceBufferSize,       int,    16384)              \
+    X(InventoryFilter,  bGagFilterModeMenu,     bool,   false)              \
+    X(InventoryFilter,  bEquipFilterModeMenu,   bool,   false)              \
+    X(InventoryFilter,  bEquipSpell,            bool,   true)               \
+    X(InventoryFilter,  bEquipShout,            bool,   true)               \
+    X(GagExpression,    bNPCsEnabled,           bool,   true)               \
+    X(GagExpression,    iUpdatePlayerTime,      int,    500)                \
+    X(GagExpression,    iNPCUpdateTime,         int,    120)                \
+    X(GagExpression,    iPresetRefreshTime,     int,    5000)               \
+    X(Expression,       fFadeTime,              float,  0.25f)              \
+    X(Expression,       fGagFadeTime,           float,  0.25f)              \
+    X(UpdateManager,    iNPCFrameBudget,        int,    500)                \
+    X(UpdateManager,    bLODEnabled,            bool,   true)               \
+    X(UpdateManager,    fLODNearDistance,       float,  1500.0f)            \
+    X(UpdateManager,    fLODFarDistance,        float,  6000.0f)            \
+    X(UpdateManager,    fLODFarMultiplier,      float,  4.0f)               \
+    X(UpdateManager,    bLODDeferOffscreen,     bool,   true)               \
+    X(DeviceHider,      bNPCsEnabled,           bool,   true)               \
+    X(DeviceHider,      bOnlyDevices,           bool,   true)               \
+    X(NodeHider,        bEnabled,               bool,   true)               \
+    X(NodeHider,        iUpdatePlayerTime,      int,    500)                \
+    X(NodeHider,        iNPCUpdateTime,         int,    60)                 \
+    X(NodeHider,        bHideArms,              bool,   false)              \
+    X(NodeHider,        bHideArmsFirstPerson,   bool,   true)
+
+// Registered config string arrays - X(section, name, lowercase)
+#define DD_CONFIG_ARRAYS(X)                                                 \
+    X(InventoryFilter,  asWhitelist,            true)                       \
+    X(InventoryFilter,  asWhitelistFood,        true)                       \
+    X(InventoryFilter,  asKeywordSlots,         false)                      \
+    X(Movement,         asForceWalkKeywords,    false)                      \
+    X(NodeHider,        asWeaponNodes,          false)                      \
+    X(NodeHider,        asArmHiddingKeywords,   false)                      \
+    X(NodeHider,        asHandHiddingKeywords,  false)                      \
+    X(NodeHider,        asFingerHiddingKeywords,false)                      \
+    X(NodeHider,        asArmNodes,             true)                       \
+    X(NodeHider,        asHandNodes,            true)                       \
+    X(NodeHider,        asFingerNodes,          true)
+
 namespace DeviousDevices
 {
+    // Parsed values of all registered variables. Snapshot is never changed once it is published,
+    // so it can be read from any thread without locking. Variable X(Section,Name,...) is stored as Section_Name
+    struct ConfigSnapshot
+    {
+        #define DD_CONFIG_FIELD(a_section,a_name,a_type,a_default) a_type a_section##_##a_name = a_default;
+        DD_CONFIG_VARIABLES(DD_CONFIG_FIELD)
+        #undef DD_CONFIG_FIELD
+
+        #define DD_CONFIG_ARRAY_FIELD(a_section,a_name,a_lowercase) std::vector<std::string> a_section##_##a_name;
+        DD_CONFIG_ARRAYS(DD_CONFIG_ARRAY_FIELD)
+        #undef DD_CONFIG_ARRAY_FIELD
+    };
+
+    // Called on main thread after config is reloaded. Old snapshot stays valid, so listeners can compare values
+    typedef std::function<void(const ConfigSnapshot& a_old, const ConfigSnapshot& a_new)> ConfigReloadListener;
+
     class ConfigManager
     {
     SINGLETONHEADER(ConfigManager)
     public:
         void Setup();
 
+        // Checks if ini file was changed. If it was, it is parsed on worker thread, and the new config is published
+        // and listeners are notified on one of the next calls. Has to be called from main thread
+        void CheckForChanges();
+        void AddReloadListener(ConfigReloadListener a_listener);
+
         void SetLoggingDisable(bool a_val);
         bool GetLoggingDisable() const;
 
+        // Returns current config. Reference stays valid even if config is reloaded
+        const ConfigSnapshot& GetConfig() const { return _snapshot.Get(); }
+
+        // Generic access for variables which are not registered. These parse the ini on every call, so they should not be used on hot paths
         template<typename T> T GetVariable(std::string a_name, T a_def) const;
         template<typename T> std::vector<T> GetArray(std::string a_name, std::string a_sep = ",") const;
         std::vector<std::string> GetArrayText(std::string a_name, bool a_lowercase, std::string a_sep = ",") const;
     private:
         bool _loaded = false;
         boost::property_tree::ptree _config;
-        mutable std::unordered_map<std::string,void*> _catche;
+        SnapshotPublisher<ConfigSnapshot> _snapshot;
         mutable Spinlock _lock;
-        std::vector<std::string> GetArrayRaw(std::string a_name, bool a_tolower, std::string a_sep = ",") const;
         bool _LogDisable = false;
+
+        //reload state
+        std::filesystem::file_time_type     _lastWrite;
+        std::filesystem::file_time_type     _changedWrite;      //write time seen by last check, file is loaded once it stops changing
+        std::atomic<bool>                   _loading = false;
+        std::unique_ptr<ConfigSnapshot>     _pending;           //parsed by worker thread, waiting for publish
+        boost::property_tree::ptree         _pendingConfig;
+        std::vector<ConfigReloadListener>   _listeners;
+
+        bool Load(boost::property_tree::ptree& a_config, std::unique_ptr<ConfigSnapshot>& a_snapshot) const;
+        static void ValidateSnapshot(ConfigSnapshot& a_snapshot);
+        static std::vector<std::string> GetArrayRaw(const boost::property_tree::ptree& a_config, std::string a_name, bool a_tolower, std::string a_sep = ",");
+        template<typename T> static T ReadVariable(const boost::property_tree::ptree& a_config, const std::string& a_name, T a_def);
     };
-}
\ No newline at end of file
+}
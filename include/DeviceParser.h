@@ -0,0 +1,232 @@
+#pragma once
+
+// Parser of ARMO records and their VMAD/KWDA fields from plugin files. Only uses standard library, so the same code
+// is used by plugin and by host benchmarks
+
+namespace DeviousDevices
+{
+    struct FormHandle
+    {
+        uint32_t    id;
+        std::string mod;
+    };
+
+    struct Property
+    {
+        enum class PropertyTypes
+        {
+            kObject         = 1,
+            kWString        = 2,
+            kInt            = 3,
+            kFloat          = 4,
+            kBool           = 5,
+            // 6 - 10 = unused
+            kArrayObject    = 11,
+            kArrayWString   = 12,
+            kArrayInt       = 13,
+            kArrayFloat     = 14,
+            kArrayBool      = 15
+        };
+
+        std::string propertyName;
+        uint8_t propertyType;
+        uint8_t status;
+        std::shared_ptr<uint8_t[]> data;
+    };
+
+    struct Script
+    {
+        std::string scriptName;
+        uint8_t status;
+        uint16_t propertyCount;
+        std::vector<std::unique_ptr<Property>> properties;
+    };
+
+    struct ScriptHandle
+    {
+        int16_t version;
+        int16_t objFormat;
+        uint16_t scriptCount;
+        std::vector<std::unique_ptr<Script>> scripts; 
+    };
+
+    struct FieldHeader
+    {
+        uint8_t     type[4];        //00
+        uint16_t    size;           //04
+    };
+
+    struct KeywordsHandle
+    {
+        //field KSIZ
+        struct KSIZ
+        {
+            FieldHeader header;
+            uint32_t    keywordcount;
+        } ksiz;
+        
+        //field KWDA
+        struct KWDA
+        {
+            FieldHeader               header;
+            std::shared_ptr<uint32_t[]> data; 
+        } kwda;
+    };
+
+    struct DeviceRecord
+    {
+        enum Flags : uint32_t
+        {
+            fCompressed = 0x00040000
+        };
+
+        ~DeviceRecord(){ delete[] data; }
+        uint8_t     type[4];        //00
+        uint32_t    size;           //04
+        uint32_t    flags;          //08
+        uint32_t    formId;         //12
+        uint16_t    timestamp;      //14
+        uint16_t    version;        //16
+        uint16_t    version_i;      //18
+        uint16_t    unkw_1;         //20
+        uint8_t*    data = nullptr; //24 - size
+    };
+
+    class DeviceMod;
+
+    // Checks existence of forms while mod is parsed. Game implementation uses TESDataHandler, so parser itself
+    // does not depend on game and can be built and benchmarked on its own (see bench folder)
+    class FormResolver
+    {
+    public:
+        virtual ~FormResolver() = default;
+
+        // a_formID is form id without mod index, a_mod is file name of mod which defines the form
+        virtual bool HasForm(uint32_t a_formID, const std::string& a_mod) const = 0;
+    };
+
+    struct DeviceHandle
+    {
+        DeviceRecord                    record;
+        std::string                     source;
+        std::string                     editorID;       //empty if record has no EDID field, or if it was not loaded
+        ScriptHandle                    scripts;
+        KeywordsHandle                  keywords;
+        DeviceMod*                      mod;
+        
+        // Return false if field does not fit to record. Partially loaded data is then kept, and should be discarded
+        bool LoadVM();
+        bool LoadKeywords();
+
+        //only usable form form properties
+        //will rework this in future so it will be possible to read all types of properties from file
+        std::pair<std::shared_ptr<uint8_t[]>,uint8_t> GetPropertyRaw(std::string a_name) const;  //get raw property <data,type>
+        const Property* FindProperty(std::string_view a_name) const;                          //case insensitive search, does not allocate
+
+        uint32_t    GetPropertyOBJ(std::string a_name, uint32_t     a_defvalue, bool a_silence) const;  //get object (internal form id)
+        int32_t     GetPropertyINT(std::string a_name, int32_t      a_defvalue) const;  //get int
+        float       GetPropertyFLT(std::string a_name, float        a_defvalue) const;  //get float
+        bool        GetPropertyBOL(std::string a_name, bool         a_defvalue) const;  //get bool
+        std::string GetPropertySTR(std::string a_name, std::string  a_defvalue) const;  //get string
+
+        std::vector<uint32_t>       GetPropertyOBJA(std::string a_name) const;  //get object (internal form id) array
+        std::vector<int32_t>        GetPropertyINTA(std::string a_name) const;  //get int array
+        std::vector<float>          GetPropertyFLTA(std::string a_name) const;  //get float array
+        std::vector<bool>           GetPropertyBOLA(std::string a_name) const;  //get bool array
+        std::vector<std::string>    GetPropertySTRA(std::string a_name) const;  //get string array
+
+        //bulk getters - result is parallel to a_names. Missing property returns value from a_defvalues (or empty value
+        //if a_defvalues is shorter), property of incorrect type returns empty value. Same as single getters, but silent
+        std::vector<uint32_t>       GetPropertiesOBJ(const std::vector<std::string>& a_names, const std::vector<uint32_t>&    a_defvalues) const;
+        std::vector<int32_t>        GetPropertiesINT(const std::vector<std::string>& a_names, const std::vector<int32_t>&     a_defvalues) const;
+        std::vector<float>          GetPropertiesFLT(const std::vector<std::string>& a_names, const std::vector<float>&       a_defvalues) const;
+        std::vector<bool>           GetPropertiesBOL(const std::vector<std::string>& a_names, const std::vector<bool>&        a_defvalues) const;
+        std::vector<std::string>    GetPropertiesSTR(const std::vector<std::string>& a_names, const std::vector<std::string>& a_defvalues) const;
+
+        template<typename T>
+        T* GetFormFromHandle(const uint32_t &a_formid) const;   //defined by DeviceReader, as it needs game data
+    };
+
+    struct DeviceGroup
+    {
+        ~DeviceGroup(){ delete[] data; }
+        uint8_t     grup[4];        //00
+        uint32_t    size = 0U;      //04
+        uint8_t     label[4];       //08
+        int32_t     type;           //12
+        uint16_t    timestamp;      //14
+        uint16_t    version;        //16
+        uint32_t    uknw_1;         //20
+        uint8_t*    data = nullptr; //24 - size
+    };
+
+    struct DeviceMod
+    {
+        // Takes ownership of a_data. If resolver is passed, scripts and keywords are only loaded for records which forms exist
+        DeviceMod(std::string a_name, uint8_t* a_data, size_t a_size, const FormResolver* a_resolver = nullptr);
+        ~DeviceMod(){ delete[] rawdata; }
+
+        void    ParseInfo();
+        size_t  ParseDevices(const FormResolver* a_resolver);
+
+        // Returns file name of mod which defines the form. Form id have to be internal esp formID !!!
+        const std::string& GetSource(const uint32_t a_formID) const;
+
+        template <typename T>
+        T* GetForm(const uint32_t a_formID) const;  // have to be internal esp formID !!! Defined by DeviceReader, as it needs game data
+
+        std::string name;
+        DeviceGroup group_TES4;
+        DeviceGroup group_ARMO;
+        size_t      size;
+        uint8_t*    rawdata = nullptr;
+        std::vector<std::shared_ptr<DeviceHandle>> devicerecords;
+        std::vector<std::string>   masters;
+    };
+
+    // Override history of one device. Versions are ordered by load order of mods which contain them, so first version is
+    // original record and last version is the one used by game. Immutable after construction, so it can be read from any thread
+    class DeviceHistory
+    {
+    public:
+        struct Version
+        {
+            uint32_t                        modIndex;   //load order index of mod
+            std::shared_ptr<DeviceHandle>   handle;
+        };
+
+        DeviceHistory() = default;
+        explicit DeviceHistory(std::vector<Version> a_versions);
+
+        // Version 0 is original record, negative versions are counted from the end (-1 = final record).
+        // Returns nullptr if version doesn't exist
+        const DeviceHandle* GetVersion(int a_version) const;
+        const DeviceHandle* GetOriginal() const { return GetVersion(0); }
+        const DeviceHandle* GetFinal() const    { return GetVersion(-1); }
+        size_t              GetVersionCount() const { return _versions.size(); }
+
+        const std::vector<Version>&     GetVersions() const { return _versions; }
+        const std::vector<std::string>& GetModNames() const { return _modNames; }   //names of mods in the same order as versions
+
+        // Supported types are uint32_t (form), int32_t, float, bool and std::string. Returns a_defvalue if version doesn't exist
+        template <typename T>
+        T GetPropertyAtVersion(int a_version, const std::string& a_name, T a_defvalue) const;
+    private:
+        std::vector<Version>        _versions;
+        std::vector<std::string>    _modNames;
+    };
+
+    template <typename T>
+    T DeviceHistory::GetPropertyAtVersion(int a_version, const std::string& a_name, T a_defvalue) const
+    {
+        const DeviceHandle* loc_handle = GetVersion(a_version);
+        if (loc_handle == nullptr) return a_defvalue;
+
+        if constexpr (std::is_same_v<T,uint32_t>)           return loc_handle->GetPropertyOBJ(a_name,a_defvalue,true);
+        else if constexpr (std::is_same_v<T,int32_t>)       return loc_handle->GetPropertyINT(a_name,a_defvalue);
+        else if constexpr (std::is_same_v<T,float>)         return loc_handle->GetPropertyFLT(a_name,a_defvalue);
+        else if constexpr (std::is_same_v<T,bool>)          return loc_handle->GetPropertyBOL(a_name,a_defvalue);
+        else if constexpr (std::is_same_v<T,std::string>)   return loc_handle->GetPropertySTR(a_name,a_defvalue);
+        else static_assert(sizeof(T) == 0,"Unsupported property type");
+    }
+}
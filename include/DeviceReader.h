@@ -1,156 +1,11 @@
 #pragma once
 
+#include "DeviceParser.h"
+#include "PropertyCache.h"
+#include "NameIndex.h"
+
 namespace DeviousDevices
 {
-    struct FormHandle
-    {
-        RE::FormID  id;
-        std::string mod;
-    };
-
-    struct Property
-    {
-        enum class PropertyTypes
-        {
-            kObject         = 1,
-            kWString        = 2,
-            kInt            = 3,
-            kFloat          = 4,
-            kBool           = 5,
-            // 6 - 10 = unused
-            kArrayObject    = 11,
-            kArrayWString   = 12,
-            kArrayInt       = 13,
-            kArrayFloat     = 14,
-            kArrayBool      = 15
-        };
-
-        std::string propertyName;
-        uint8_t propertyType;
-        uint8_t status;
-        std::shared_ptr<uint8_t> data;
-    };
-
-    struct Script
-    {
-        std::string scriptName;
-        uint8_t status;
-        uint16_t propertyCount;
-        std::vector<std::unique_ptr<Property>> properties;
-    };
-
-    struct ScriptHandle
-    {
-        int16_t version;
-        int16_t objFormat;
-        uint16_t scriptCount;
-        std::vector<std::unique_ptr<Script>> scripts; 
-    };
-
-    struct FieldHeader
-    {
-        uint8_t     type[4];        //00
-        uint16_t    size;           //04
-    };
-
-    struct KeywordsHandle
-    {
-        //field KSIZ
-        struct KSIZ
-        {
-            FieldHeader header;
-            uint32_t    keywordcount;
-        } ksiz;
-        
-        //field KWDA
-        struct KWDA
-        {
-            FieldHeader               header;
-            std::shared_ptr<uint32_t> data; 
-        } kwda;
-    };
-
-    struct DeviceRecord
-    {
-        ~DeviceRecord(){ delete[] data; }
-        uint8_t     type[4];        //00
-        uint32_t    size;           //04
-        uint32_t    flags;          //08
-        uint32_t    formId;         //12
-        uint16_t    timestamp;      //14
-        uint16_t    version;        //16
-        uint16_t    version_i;      //18
-        uint16_t    unkw_1;         //20
-        uint8_t*    data = nullptr; //24 - size
-    };
-
-    class DeviceMod;
-
-    struct DeviceHandle
-    {
-        DeviceRecord                    record;
-        std::string                     source;
-        ScriptHandle                    scripts;
-        KeywordsHandle                  keywords;
-        DeviceMod*                      mod;
-        
-        void LoadVM();
-        void LoadKeywords();
-
-        //only usable form form properties
-        //will rework this in future so it will be possible to read all types of properties from file
-        std::pair<std::shared_ptr<uint8_t>,uint8_t> GetPropertyRaw(std::string a_name) const;  //get raw property <data,type>
-
-        uint32_t    GetPropertyOBJ(std::string a_name, uint32_t     a_defvalue, bool a_silence) const;  //get object (internal form id)
-        int32_t     GetPropertyINT(std::string a_name, int32_t      a_defvalue) const;  //get int
-        float       GetPropertyFLT(std::string a_name, float        a_defvalue) const;  //get float
-        bool        GetPropertyBOL(std::string a_name, bool         a_defvalue) const;  //get bool
-        std::string GetPropertySTR(std::string a_name, std::string  a_defvalue) const;  //get string
-
-        std::vector<uint32_t>       GetPropertyOBJA(std::string a_name) const;  //get object (internal form id) array
-        std::vector<int32_t>        GetPropertyINTA(std::string a_name) const;  //get int array
-        std::vector<float>          GetPropertyFLTA(std::string a_name) const;  //get float array
-        std::vector<bool>           GetPropertyBOLA(std::string a_name) const;  //get bool array
-        std::vector<std::string>    GetPropertySTRA(std::string a_name) const;  //get string array
-
-        template<typename T>
-        T* GetFormFromHandle(const RE::FormID &a_formid) const;
-    };
-
-    struct DeviceGroup
-    {
-        ~DeviceGroup(){ delete[] data; }
-        uint8_t     grup[4];        //00
-        uint32_t    size = 0U;      //04
-        uint8_t     label[4];       //08
-        int32_t     type;           //12
-        uint16_t    timestamp;      //14
-        uint16_t    version;        //16
-        uint32_t    uknw_1;         //20
-        uint8_t*    data = nullptr; //24 - size
-    };
-
-    struct DeviceMod
-    {
-        DeviceMod(std::string a_name, uint8_t* a_data, size_t a_size);
-        ~DeviceMod(){ delete rawdata; }
-
-        void    ParseInfo();
-        size_t  ParseDevices();
-
-        RE::TESForm* GetForm(const DeviceHandle* a_handle) const;
-        template <typename T>
-        T* GetForm(const uint32_t a_formID) const;  // have to be internal esp formID !!!
-
-        std::string name;
-        DeviceGroup group_TES4;
-        DeviceGroup group_ARMO;
-        size_t      size;
-        uint8_t*    rawdata = nullptr;
-        std::vector<std::shared_ptr<DeviceHandle>> devicerecords;
-        std::vector<std::string>   masters;
-    };
-
     class DeviceReader
     {
     SINGLETONHEADER(DeviceReader)
@@ -217,6 +72,10 @@ namespace DeviousDevices
 
         DeviceUnit GetDeviceUnit(std::string a_name);
 
+        //name lookups - device can be found both by its name and by editor ID of its inventory device
+        RE::TESObjectARMO*              FindDeviceByName(std::string_view a_name) const;    //exact match first, case insensitive match second
+        std::vector<RE::TESObjectARMO*> SearchDevices(std::string_view a_text, bool a_substring, size_t a_max) const;   //case insensitive prefix/substring search, sorted by name
+
         template <typename T>
         T*              GetPropertyForm(RE::TESObjectARMO* a_invdevice, std::string a_propertyname,uint32_t a_defvalue,int a_mode)  const;
         RE::TESForm*    GetPropertyForm(RE::TESObjectARMO* a_invdevice, std::string a_propertyname, RE::TESForm* a_defvalue, int a_mode) const;
@@ -233,6 +92,25 @@ namespace DeviousDevices
         std::vector<T*> GetPropertyFormArray(RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_mode) const;
         std::vector<RE::TESForm*> GetPropertyFormArray(RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_mode) const;
 
+        //bulk reads. Device is only searched once, and returned values are parallel to a_propertynames
+        std::vector<RE::TESForm*>   GetPropertiesForm(RE::TESObjectARMO* a_invdevice, const std::vector<std::string>& a_propertynames, const std::vector<RE::TESForm*>& a_defvalues, int a_mode) const;
+        std::vector<int>            GetPropertiesInt(RE::TESObjectARMO* a_invdevice, const std::vector<std::string>& a_propertynames, const std::vector<int>& a_defvalues, int a_mode) const;
+        std::vector<float>          GetPropertiesFloat(RE::TESObjectARMO* a_invdevice, const std::vector<std::string>& a_propertynames, const std::vector<float>& a_defvalues, int a_mode) const;
+        std::vector<bool>           GetPropertiesBool(RE::TESObjectARMO* a_invdevice, const std::vector<std::string>& a_propertynames, const std::vector<bool>& a_defvalues, int a_mode) const;
+        std::vector<std::string>    GetPropertiesString(RE::TESObjectARMO* a_invdevice, const std::vector<std::string>& a_propertynames, const std::vector<std::string>& a_defvalues, int a_mode) const;
+
+        //override history of device, or nullptr if device is not in database. Valid until database is rebuilt
+        const DeviceHistory* GetDeviceHistory(RE::TESObjectARMO* a_invdevice) const;
+
+        //reads property from any version of device - see DeviceHistory::GetVersion
+        template <typename T>
+        T GetPropertyAtVersion(RE::TESObjectARMO* a_invdevice, const std::string& a_propertyname, int a_version, T a_defvalue) const
+        {
+            const DeviceHistory* loc_history = GetDeviceHistory(a_invdevice);
+            return loc_history ? loc_history->GetPropertyAtVersion<T>(a_version,a_propertyname,a_defvalue) : a_defvalue;
+        }
+        RE::TESForm* GetPropertyFormAtVersion(RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_version, RE::TESForm* a_defvalue) const;
+
         inline DeviceUnit* LookupDeviceByInventory(RE::TESObjectARMO* a_id)
         {
             if (!a_id) return nullptr;
@@ -271,6 +149,19 @@ namespace DeviousDevices
         void ParseMods();
         void LoadDB();
 
+        //returns handle of last (a_mode == 0) or original (a_mode != 0) device record, without copying device unit
+        const DeviceHandle* GetDeviceHandle(RE::TESObjectARMO* a_invdevice, int a_mode) const;
+
+        struct ResolvedForm
+        {
+            bool            found   = false;    //false if property doesn't exist on device record
+            RE::TESForm*    form    = nullptr;
+        };
+
+        //form properties resolved through masters of device record. Results never change after data are loaded, so they are cached
+        ResolvedForm                ResolveForm(const DeviceHandle* a_handle, const std::string& a_propertyname) const;
+        std::vector<RE::TESForm*>   ResolveFormArray(const DeviceHandle* a_handle, const std::string& a_propertyname) const;
+
         RE::BGSListForm*                                        _alwaysSilent;
         std::vector<RE::TESFile*>                               _ddmods;
         std::vector<std::shared_ptr<DeviceMod>>                 _ddmodspars;
@@ -279,6 +170,10 @@ namespace DeviousDevices
         std::unordered_map<RE::FormID, DeviceUnit*>             _devicesByRendered;
         std::vector<RE::BGSKeyword*>                            _invDeviceKwds;
         std::set<std::pair<RE::FormID, RE::FormID>>             _manipulated; // serde
+        mutable PropertyCache<ResolvedForm>                     _formCache;
+        mutable PropertyCache<std::vector<RE::TESForm*>>        _formArrayCache;
+        std::unordered_map<RE::FormID, DeviceHistory>           _deviceHistories;   //built at end of LoadDB, read only afterwards
+        NameIndex<RE::TESObjectARMO*>                           _nameIndex;         //built at end of LoadDB, read only afterwards
         bool                                                    _installed = false;
     };
 
@@ -287,6 +182,7 @@ namespace DeviousDevices
     RE::TESObjectARMO* GetRenderDevice(PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_invdevice);
     RE::TESObjectARMO* GetInventoryDevice(PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_renddevice);
     RE::TESObjectARMO* GetDeviceByName(PAPYRUSFUNCHANDLE,std::string a_name); //just because this exist doesn't mean that it should be used ;)
+    std::vector<RE::TESObjectARMO*> SearchDevices(PAPYRUSFUNCHANDLE,std::string a_text, bool a_substring, int a_maxcount);
 
     //read interface
     RE::TESForm*    GetPropertyForm(    PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_invdevice, std::string a_propertyname,RE::TESForm*   a_defvalue, int a_mode);
@@ -300,6 +196,13 @@ namespace DeviousDevices
     std::vector<bool>           GetPropertyBoolArray(   PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_mode);
     std::vector<std::string>    GetPropertyStringArray( PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_mode);
 
+    //bulk read interface
+    std::vector<RE::TESForm*>   GetPropertiesForm(  PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_invdevice, std::vector<std::string> a_propertynames, std::vector<RE::TESForm*>   a_defvalues, int a_mode);
+    std::vector<int>            GetPropertiesInt(   PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_invdevice, std::vector<std::string> a_propertynames, std::vector<int>            a_defvalues, int a_mode);
+    std::vector<float>          GetPropertiesFloat( PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_invdevice, std::vector<std::string> a_propertynames, std::vector<float>          a_defvalues, int a_mode);
+    std::vector<bool>           GetPropertiesBool(  PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_invdevice, std::vector<std::string> a_propertynames, std::vector<bool>           a_defvalues, int a_mode);
+    std::vector<std::string>    GetPropertiesString(PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_invdevice, std::vector<std::string> a_propertynames, std::vector<std::string>    a_defvalues, int a_mode);
+
     
 
     // device manipulation
@@ -316,4 +219,12 @@ namespace DeviousDevices
 
     //returns all mods which edited the device
     std::vector<std::string>    GetEditingMods(PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_invdevice);
+
+    //versioned read interface - version 0 is original record, negative versions are counted from final record (-1)
+    int             GetDeviceVersionCount(      PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_invdevice);
+    RE::TESForm*    GetPropertyFormAtVersion(   PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_version, RE::TESForm*   a_defvalue);
+    int             GetPropertyIntAtVersion(    PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_version, int            a_defvalue);
+    float           GetPropertyFloatAtVersion(  PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_version, float          a_defvalue);
+    bool            GetPropertyBoolAtVersion(   PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_version, bool           a_defvalue);
+    std::string     GetPropertyStringAtVersion( PAPYRUSFUNCHANDLE,RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_version, std::string    a_defvalue);
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+namespace DeviousDevices
+{
+    // Caches equip filter verdicts per (actor, item).
+    // Every actor has equipment generation which is increased when its equipment changes, and there is one global generation
+    // for changes affecting all actors (config reload, menus). Find returns ticket with both generations, and Store only keeps
+    // the verdict if no invalidation happened in between, so verdict computed from old state is never stored as new
+    class EquipVerdictCache
+    {
+    public:
+        struct Stats
+        {
+            uint64_t hits   = 0;
+            uint64_t misses = 0;
+        };
+
+        std::optional<bool> Find(uint32_t a_actor, uint32_t a_item, uint64_t& a_ticket)
+        {
+            a_ticket = GetTicket(a_actor);
+            const auto loc_it = _entries.find(GetKey(a_actor,a_item));
+            if (loc_it == _entries.end() || loc_it->second.ticket != a_ticket)
+            {
+                _stats.misses++;
+                return std::nullopt;
+            }
+            _stats.hits++;
+            return loc_it->second.verdict;
+        }
+
+        void Store(uint32_t a_actor, uint32_t a_item, uint64_t a_ticket, bool a_verdict)
+        {
+            if (a_ticket != GetTicket(a_actor)) return;
+
+            //entries of invalidated actors are only overwritten, so whole cache is dropped once it gets too big
+            if (_entries.size() >= MaxEntries) Clear();
+            _entries[GetKey(a_actor,a_item)] = {a_ticket,a_verdict};
+        }
+
+        void InvalidateActor(uint32_t a_actor) { _actorGenerations[a_actor]++; }
+
+        void InvalidateAll()
+        {
+            _generation++;
+            _entries.clear();
+        }
+
+        void Clear()
+        {
+            //generation is kept, so tickets issued before clear can't be used to store entries
+            _generation++;
+            _entries.clear();
+            _actorGenerations.clear();
+        }
+
+        size_t Size() const { return _entries.size(); }
+
+        Stats GetStats(bool a_reset)
+        {
+            const Stats loc_res = _stats;
+            if (a_reset) _stats = Stats();
+            return loc_res;
+        }
+    private:
+        static constexpr size_t MaxEntries = 8192;
+
+        struct Entry
+        {
+            uint64_t    ticket;
+            bool        verdict;
+        };
+
+        static uint64_t GetKey(uint32_t a_actor, uint32_t a_item) { return (static_cast<uint64_t>(a_actor) << 32) | a_item; }
+
+        uint64_t GetTicket(uint32_t a_actor) const
+        {
+            const auto loc_it = _actorGenerations.find(a_actor);
+            return (static_cast<uint64_t>(_generation) << 32) | (loc_it != _actorGenerations.end() ? loc_it->second : 0U);
+        }
+
+        std::unordered_map<uint64_t,Entry>      _entries;
+        std::unordered_map<uint32_t,uint32_t>   _actorGenerations;
+        uint32_t                                _generation = 0;
+        Stats                                   _stats;
+    };
+}
@@ -1,6 +1,9 @@
 #pragma once
 #include <RE/Skyrim.h>
 #include "Utils.h"
+#include "ExpressionVector.h"
+#include "ExpressionLayers.h"
+#include "GagPresetCache.h"
 
 namespace DeviousDevices 
 {
@@ -11,64 +14,116 @@ namespace DeviousDevices
         std::vector<int>                defaults;
     };
 
-    enum BlockCheckMode : uint8_t
-    {
-        mSet    = 0,
-        mReset  = 1
-    };
-
     class ExpressionManager
     {
     SINGLETONHEADER(ExpressionManager)
     public:
         void                Setup();
-        bool                ApplyExpression(RE::Actor* a_actor, const std::vector<float> &a_expression, float a_strength, bool a_openMouth,int a_priority);
-        std::vector<float>  ApplyExpressionRaw(RE::Actor* a_actor, const std::vector<float> &a_expression);
-        std::vector<float>  GetExpression(RE::Actor* a_actor);
-        bool                ResetExpression(RE::Actor* a_actor, int a_priority);
+        // Sets mod layer with given priority. a_weight is how much the layer covers lower priority layers (0 - 1),
+        // negative a_fadeTime means Expression.fFadeTime from config is used. Returns false if higher priority expression
+        // is set. Layer is then only kept if that expression is a layer of this plugin, otherwise it is not applied at all
+        bool                ApplyExpression(RE::Actor* a_actor, const Expression& a_expression, float a_strength, bool a_openMouth,int a_priority, float a_weight = 1.0f, float a_fadeTime = -1.0f);
+        Expression          GetExpression(RE::Actor* a_actor);
+        bool                ResetExpression(RE::Actor* a_actor, int a_priority, float a_fadeTime = -1.0f);
         void                UpdateGagExpression(RE::Actor* a_actor);
-        void                UpdateGagExpressionTimed(RE::Actor* a_actor);
         void                ResetGagExpression(RE::Actor* a_actor);
         bool                RegisterGagType(RE::BGSKeyword* a_keyword, std::vector<RE::TESFaction*> a_factions, std::vector<int> a_defaults);
         bool                RegisterDefaultGagType(std::vector<RE::TESFaction*> a_factions, std::vector<int> a_defaults);
         bool                IsGagged(RE::Actor* a_actor) const;
+
+        // Advances fades of all layer stacks and writes changed channels. Called every frame from player update
+        void                UpdateLayers(float a_delta);
         void                Reload();
-        void                CleanUnusedActors();
-        void                IncUpdateCounter();
+
+        // Forces gag preset of the actor to be resolved again on next update (faction ranks could have changed).
+        // If a_actor is none, presets of all actors are invalidated
+        void                InvalidateGagPreset(RE::Actor* a_actor);
+
+        // Face channel writes. Channel counts mood as single channel, times are in nanoseconds
+        struct WriteStats
+        {
+            uint64_t written        = 0;    //channels written
+            uint64_t skipped        = 0;    //channels which already had the value
+            uint64_t locks          = 0;    //times face lock was taken
+            uint64_t lockTime       = 0;    //total time face lock was held
+            uint64_t maxLockTime    = 0;
+        };
+        WriteStats          GetWriteStats(bool a_reset);
     private:
+        // Gag layer is always on top of expressions set by mods
+        static constexpr int    GagLayerPriority = INT_MAX;
+
         bool                    _installed = false;
         std::vector<GagType>    _GagTypes;
         GagType                 _DefaultGagType;
-        RE::TESFaction*         _BlockFaction;
-        std::unordered_map<RE::Actor*,UpdateHandle> _UpdatedActors;
-        float                   _NPCUpdateTime = 1.0f;
-        uint64_t                _UpdateCounter = 0UL;
-        Spinlock                _SaveLock;
+        RE::TESFaction*         _BlockFaction   = nullptr;
+        float                   _FadeTime       = 0.25f;
+        float                   _GagFadeTime    = 0.25f;
+        std::unordered_map<uint32_t,ExpressionLayerStack>   _LayerStacks;
+        mutable Spinlock                                    _LayerLock;
+        GagTypeIndex            _GagTypeIndex;
+        GagPresetCache          _GagPresetCache;
+        mutable Spinlock        _GagCacheLock;
+
+        struct
+        {
+            std::atomic<uint64_t> written       = 0;
+            std::atomic<uint64_t> skipped       = 0;
+            std::atomic<uint64_t> locks         = 0;
+            std::atomic<uint64_t> lockTime      = 0;
+            std::atomic<uint64_t> maxLockTime   = 0;
+        } _WriteStats;
 
     private:
-        std::vector<float>  GetGagEffectPreset(RE::Actor* a_actor);
-        void                ApplyPhonemsFaction(RE::Actor* a_actor, std::vector<float>& a_exp, std::vector<RE::TESFaction*> a_factions, std::vector<int> a_defaults);
-        std::vector<float>  FactionsToPreset(RE::Actor* a_actor, std::vector<RE::TESFaction*> a_factions, std::vector<int> a_defaults);
-        void                ApplyGagExpression(RE::Actor* a_actor, const std::vector<float> &a_expression);
-        std::vector<float>  ApplyStrengthToExpression(const std::vector<float>& a_expression,float a_strength);
-        bool                CheckExpressionBlock(RE::Actor* a_actor, int a_priority, BlockCheckMode a_mode);
+        bool                GetGagEffectPreset(RE::Actor* a_actor, GagPreset& a_preset);
+        RE::TESObjectARMO*  GetWornGag(RE::Actor* a_actor) const;
+        void                ApplyPhonemsFaction(RE::Actor* a_actor, GagPreset& a_exp, const std::vector<RE::TESFaction*>& a_factions, const std::vector<int>& a_defaults);
+        ExpressionLayerStack& GetLayerStack(RE::Actor* a_actor);
+        int                 GetBlockPriority(RE::Actor* a_actor, const ExpressionLayerStack* a_stack) const;
+        void                SetBlockPriority(RE::Actor* a_actor, int a_priority) const;
+        void                ComposeAndWrite(RE::Actor* a_actor, ExpressionLayerStack& a_stack, float a_delta);
+        void                WriteComposed(RE::Actor* a_actor, const ComposedExpression& a_expression, uint32_t a_mask);
+        static bool         ReadFace(RE::BSFaceGenAnimationData* a_expdata, Expression& a_result);
     };
 
 
     inline bool ApplyExpression(PAPYRUSFUNCHANDLE, RE::Actor* a_actor, std::vector<float> a_expression,int a_strength, bool a_openMouth,int a_priority)
     {
-        return ExpressionManager::GetSingleton()->ApplyExpression(a_actor, a_expression,a_strength/100.0f,a_openMouth,a_priority);
+        Expression loc_expression;
+        if (!Expression::FromVector(a_expression,loc_expression))
+        {
+            ERROR("ApplyExpression - Expression size have to be 32!")
+            return false;
+        }
+        return ExpressionManager::GetSingleton()->ApplyExpression(a_actor, loc_expression,a_strength/100.0f,a_openMouth,a_priority);
+    }
+    inline bool ApplyExpressionLayer(PAPYRUSFUNCHANDLE, RE::Actor* a_actor, std::vector<float> a_expression,int a_strength, bool a_openMouth,int a_priority, float a_weight, float a_fadeTime)
+    {
+        Expression loc_expression;
+        if (!Expression::FromVector(a_expression,loc_expression))
+        {
+            ERROR("ApplyExpressionLayer - Expression size have to be 32!")
+            return false;
+        }
+        return ExpressionManager::GetSingleton()->ApplyExpression(a_actor, loc_expression,a_strength/100.0f,a_openMouth,a_priority,a_weight,a_fadeTime);
     }
     inline std::vector<float> GetExpression(PAPYRUSFUNCHANDLE, RE::Actor* a_actor)
     {
-        return ExpressionManager::GetSingleton()->GetExpression(a_actor);
+        return ExpressionManager::GetSingleton()->GetExpression(a_actor).ToVector();
     }
     inline void ResetExpression(PAPYRUSFUNCHANDLE, RE::Actor* a_actor, int a_priority)
     {
         ExpressionManager::GetSingleton()->ResetExpression(a_actor,a_priority);
     }
+    inline bool ResetExpressionLayer(PAPYRUSFUNCHANDLE, RE::Actor* a_actor, int a_priority, float a_fadeTime)
+    {
+        return ExpressionManager::GetSingleton()->ResetExpression(a_actor,a_priority,a_fadeTime);
+    }
     inline void UpdateGagExpression(PAPYRUSFUNCHANDLE, RE::Actor* a_actor)
     {
+        //script update is usually done after gag state changed, so cached preset can't be used
+        if (a_actor == nullptr) return;
+        ExpressionManager::GetSingleton()->InvalidateGagPreset(a_actor);
         ExpressionManager::GetSingleton()->UpdateGagExpression(a_actor);
     }
     inline bool RegisterGagType(PAPYRUSFUNCHANDLE, RE::BGSKeyword* a_keyword, std::vector<RE::TESFaction*> a_factions, std::vector<int> a_defaults)
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "ExpressionVector.h"
+
+namespace DeviousDevices
+{
+    enum ExpressionLayerType : uint8_t
+    {
+        lMod    = 0,    //expressions applied by mods (ApplyExpression)
+        lGag    = 1     //gag phonemes, always on top of mod layers
+    };
+
+    // Channel masks. Bit i = channel i of Expression
+    constexpr uint32_t ExpressionPhonemeMask    = 0x0000FFFFU;
+    constexpr uint32_t ExpressionModifierMask   = 0x3FFF0000U;
+    constexpr uint32_t ExpressionMoodMask       = 0xC0000000U;
+    constexpr uint32_t ExpressionAllMask        = 0xFFFFFFFFU;
+
+    // Changes smaller than this are not written to the face
+    constexpr float ExpressionWriteEpsilon = 0.001f;
+
+    struct ComposedExpression
+    {
+        Expression  values;
+        bool        mood        = false;    //true if some layer sets expression override (channels 30 and 31)
+    };
+
+    // Returns channels from a_mask whose value in a_target differs from a_current by more than a_epsilon.
+    // Both mood channels are returned if expression id differs, or if strength differs by more than a_epsilon
+    uint32_t GetChangedChannels(const Expression& a_current, const Expression& a_target, uint32_t a_mask, float a_epsilon = ExpressionWriteEpsilon);
+
+    // Per actor stack of expression layers.
+    // Layers are identified by type and priority. Higher priority layers are blended over lower ones using their weight,
+    // and every layer fades in/out and interpolates between old and new values over its fade time
+    class ExpressionLayerStack
+    {
+    public:
+        // Sets values shown under all layers, usually the face of the actor at the time the stack was created.
+        // Layers fade in from them, and the face returns to them once all layers are removed
+        void SetBase(const ComposedExpression& a_base);
+
+        // Adds new layer or changes existing one. Changing existing layer interpolates from its current values
+        void SetLayer(ExpressionLayerType a_type, int a_priority, const Expression& a_values, uint32_t a_mask, float a_weight, float a_fadeTime);
+
+        // Fades out all layers of type with priority lower or equal to a_maxPriority. Returns number of removed layers
+        size_t RemoveLayers(ExpressionLayerType a_type, int a_maxPriority, float a_fadeTime);
+
+        // Returns highest priority of not removed layer of type, or INT_MIN if there is none
+        int GetTopPriority(ExpressionLayerType a_type) const;
+
+        // Advances fades and blends layers. Returns mask of channels which have to be written to the actor
+        uint32_t Compose(float a_delta, ComposedExpression& a_result);
+
+        // True if there are no layers left. Stack can be released once result of last Compose is written
+        bool IsEmpty() const { return _layers.empty(); }
+
+        // True if no layer is fading and nothing changed since last Compose, so Compose would return 0
+        bool IsSettled() const { return !_dirty && _forceMask == 0; }
+
+        const ComposedExpression& GetLastComposed() const { return _last; }
+    private:
+        struct Layer
+        {
+            ExpressionLayerType type;
+            int                 priority;
+            uint32_t            mask;
+            float               weight;
+            float               fadeSpeed;          //per second, 0 = instant
+            float               fade        = 0.0f; //0 - 1
+            float               progress    = 1.0f; //interpolation from -> target, 0 - 1
+            bool                removing    = false;
+            Expression          from;
+            Expression          target;
+
+            Expression GetValues() const;
+        };
+
+        static float GetSpeed(float a_fadeTime);
+
+        std::vector<Layer>  _layers;            //sorted by priority, then by type
+        ComposedExpression  _base;
+        ComposedExpression  _last;
+        bool                _dirty      = true; //some layer is changing
+        uint32_t            _forceMask  = 0;    //channels which have to be written even if their value did not change
+    };
+}
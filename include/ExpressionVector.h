@@ -0,0 +1,83 @@
+#pragma once
+
+#include <immintrin.h>
+
+namespace DeviousDevices
+{
+    // Fixed layout expression, same as the one used by papyrus
+    // 0-15 = phonemes, 16-29 = modifiers, 30 = expression id, 31 = expression strength
+    struct alignas(32) Expression
+    {
+        static constexpr size_t Size            = 32;
+        static constexpr size_t PhonemeCount    = 16;
+        static constexpr size_t ModifierCount   = 14;
+        static constexpr size_t ModifierOffset  = 16;
+        static constexpr size_t ExpressionID    = 30;
+        static constexpr size_t ExpressionStr   = 31;
+
+        std::array<float,Size> values = {};
+
+        float& operator[](size_t a_index) { return values[a_index]; }
+        const float& operator[](size_t a_index) const { return values[a_index]; }
+
+        bool operator==(const Expression& a_other) const
+        {
+            int loc_mask = 0xF;
+            for (size_t i = 0; i < Size; i += 4)
+            {
+                loc_mask &= _mm_movemask_ps(_mm_cmpeq_ps(_mm_load_ps(&values[i]),_mm_load_ps(&a_other.values[i])));
+            }
+            return loc_mask == 0xF;
+        }
+        bool operator!=(const Expression& a_other) const { return !(*this == a_other); }
+
+        // Multiplies all values except expression id by a_strength (clamped to 0-1)
+        void ApplyStrength(float a_strength)
+        {
+            const float loc_mult = std::clamp(a_strength,0.0f,1.0f);
+            const __m128 loc_vmult = _mm_set1_ps(loc_mult);
+            for (size_t i = 0; i < 28; i += 4)
+            {
+                _mm_store_ps(&values[i],_mm_mul_ps(_mm_load_ps(&values[i]),loc_vmult));
+            }
+            //last block contains expression id in lane 2, which have to stay unchanged
+            const __m128 loc_vlast = _mm_set_ps(loc_mult,1.0f,loc_mult,loc_mult);
+            _mm_store_ps(&values[28],_mm_mul_ps(_mm_load_ps(&values[28]),loc_vlast));
+        }
+
+        // Returns false if vector have incorrect size
+        static bool FromVector(const std::vector<float>& a_vector, Expression& a_result)
+        {
+            if (a_vector.size() != Size) return false;
+            std::copy(a_vector.begin(),a_vector.end(),a_result.values.begin());
+            return true;
+        }
+
+        std::vector<float> ToVector() const
+        {
+            return std::vector<float>(values.begin(),values.end());
+        }
+    };
+
+    // Gag phonemes
+    struct alignas(32) GagPreset
+    {
+        static constexpr size_t Size = 16;
+
+        std::array<float,Size> values = {};
+
+        float& operator[](size_t a_index) { return values[a_index]; }
+        const float& operator[](size_t a_index) const { return values[a_index]; }
+
+        bool operator==(const GagPreset& a_other) const
+        {
+            int loc_mask = 0xF;
+            for (size_t i = 0; i < Size; i += 4)
+            {
+                loc_mask &= _mm_movemask_ps(_mm_cmpeq_ps(_mm_load_ps(&values[i]),_mm_load_ps(&a_other.values[i])));
+            }
+            return loc_mask == 0xF;
+        }
+        bool operator!=(const GagPreset& a_other) const { return !(*this == a_other); }
+    };
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ExpressionVector.h"
+
+namespace DeviousDevices
+{
+    // Maps gag type keywords to index of gag type in order of registration
+    class GagTypeIndex
+    {
+    public:
+        static constexpr size_t npos = SIZE_MAX;
+
+        // Keyword which is already present keeps its original index
+        void Add(const RE::BGSKeyword* a_keyword, size_t a_index)
+        {
+            _index.try_emplace(a_keyword,a_index);
+        }
+
+        // Returns index of first registered gag type whose keyword is in passed keywords, or npos if there is none
+        size_t Find(const RE::BGSKeyword* const* a_keywords, size_t a_count) const
+        {
+            size_t loc_res = npos;
+            for (size_t i = 0; i < a_count; i++)
+            {
+                const auto loc_it = _index.find(a_keywords[i]);
+                if (loc_it != _index.end()) loc_res = std::min(loc_res,loc_it->second);
+            }
+            return loc_res;
+        }
+
+        void Clear() { _index.clear(); }
+        size_t Size() const { return _index.size(); }
+    private:
+        std::unordered_map<const RE::BGSKeyword*,size_t> _index;
+    };
+
+    // Resolved gag phonemes per actor. Entry is valid as long as actor wears the same gag, and no invalidation happened since it was stored.
+    // Invalidating all entries only increments generation, so it is O(1). Outdated entry is erased once it is found,
+    // and entry of actor which is no longer gagged should be erased with Invalidate
+    class GagPresetCache
+    {
+    public:
+        // Returns cached preset, or nullptr if there is none for the gag or it is outdated. Outdated entry is erased
+        const GagPreset* Find(uint32_t a_handle, uint32_t a_gag)
+        {
+            const auto loc_it = _entries.find(a_handle);
+            if (loc_it == _entries.end()) return nullptr;
+            const Entry& loc_entry = loc_it->second;
+            if (loc_entry.gag != a_gag || loc_entry.generation != _generation)
+            {
+                _entries.erase(loc_it);
+                return nullptr;
+            }
+            return &loc_entry.preset;
+        }
+
+        void Store(uint32_t a_handle, uint32_t a_gag, const GagPreset& a_preset)
+        {
+            _entries[a_handle] = {a_gag,_generation,a_preset};
+        }
+
+        void Invalidate(uint32_t a_handle) { _entries.erase(a_handle); }
+        void InvalidateAll() { _generation++; }
+        void Clear() { _entries.clear(); }
+        size_t Size() const { return _entries.size(); }
+    private:
+        struct Entry
+        {
+            uint32_t    gag;
+            uint32_t    generation;
+            GagPreset   preset;
+        };
+
+        std::unordered_map<uint32_t,Entry>  _entries;
+        uint32_t                            _generation = 0;
+    };
+}
@@ -165,6 +165,9 @@ namespace DeviousDevices {
 
             // need to check for quest item 
 
+            // unequip event is sent later, and outfit can be equipped before that
+            InventoryFilter::GetSingleton()->InvalidateEquipVerdicts(actor);
+
             return _UnequipObject(a_1, actor, item, a_extraData, a_count, a_slot, a_queueEquip, a_forceEquip,
                                   a_playSounds, a_applyNow, a_slotToReplace);
         }
@@ -175,6 +178,7 @@ namespace DeviousDevices {
         inline void EquipObject2(RE::ActorEquipManager* a_1,RE::Actor* a_actor, RE::TESBoundObject* a_item,
                                   std::uint64_t a_extradata, std::uint64_t a_unkw)
         {
+            DD_PROFILE_SCOPE(pEquipObject2)
             //DEBUG("EquipBipedObject({},{}) called",a_actor->GetName(),a_item->GetName())
 
             // Apply inventory filter
@@ -195,11 +199,11 @@ namespace DeviousDevices {
             AddObjectToContainerHook::Install();
             PickUpObjectHook::Install();
           
-            if (!ConfigManager::GetSingleton()->GetVariable<bool>("InventoryFilter.bEquipSpell", true))
+            if (!ConfigManager::GetSingleton()->GetConfig().InventoryFilter_bEquipSpell)
             {
                 EquipSpellHook::Install();
             }
-            if (!ConfigManager::GetSingleton()->GetVariable<bool>("InventoryFilter.bEquipShout", true))
+            if (!ConfigManager::GetSingleton()->GetConfig().InventoryFilter_bEquipShout)
             {
                 EquipShoutHook::Install();
             }
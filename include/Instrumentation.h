@@ -0,0 +1,230 @@
+#pragma once
+
+namespace DeviousDevices
+{
+    enum ProfileZone : uint8_t
+    {
+        pInitWornArmor          = 0,
+        pEquipObject2           = 1,
+        pEquipFilter            = 2,
+        pUpdatePlayer           = 3,
+        pUpdateCharacter        = 4,
+        pUpdateGagExpression    = 5,
+        pNodeHiderUpdate        = 6,
+        pDeviceReader           = 7,
+        pZoneCount
+    };
+    static_assert(pZoneCount <= 32,"Open zones are stored as bit mask");
+
+    // Log-linear latency histogram. Values below 16 ns have own bucket, higher values are split to 8 buckets per power of 2,
+    // so reported percentiles are within 12.5 % of real value
+    class LatencyHistogram
+    {
+    public:
+        static constexpr size_t Buckets = 16 + 60*8;
+
+        static size_t GetBucket(uint64_t a_value)
+        {
+            if (a_value < 16) return static_cast<size_t>(a_value);
+            const uint32_t loc_exp = static_cast<uint32_t>(std::bit_width(a_value)) - 1;
+            return 16 + (loc_exp - 4)*8 + ((a_value >> (loc_exp - 3)) & 7);
+        }
+
+        // Smallest value which falls to bucket
+        static uint64_t GetBucketValue(size_t a_bucket)
+        {
+            if (a_bucket < 16) return a_bucket;
+            const uint64_t loc_exp = (a_bucket - 16)/8 + 4;
+            return (8 + (a_bucket - 16)%8) << (loc_exp - 3);
+        }
+
+        void Add(uint64_t a_value, uint64_t a_count = 1) { _counts[GetBucket(a_value)] += a_count; _total += a_count; }
+        uint64_t GetCount() const { return _total; }
+
+        // Value for percentile (0-100). Middle of bucket is returned
+        uint64_t GetPercentile(double a_percentile) const;
+
+        std::array<uint64_t,Buckets>    _counts = {};
+        uint64_t                        _total  = 0;
+    };
+
+    struct ZoneStats
+    {
+        const char* name    = "";
+        uint64_t    calls   = 0;
+        double      rate    = 0.0;  //calls per second
+        uint64_t    p50     = 0;    //ns
+        uint64_t    p95     = 0;
+        uint64_t    p99     = 0;
+        uint64_t    max     = 0;
+    };
+
+    // Single producer ring buffer of completed spans. Only owning thread writes, any thread can read.
+    // Oldest events are overwritten when buffer is full. Reader drops events which were overwritten while it was copying them
+    class TraceBuffer
+    {
+    public:
+        struct Event
+        {
+            const char* name        = nullptr;  //has to be string literal, as only pointer is stored
+            uint64_t    start       = 0;        //ns
+            uint64_t    duration    = 0;        //ns
+        };
+
+        TraceBuffer(size_t a_capacity, uint32_t a_thread) : _slots(std::max<size_t>(a_capacity,1)), _thread(a_thread) {}
+
+        // Called only by owning thread
+        void Add(const char* a_name, uint64_t a_start, uint64_t a_duration);
+
+        // Returns events still in buffer, oldest first
+        std::vector<Event> Read() const;
+
+        size_t   GetCapacity() const { return _slots.size(); }
+        uint32_t GetThread() const { return _thread; }
+    private:
+        struct Slot
+        {
+            std::atomic<const char*>    name        = nullptr;
+            std::atomic<uint64_t>       start       = 0;
+            std::atomic<uint64_t>       duration    = 0;
+        };
+        std::vector<Slot>       _slots;
+        uint32_t                _thread;
+        std::atomic<uint64_t>   _reserved   = 0;    //incremented before slot is written
+        std::atomic<uint64_t>   _written    = 0;    //incremented after slot is written
+    };
+
+    // Per thread counters and latency histograms of hot paths.
+    // Every thread only writes its own data, so recording needs no locks or atomic read-modify-write.
+    // Stats are computed from difference to previous collection, so counters are never reset
+    class Instrumentation
+    {
+    public:
+        static bool IsEnabled() { return _enabled.load(std::memory_order_relaxed); }
+        static void SetEnabled(bool a_enabled) { _enabled.store(a_enabled,std::memory_order_relaxed); }
+
+        static void Record(ProfileZone a_zone, uint64_t a_ns);
+
+        // Returns stats of all zones since last call
+        static std::array<ZoneStats,pZoneCount> Collect();
+
+        static const char* GetZoneName(ProfileZone a_zone);
+
+        // Marks zone as open on calling thread. Returns false if it is already open, so nested scope of the same zone
+        // (scoped function calling other scoped function) is not recorded second time
+        static bool OpenZone(ProfileZone a_zone)
+        {
+            const uint32_t loc_bit = 1U << a_zone;
+            if (_openZones & loc_bit) return false;
+            _openZones |= loc_bit;
+            return true;
+        }
+        static void CloseZone(ProfileZone a_zone) { _openZones &= ~(1U << a_zone); }
+
+        // Reads Main.bProfiling, Main.bTracing and Main.iTraceBufferSize, and applies them again on config reload
+        static void Setup();
+
+        static bool IsTracing() { return _tracing.load(std::memory_order_relaxed); }
+        static void SetTracing(bool a_enabled, size_t a_bufferSize);
+
+        static void Trace(const char* a_name, std::chrono::steady_clock::time_point a_start, std::chrono::steady_clock::time_point a_end);
+
+        // Writes Chrome trace event JSON (chrome://tracing, ui.perfetto.dev). Returns number of written events, or -1 if file can't be opened
+        static int64_t ExportTrace(const std::filesystem::path& a_path);
+        static void ExportTrace(std::ostream& a_stream, size_t* a_count = nullptr);
+    private:
+        struct ZoneData
+        {
+            std::array<std::atomic<uint64_t>,LatencyHistogram::Buckets> buckets = {};
+            std::atomic<uint64_t>                                       max     = 0;
+        };
+        struct ThreadData
+        {
+            std::array<ZoneData,pZoneCount> zones;
+            std::unique_ptr<TraceBuffer>    trace;  //created on first span after tracing is enabled. Set under _threadsLock
+            uint32_t                        index = 0;
+        };
+
+        static ThreadData& GetThreadData();
+
+        inline static std::atomic<bool>                 _enabled = false;
+        inline static std::atomic<bool>                 _tracing = false;
+        inline static std::atomic<size_t>               _traceBufferSize = 16384;
+        inline static thread_local uint32_t             _openZones = 0;
+        static Spinlock                                 _threadsLock;
+        // Data of ended threads is never freed (~31 KB per thread), as thread can end while its data is collected, and
+        // its counts are still part of totals. Zones are only entered from game and Papyrus threads, which live for the
+        // whole session, so this is bounded by number of game threads
+        static std::vector<std::unique_ptr<ThreadData>> _threads;
+        static std::array<LatencyHistogram,pZoneCount>  _previous;      //totals at last collection
+        static std::chrono::steady_clock::time_point    _previousTime;
+    };
+
+    // Records time from construction to destruction, if instrumentation is enabled.
+    // Only outermost scope of zone is recorded, nested scopes of the same zone are ignored
+    class ProfileScope
+    {
+    public:
+        explicit ProfileScope(ProfileZone a_zone) : _zone(a_zone), _active(DD_PROFILING_S == 1U && Instrumentation::IsEnabled()), _tracing(DD_TRACING_S == 1U && Instrumentation::IsTracing())
+        {
+            if (!_active && !_tracing) return;
+            if (!Instrumentation::OpenZone(a_zone))
+            {
+                _active  = false;
+                _tracing = false;
+                return;
+            }
+            _start = std::chrono::steady_clock::now();
+        }
+        ~ProfileScope()
+        {
+            if (!_active && !_tracing) return;
+            const auto loc_end = std::chrono::steady_clock::now();
+            if (_active) Instrumentation::Record(_zone,std::chrono::duration_cast<std::chrono::nanoseconds>(loc_end - _start).count());
+            if (_tracing) Instrumentation::Trace(Instrumentation::GetZoneName(_zone),_start,loc_end);
+            Instrumentation::CloseZone(_zone);
+        }
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+    private:
+        ProfileZone                             _zone;
+        bool                                    _active;
+        bool                                    _tracing;
+        std::chrono::steady_clock::time_point   _start;
+    };
+
+    // Records span from construction to destruction, if tracing is enabled. Name has to be string literal
+    class TraceScope
+    {
+    public:
+        explicit TraceScope(const char* a_name) : _name(a_name), _active(Instrumentation::IsTracing())
+        {
+            if (_active) _start = std::chrono::steady_clock::now();
+        }
+        ~TraceScope()
+        {
+            if (_active) Instrumentation::Trace(_name,_start,std::chrono::steady_clock::now());
+        }
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+    private:
+        const char*                             _name;
+        bool                                    _active;
+        std::chrono::steady_clock::time_point   _start;
+    };
+}
+
+#define DD_PROFILE_CONCAT2(a,b) a##b
+#define DD_PROFILE_CONCAT(a,b) DD_PROFILE_CONCAT2(a,b)
+
+#if (DD_PROFILING_S == 1U || DD_TRACING_S == 1U)
+    #define DD_PROFILE_SCOPE(zone) DeviousDevices::ProfileScope DD_PROFILE_CONCAT(loc_profile,__LINE__)(zone);
+#else
+    #define DD_PROFILE_SCOPE(zone)
+#endif
+
+#if (DD_TRACING_S == 1U)
+    #define DD_TRACE_SCOPE(name) DeviousDevices::TraceScope DD_PROFILE_CONCAT(loc_trace,__LINE__)(name);
+#else
+    #define DD_TRACE_SCOPE(name)
+#endif
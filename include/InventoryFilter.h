@@ -2,25 +2,69 @@
 
 #include <RE/Skyrim.h>
 #include <REL/Relocation.h>
+#include "WhitelistMatcher.h"
+#include "EquipVerdictCache.h"
+#include "KeywordSlotTable.h"
 
 namespace DeviousDevices 
 {
-    class InventoryFilter 
+    class InventoryFilter : public RE::BSTEventSink<RE::TESEquipEvent>, public RE::BSTEventSink<RE::MenuOpenCloseEvent>
     {
     SINGLETONHEADER(InventoryFilter)
     public:
         void Setup();
         bool TakeFilter(RE::Actor* a_actor, RE::TESBoundObject* obj);
         bool EquipFilter(RE::Actor* a_actor, RE::TESBoundObject* a_item); // return true if equip operation should be filtered out (no item state will be changed)
+        void InvalidateEquipVerdicts(RE::Actor* a_actor);   // nullptr = all actors
+        EquipVerdictCache::Stats GetEquipVerdictStats(bool a_reset);
+
+        RE::BSEventNotifyControl ProcessEvent(const RE::TESEquipEvent* a_event, RE::BSTEventSource<RE::TESEquipEvent>* a_source) override;
+        RE::BSEventNotifyControl ProcessEvent(const RE::MenuOpenCloseEvent* a_event, RE::BSTEventSource<RE::MenuOpenCloseEvent>* a_source) override;
     private:
+        bool ComputeEquipFilter(RE::Actor* a_actor, RE::TESBoundObject* a_item, bool& a_cacheable);
         bool IsStrapon(RE::TESBoundObject* obj);
         int  GetMaskForKeyword(RE::Actor* a_actor, RE::BGSKeyword* kwd);
         bool CheckWhitelist(const RE::TESBoundObject* a_item) const;
         bool CheckWhitelistFood(const RE::TESBoundObject* a_item) const;
+        uint8_t GetWhitelistMatch(const RE::TESBoundObject* a_item, uint8_t a_list) const;
+        void BuildWhitelist(const ConfigSnapshot& a_config);
+        void BuildKeywordSlots(const ConfigSnapshot& a_config);
         RE::TESObjectARMO* GetWornWithDeviousKeyword(RE::Actor* actor, RE::BGSKeyword* kwd);
 
      private:
+        enum WhitelistList : uint8_t
+        {
+            wGeneral    = 0x01,
+            wFood       = 0x02
+        };
+
+        // Both whitelists compiled to one matcher, with match results memoized per form.
+        // Rebuilt when config is reloaded
+        struct Whitelist
+        {
+            WhitelistMatcher                                matcher;
+            mutable Spinlock                                lock;
+            mutable std::unordered_map<RE::FormID,uint8_t>  cache;
+        };
+
         bool _init = false;
+        SnapshotPublisher<Whitelist> _whitelist;
+        SnapshotPublisher<KeywordSlotTable> _keywordSlots;
+
+        // NPC verdicts only. Player verdicts depend on open menus and show notifications, so they are always computed
+        EquipVerdictCache   _verdictCache;
+        Spinlock            _verdictLock;
+
+        // take filter state, shared by all items taken in one batch
+        struct TakeState
+        {
+            bool enabled            = false;
+            bool notifiedFailure    = false;
+            bool notifiedSuccess    = false;
+        };
+        CallBatch           _takeBatch = CallBatch(std::chrono::milliseconds(100));
+        TakeState           _takeState;
+        Spinlock            _takeLock;
 
         // misc
         RE::FormID _deviceHiderId;
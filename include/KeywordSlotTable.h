@@ -0,0 +1,105 @@
+#pragma once
+
+namespace DeviousDevices
+{
+    // Maps device keyword to biped slot in which device with this keyword is worn.
+    // Open addressing table keyed by keyword address, built once and then only read
+    class KeywordSlotTable
+    {
+    public:
+        // Used when config doesn't contain any mapping. Format of entry is "EditorID:slot"
+        static constexpr std::array<std::string_view,19> DefaultEntries =
+        {
+            "zad_DeviousArmCuffs:59",       "zad_DeviousGag:44",            "zad_DeviousHarness:58",
+            "zad_DeviousCorset:58",         "zad_DeviousCollar:45",         "zad_DeviousHeavyBondage:46",
+            "zad_DeviousPlugAnal:48",       "zad_DeviousBelt:49",           "zad_DeviousPiercingsVaginal:50",
+            "zad_DeviousPiercingsNipple:51","zad_DeviousLegCuffs:53",       "zad_DeviousBlindfold:55",
+            "zad_DeviousBra:56",            "zad_DeviousPlugVaginal:57",    "zad_DeviousSuit:32",
+            "zad_DeviousGloves:33",         "zad_DeviousHood:30",           "zad_DeviousBoots:37",
+            "zad_DeviousBondageMittens:33"
+        };
+
+        // Parses "EditorID:slot" entry. Returns false if entry is not valid or slot is not in range 30-60
+        static bool ParseEntry(std::string_view a_entry, std::string& a_editorID, uint32_t& a_slot)
+        {
+            const size_t loc_sep = a_entry.rfind(':');
+            if (loc_sep == std::string_view::npos) return false;
+
+            auto loc_trim = [](std::string_view a_text)
+            {
+                const size_t loc_first = a_text.find_first_not_of(' ');
+                if (loc_first == std::string_view::npos) return std::string_view();
+                return a_text.substr(loc_first,a_text.find_last_not_of(' ') - loc_first + 1);
+            };
+
+            const std::string_view loc_id   = loc_trim(a_entry.substr(0,loc_sep));
+            const std::string_view loc_slot = loc_trim(a_entry.substr(loc_sep + 1));
+            uint32_t loc_value = 0;
+            const auto loc_res = std::from_chars(loc_slot.data(),loc_slot.data() + loc_slot.size(),loc_value);
+            if (loc_id.empty() || loc_slot.empty() || loc_res.ec != std::errc() || loc_res.ptr != loc_slot.data() + loc_slot.size()) return false;
+            if (loc_value < 30 || loc_value > 60) return false;   //mask of slot 61 is negative, which is used as "not found"
+
+            a_editorID = loc_id;
+            a_slot = loc_value;
+            return true;
+        }
+
+        // Adds mapping. First mapping of keyword is kept. Returns false if keyword was already mapped or is nullptr
+        bool Add(const RE::BGSKeyword* a_keyword, uint32_t a_slot)
+        {
+            if (a_keyword == nullptr || Find(a_keyword) >= 0) return false;
+            if ((_size + 1)*2 > _entries.size()) Rehash(std::max<size_t>(16,_entries.size()*2));
+            Insert(a_keyword,a_slot);
+            return true;
+        }
+
+        // Returns slot of keyword, or -1 if keyword is not mapped
+        int Find(const RE::BGSKeyword* a_keyword) const
+        {
+            if (_size == 0 || a_keyword == nullptr) return -1;
+            const size_t loc_mask = _entries.size() - 1;
+            for (size_t i = Hash(a_keyword) & loc_mask;; i = (i + 1) & loc_mask)
+            {
+                if (_entries[i].keyword == a_keyword) return static_cast<int>(_entries[i].slot);
+                if (_entries[i].keyword == nullptr) return -1;
+            }
+        }
+
+        size_t Size() const { return _size; }
+    private:
+        struct Entry
+        {
+            const RE::BGSKeyword*   keyword = nullptr;
+            uint32_t                slot    = 0;
+        };
+
+        static size_t Hash(const RE::BGSKeyword* a_keyword)
+        {
+            //forms are aligned, so low bits carry no information
+            return static_cast<size_t>((reinterpret_cast<uintptr_t>(a_keyword)*0x9E3779B97F4A7C15ULL) >> 40);
+        }
+
+        void Insert(const RE::BGSKeyword* a_keyword, uint32_t a_slot)
+        {
+            const size_t loc_mask = _entries.size() - 1;
+            size_t i = Hash(a_keyword) & loc_mask;
+            while (_entries[i].keyword != nullptr) i = (i + 1) & loc_mask;
+            _entries[i] = {a_keyword,a_slot};
+            _size++;
+        }
+
+        void Rehash(size_t a_capacity)
+        {
+            std::vector<Entry> loc_old = std::move(_entries);
+            _entries.assign(a_capacity,Entry());
+            _size = 0;
+            for (auto&& it : loc_old)
+            {
+                if (it.keyword != nullptr) Insert(it.keyword,it.slot);
+            }
+        }
+
+        std::vector<Entry>  _entries;
+        size_t              _size = 0;
+    };
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+namespace DeviousDevices
+{
+    // Owns loggers of the plugin. Both loggers write to the same sink.
+    // Async logger formats messages on caller thread and writes them on background thread, so callers never wait for disk.
+    // It is used by default for all levels. Warnings and errors queue flush, so they are written soon without blocking caller.
+    // Synchronous logger flushes every message, so nothing is lost on crash. It is opt-in (Main.bSyncLogging), as it
+    // makes every logged line wait for disk
+    class Logging
+    {
+    public:
+        static void Setup(spdlog::sink_ptr a_sink);
+
+        // Switches default logger. Loggers are never destroyed before Shutdown, but default logger is not
+        // synchronized, so this should only be called before other threads start to log (from plugin load)
+        static void SetAsync(bool a_async);
+        static bool IsAsync() { return _async.load(std::memory_order_relaxed); }
+
+        // Writes queued messages and stops background thread, so it is not left to DLL detach with messages in queue.
+        // Messages logged after this are written directly. Called at exit, when the thread could be already stopped
+        // by the process - in that case it is not joined
+        static void Shutdown();
+    private:
+        static constexpr size_t     QueueSize       = 8192;
+        static constexpr int64_t    ShutdownTimeout = 500;  //ms
+
+        inline static std::shared_ptr<spdlog::logger>                 _sync;
+        inline static std::shared_ptr<spdlog::logger>                 _asyncLogger;
+        inline static std::shared_ptr<spdlog::details::thread_pool>   _pool;
+        inline static std::atomic<bool>                               _async = false;
+    };
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+namespace DeviousDevices
+{
+    // Name lookup of devices. Every device can be added under multiple names (display name, editor ID).
+    // Exact lookups use hash maps. Prefix and substring searches use suffix array of lower case names, so both are binary
+    // searches plus number of matches, instead of comparing every name. Index is built once and is read only afterwards
+    template <typename T>
+    class NameIndex
+    {
+    public:
+        // Empty names are ignored. If the same name is added multiple times, exact lookups return first value
+        void Add(std::string_view a_name, T a_value)
+        {
+            if (a_name.empty()) return;
+            std::string loc_lower = ToLower(a_name);
+            _exact.try_emplace(std::string(a_name),a_value);
+            _noCase.try_emplace(loc_lower,a_value);
+            _entries.push_back({std::move(loc_lower),a_value});
+        }
+
+        // Sorts suffixes of all added names. Searches only see names added before last Build
+        void Build()
+        {
+            _suffixes.clear();
+            for (uint32_t e = 0; e < _entries.size(); e++)
+            {
+                for (uint32_t o = 0; o < _entries[e].name.size(); o++) _suffixes.push_back({e,o});
+            }
+            std::sort(_suffixes.begin(),_suffixes.end(),[this](const Suffix& a_1, const Suffix& a_2){ return GetSuffix(a_1) < GetSuffix(a_2); });
+        }
+
+        void Clear()
+        {
+            _exact.clear();
+            _noCase.clear();
+            _entries.clear();
+            _suffixes.clear();
+        }
+
+        size_t GetNameCount() const { return _entries.size(); }
+
+        std::optional<T> FindExact(std::string_view a_name) const
+        {
+            const auto loc_it = _exact.find(a_name);
+            return (loc_it != _exact.end()) ? std::optional<T>(loc_it->second) : std::nullopt;
+        }
+
+        std::optional<T> FindNoCase(std::string_view a_name) const
+        {
+            const auto loc_it = _noCase.find(ToLower(a_name));
+            return (loc_it != _noCase.end()) ? std::optional<T>(loc_it->second) : std::nullopt;
+        }
+
+        // Case insensitive searches. Values are returned only once, in order in which their names were added.
+        // a_max = 0 means no limit
+        std::vector<T> FindPrefix(std::string_view a_text, size_t a_max = 0) const     { return Find(a_text,a_max,true); }
+        std::vector<T> FindSubstring(std::string_view a_text, size_t a_max = 0) const  { return Find(a_text,a_max,false); }
+    private:
+        struct Entry
+        {
+            std::string name;   //lower case
+            T           value;
+        };
+
+        struct Suffix
+        {
+            uint32_t entry;
+            uint32_t offset;
+        };
+
+        struct StringHash
+        {
+            using is_transparent = void;
+            size_t operator()(std::string_view a_string) const { return std::hash<std::string_view>()(a_string); }
+        };
+
+        //names are ASCII, so locale aware tolower is not needed
+        static std::string ToLower(std::string_view a_string)
+        {
+            std::string loc_res(a_string);
+            for (auto&& it : loc_res) if (it >= 'A' && it <= 'Z') it = static_cast<char>(it + ('a' - 'A'));
+            return loc_res;
+        }
+
+        std::string_view GetSuffix(const Suffix& a_suffix) const
+        {
+            return std::string_view(_entries[a_suffix.entry].name).substr(a_suffix.offset);
+        }
+
+        std::vector<T> Find(std::string_view a_text, size_t a_max, bool a_prefix) const
+        {
+            const std::string loc_text = ToLower(a_text);
+
+            std::vector<uint32_t> loc_matches;
+            if (loc_text.empty())
+            {
+                loc_matches.resize(_entries.size());
+                std::iota(loc_matches.begin(),loc_matches.end(),0U);
+            }
+            else
+            {
+                //suffixes starting with text are one continuous range of suffix array
+                const auto loc_begin = std::lower_bound(_suffixes.begin(),_suffixes.end(),std::string_view(loc_text),
+                    [this](const Suffix& a_suffix, std::string_view a_value){ return GetSuffix(a_suffix) < a_value; });
+                const auto loc_end = std::partition_point(loc_begin,_suffixes.end(),
+                    [&](const Suffix& a_suffix){ return GetSuffix(a_suffix).substr(0,loc_text.size()) == loc_text; });
+
+                for (auto it = loc_begin; it != loc_end; it++)
+                {
+                    if (!a_prefix || it->offset == 0) loc_matches.push_back(it->entry);
+                }
+                std::sort(loc_matches.begin(),loc_matches.end());
+                loc_matches.erase(std::unique(loc_matches.begin(),loc_matches.end()),loc_matches.end());
+            }
+
+            std::vector<T> loc_res;
+            std::unordered_set<T> loc_found;
+            for (auto&& it : loc_matches)
+            {
+                const T& loc_value = _entries[it].value;
+                if (!loc_found.insert(loc_value).second) continue;
+                loc_res.push_back(loc_value);
+                if (a_max > 0 && loc_res.size() >= a_max) break;
+            }
+            return loc_res;
+        }
+
+        std::unordered_map<std::string,T,StringHash,std::equal_to<>>    _exact;
+        std::unordered_map<std::string,T>                               _noCase;
+        std::vector<Entry>                                              _entries;
+        std::vector<Suffix>                                             _suffixes;
+    };
+}
@@ -26,11 +26,11 @@ namespace DeviousDevices
         void UpdatePlayer(RE::Actor* a_actor);
         void Setup();
         //void Update();
-        void UpdateTimed(RE::Actor* a_actor);
+        void UpdateNPC(RE::Actor* a_actor);
         void Reload();
 
-        void CleanUnusedActors();
-        void IncUpdateCounter();
+        // Removes saved node states of actor which is no longer updated
+        void ForgetActor(uint32_t a_handle);
 
         Spinlock SaveLock;
     protected:
@@ -39,6 +39,9 @@ namespace DeviousDevices
         bool AddHideNode(RE::Actor* a_actor, std::string a_nodename);
         bool RemoveHideNode(RE::Actor* a_actor, std::string a_nodename);
     private:
+        void LoadNodes(const ConfigSnapshot& a_config);
+        // Shows all nodes hidden by plugin and forgets their states. SaveLock have to be held
+        void ShowAllNodes(bool a_enabled, bool a_hidearms);
         bool _installed = false;
         std::vector<uint32_t>       _lastupdatestack;
         std::vector<std::string>    _WeaponNodes;
@@ -50,8 +53,6 @@ namespace DeviousDevices
         std::unordered_map<uint32_t,HidderState> _fingerhiddenstates; //temporary array with state of finger nodes on updated actors
         std::unordered_map<uint32_t,HidderState> _weaponhiddenstates; //temporary array with state of weapon nodes on updated actors
         std::unordered_map<uint32_t,std::unordered_map<std::string,HidderState>> _weaponnodestates; //temporary array with states of weapon nodes on updated actors
-        uint64_t                    _UpdateCounter = 0UL;
-        std::unordered_map<RE::Actor*,UpdateHandle> _UpdatedActors;
         std::vector<std::string>    _ArmHiddingKeywords;
         std::vector<std::string>    _HandHiddingKeywords;
         std::vector<std::string>    _FingerHiddingKeywords;
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Spinlock.h"
+
+namespace DeviousDevices
+{
+    // Caches values derived from device properties per (owner, property name). Owner is device record handle, so
+    // different versions of the same device (mode 0/1) are different entries. Property names are case insensitive, same
+    // as in DeviceHandle, and are looked up without making lower case copies.
+    // Device records never change after data are loaded, so entries are never invalidated, only dropped by Clear when
+    // database is rebuilt. Value is resolved outside of lock, so concurrent misses on same key may resolve it twice
+    template <typename V>
+    class PropertyCache
+    {
+    public:
+        struct Stats
+        {
+            uint64_t hits   = 0;
+            uint64_t misses = 0;
+        };
+
+        template <typename F>
+        V Get(const void* a_owner, std::string_view a_name, F a_resolve)
+        {
+            {
+                UniqueLock lock(_lock);
+                const auto loc_it = _entries.find(KeyView{a_owner,a_name});
+                if (loc_it != _entries.end())
+                {
+                    _stats.hits++;
+                    return loc_it->second;
+                }
+                _stats.misses++;
+            }
+
+            V loc_res = a_resolve();
+
+            UniqueLock lock(_lock);
+            _entries.try_emplace(Key{a_owner,std::string(a_name)},loc_res);
+            return loc_res;
+        }
+
+        void Clear()
+        {
+            UniqueLock lock(_lock);
+            _entries.clear();
+        }
+
+        size_t Size() const
+        {
+            UniqueLock lock(_lock);
+            return _entries.size();
+        }
+
+        Stats GetStats(bool a_reset)
+        {
+            UniqueLock lock(_lock);
+            const Stats loc_res = _stats;
+            if (a_reset) _stats = Stats();
+            return loc_res;
+        }
+    private:
+        struct Key
+        {
+            const void* owner;
+            std::string name;
+        };
+
+        struct KeyView
+        {
+            const void*         owner;
+            std::string_view    name;
+        };
+
+        //property names are ASCII, so locale aware tolower is not needed
+        static char Lower(char a_char) { return (a_char >= 'A' && a_char <= 'Z') ? static_cast<char>(a_char + ('a' - 'A')) : a_char; }
+
+        struct Hash
+        {
+            using is_transparent = void;
+
+            size_t operator()(const Key& a_key) const { return (*this)(KeyView{a_key.owner,a_key.name}); }
+            size_t operator()(const KeyView& a_key) const
+            {
+                //FNV-1a of lower case name, mixed with owner
+                uint64_t loc_res = 0xCBF29CE484222325ULL ^ reinterpret_cast<uintptr_t>(a_key.owner);
+                for (auto&& it : a_key.name) loc_res = (loc_res ^ static_cast<uint8_t>(Lower(it)))*0x100000001B3ULL;
+                return static_cast<size_t>(loc_res);
+            }
+        };
+
+        struct Equal
+        {
+            using is_transparent = void;
+
+            bool operator()(const KeyView& a_1, const KeyView& a_2) const
+            {
+                return a_1.owner == a_2.owner && a_1.name.size() == a_2.name.size() &&
+                       std::equal(a_1.name.begin(),a_1.name.end(),a_2.name.begin(),[](char a_c1, char a_c2){ return Lower(a_c1) == Lower(a_c2); });
+            }
+            bool operator()(const Key& a_1, const Key& a_2) const       { return (*this)(KeyView{a_1.owner,a_1.name},KeyView{a_2.owner,a_2.name}); }
+            bool operator()(const Key& a_1, const KeyView& a_2) const   { return (*this)(KeyView{a_1.owner,a_1.name},a_2); }
+            bool operator()(const KeyView& a_1, const Key& a_2) const   { return (*this)(a_1,KeyView{a_2.owner,a_2.name}); }
+        };
+
+        std::unordered_map<Key,V,Hash,Equal>    _entries;
+        Stats                                   _stats;
+        mutable Spinlock                        _lock;
+    };
+}
@@ -2,20 +2,64 @@
 
 #include "Script.hpp"
 
+// zadConfig properties mirrored to native code. X(type, property name, default value of property)
+#define DD_MCM_SETTINGS(X)                          \
+    X(bool,     mittensDropToggle,      true)       \
+    X(bool,     UseItemManipulation,    false)
+
 namespace DeviousDevices {
-    class Settings {
+    struct SettingsMirror
+    {
+        #define DD_MCM_SETTING_FIELD(a_type,a_name,a_default) a_type a_name = a_default;
+        DD_MCM_SETTINGS(DD_MCM_SETTING_FIELD)
+        #undef DD_MCM_SETTING_FIELD
+
+        bool operator==(const SettingsMirror&) const = default;
+    };
+
+    class Settings : public RE::BSTEventSink<RE::MenuOpenCloseEvent> {
     public:
         [[nodiscard]] inline static Settings& GetSingleton() noexcept { 
             static Settings set;
             return set;
         }
 
-        template <typename T>
-        inline T GetSetting(std::string name) {
-            auto configQuest = RE::TESDataHandler::GetSingleton()->LookupForm<RE::TESQuest>(
-                0x01A282, "Devious Devices - Integration.esm");
-            auto settings = ScriptUtils::GetScriptObject(configQuest, "zadconfig");
-            return ScriptUtils::GetProperty<T>(settings, name);
+        inline void Setup() {
+            if (_installed) return;
+            _installed = true;
+            RE::UI::GetSingleton()->AddEventSink<RE::MenuOpenCloseEvent>(this);
+        }
+
+        // Mirrored zadConfig values. Reading them is plain memory read, so it can be used on hot paths.
+        // Values are refreshed on game load, after MCM is closed and when zadConfig calls RefreshSettings
+        inline const SettingsMirror& GetMirror() const { return _mirror.Get(); }
+
+        // Reads all mirrored properties from zadConfig script. Has to be called from main thread.
+        // New mirror is only published if some value changed, as published mirrors are kept until the game exits
+        inline void Refresh() {
+            const auto loc_start = std::chrono::steady_clock::now();
+
+            //script objects are recreated on game load, so the object is resolved on every refresh
+            RE::TESQuest* loc_quest = GetConfigQuest();
+            ScriptUtils::ObjectPtr loc_config = loc_quest ? ScriptUtils::GetScriptObject(loc_quest, "zadconfig") : nullptr;
+            if (!loc_config) {
+                DEBUG("Settings::Refresh() - zadconfig script not found, keeping current values")
+                return;
+            }
+
+            auto loc_mirror = std::make_unique<SettingsMirror>();
+            #define DD_MCM_SETTING_READ(a_type,a_name,a_default)                            \
+                if (auto loc_var = loc_config->GetProperty(#a_name))                        \
+                    loc_mirror->a_name = RE::BSScript::UnpackValue<a_type>(loc_var);        \
+                else                                                                        \
+                    WARN("Settings::Refresh() - Property " #a_name " not found")
+            DD_MCM_SETTINGS(DD_MCM_SETTING_READ)
+            #undef DD_MCM_SETTING_READ
+            const bool loc_changed = *loc_mirror != _mirror.Get();
+            if (loc_changed) _mirror.Publish(std::move(loc_mirror));
+
+            const double loc_time = std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now() - loc_start).count();
+            DEBUG("Settings::Refresh() - Settings refreshed in {:.1f} us, changed = {}",loc_time,loc_changed)
         }
 
         template <typename T>
@@ -25,7 +69,30 @@ namespace DeviousDevices {
             auto lib = ScriptUtils::GetScriptObject(libQuest, "zadlibs");
             return ScriptUtils::GetProperty<T>(lib, name);
         }
-    };
-}
 
+        inline RE::BSEventNotifyControl ProcessEvent(const RE::MenuOpenCloseEvent* a_event, RE::BSTEventSource<RE::MenuOpenCloseEvent>*) override {
+            // MCM is part of journal menu
+            if (a_event != nullptr && !a_event->opening && a_event->menuName == RE::JournalMenu::MENU_NAME) Refresh();
+            return RE::BSEventNotifyControl::kContinue;
+        }
+    private:
+        Settings() = default;
 
+        inline RE::TESQuest* GetConfigQuest() {
+            if (_configQuest == nullptr) {
+                _configQuest = RE::TESDataHandler::GetSingleton()->LookupForm<RE::TESQuest>(
+                    0x01A282, "Devious Devices - Integration.esm");
+            }
+            return _configQuest;
+        }
+
+        bool                                _installed     = false;
+        RE::TESQuest*                       _configQuest   = nullptr;
+        SnapshotPublisher<SettingsMirror>   _mirror;
+    };
+
+    inline void RefreshSettings(PAPYRUSFUNCHANDLE)
+    {
+        Settings::GetSingleton().Refresh();
+    }
+}
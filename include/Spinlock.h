@@ -0,0 +1,137 @@
+#pragma once
+
+#include <immintrin.h>
+
+namespace DeviousDevices
+{
+    // Test and test-and-set lock with exponential pause backoff. If lock is not acquired after spinning for a while,
+    // thread sleeps on the lock word (std::atomic::wait, which uses WaitOnAddress on Windows and futex on Linux).
+    // Fast path is single CAS. Contention statistics are only recorded on slow path, and only if enabled
+    class Spinlock
+    {
+    public:
+        struct Stats
+        {
+            uint64_t contended  = 0;    //number of Lock calls which had to wait
+            uint64_t sleeps     = 0;    //number of times waiting thread went to sleep
+            uint64_t waitTime   = 0;    //total wait time in nanoseconds
+            uint64_t maxWait    = 0;    //longest wait in nanoseconds
+        };
+
+        void Lock()
+        {
+            uint32_t loc_expected = sFree;
+            if (_state.compare_exchange_strong(loc_expected,sLocked,std::memory_order_acquire,std::memory_order_relaxed)) return;
+            LockSlow();
+        }
+
+        bool TryLock()
+        {
+            uint32_t loc_expected = sFree;
+            return _state.compare_exchange_strong(loc_expected,sLocked,std::memory_order_acquire,std::memory_order_relaxed);
+        }
+
+        void Unlock()
+        {
+            //only wake up sleeping thread if there is any, so uncontended unlock is single exchange
+            if (_state.exchange(sFree,std::memory_order_release) == sSleeping) _state.notify_one();
+        }
+
+        Stats GetStats() const
+        {
+            return {_contended.load(std::memory_order_relaxed),_sleeps.load(std::memory_order_relaxed),
+                    _waitTime.load(std::memory_order_relaxed),_maxWait.load(std::memory_order_relaxed)};
+        }
+
+        void ResetStats()
+        {
+            _contended  = 0;
+            _sleeps     = 0;
+            _waitTime   = 0;
+            _maxWait    = 0;
+        }
+
+        // Enables recording of contention statistics for all locks
+        static void EnableStats(bool a_enable) { _statsEnabled.store(a_enable,std::memory_order_relaxed); }
+    private:
+        enum : uint32_t
+        {
+            sFree       = 0,
+            sLocked     = 1,
+            sSleeping   = 2     //locked, and some thread may sleep on the lock
+        };
+
+        static constexpr uint32_t MaxBackoff    = 64;   //max number of pauses between checks
+        static constexpr uint32_t SpinLimit     = 16;   //number of backoff rounds before thread goes to sleep
+
+        void LockSlow()
+        {
+            const bool loc_stats = _statsEnabled.load(std::memory_order_relaxed);
+            const auto loc_start = loc_stats ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
+            bool     loc_acquired   = false;
+            uint32_t loc_backoff    = 1;
+            for (uint32_t loc_round = 0; loc_round < SpinLimit; loc_round++)
+            {
+                //only read while locked, so cache line is not bounced between waiting cores
+                for (uint32_t i = 0; i < loc_backoff; i++) _mm_pause();
+                loc_backoff = std::min(loc_backoff*2,MaxBackoff);
+
+                if (_state.load(std::memory_order_relaxed) == sFree && TryLock())
+                {
+                    loc_acquired = true;
+                    break;
+                }
+            }
+
+            uint64_t loc_sleeps = 0;
+            if (!loc_acquired)
+            {
+                //lock is taken as sleeping, as there could be other sleeping threads which need to be woken up by unlock
+                while (_state.exchange(sSleeping,std::memory_order_acquire) != sFree)
+                {
+                    _state.wait(sSleeping,std::memory_order_relaxed);
+                    loc_sleeps++;
+                }
+            }
+
+            if (loc_stats)
+            {
+                const uint64_t loc_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - loc_start).count();
+                _contended.fetch_add(1,std::memory_order_relaxed);
+                _sleeps.fetch_add(loc_sleeps,std::memory_order_relaxed);
+                _waitTime.fetch_add(loc_time,std::memory_order_relaxed);
+                uint64_t loc_max = _maxWait.load(std::memory_order_relaxed);
+                while (loc_time > loc_max && !_maxWait.compare_exchange_weak(loc_max,loc_time,std::memory_order_relaxed)) {}
+            }
+        }
+
+        std::atomic<uint32_t>   _state      = sFree;
+        std::atomic<uint64_t>   _contended  = 0;
+        std::atomic<uint64_t>   _sleeps     = 0;
+        std::atomic<uint64_t>   _waitTime   = 0;
+        std::atomic<uint64_t>   _maxWait    = 0;
+
+        inline static std::atomic<bool> _statsEnabled = false;
+    };
+
+    class UniqueLock
+    {
+    public:
+        UniqueLock(Spinlock& a_lock)
+        {
+            _lock = &a_lock;
+            _lock->Lock();
+        }
+        ~UniqueLock()
+        {
+            _lock->Unlock();
+        }
+        void Unlock()
+        {
+            _lock->Unlock();
+        }
+    private:
+        mutable Spinlock* _lock;
+    };
+}
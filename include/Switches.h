@@ -6,4 +6,14 @@
 #define DD_ALLOWFASTPAPYRUSCALL_S       1U
 
 // equip rework enabled
-#define DD_EQREWORKON                   0U
\ No newline at end of file
+#define DD_EQREWORKON                   0U
+
+// highest log level compiled in (0 = errors, 1 = warnings, 2 = all messages). Messages above this level are removed by preprocessor,
+// so their arguments are never evaluated. Messages which are compiled in are still filtered by Main.iLogging
+#define DD_LOGLEVEL_S                   2U
+
+// scoped timers of hot paths (DD_PROFILE_SCOPE). If enabled, timers are still inactive until Main.bProfiling is set
+#define DD_PROFILING_S                  1U
+
+// trace spans (DD_TRACE_SCOPE and DD_PROFILE_SCOPE) exported as Chrome trace JSON. If enabled, spans are still not recorded until Main.bTracing is set
+#define DD_TRACING_S                    1U
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Utils.h"
+
+namespace DeviousDevices
+{
+    class TimerTask
+    {
+    public:
+        enum TaskState : uint8_t
+        {
+            sPending    = 0,    //waiting in wheel
+            sRunning    = 1,    //callback is currently executed
+            sCancelled  = 2,
+            sFinished   = 3     //one-shot task which was already executed
+        };
+
+        TimerTask(std::function<void()> a_callback, uint64_t a_period)
+        : _callback(std::move(a_callback)), _period(a_period)
+        {}
+
+        // Prevents next execution of the task. Can be called from any thread. Returns false if the task already finished or was cancelled
+        bool Cancel();
+        TaskState GetState() const { return _state.load(std::memory_order_acquire); }
+        bool IsPeriodic() const { return _period > 0; }
+    private:
+        friend class TimerWheel;
+        std::function<void()>   _callback;
+        uint64_t                _period;        //in ticks, 0 = one-shot
+        uint64_t                _expiry = 0ULL; //in ticks
+        std::atomic<TaskState>  _state  = sPending;
+    };
+
+    typedef std::shared_ptr<TimerTask> TimerTaskHandle;
+
+    // Hierarchical timer wheel (4 levels of 64 slots) with 1 ms resolution.
+    // Time is advanced manually (from player update hook), and all callbacks are executed on the thread which calls Advance.
+    // Tasks can be scheduled and cancelled from any thread
+    class TimerWheel
+    {
+    public:
+        static constexpr uint32_t   SlotBits    = 6U;
+        static constexpr uint32_t   SlotCount   = 1U << SlotBits;
+        static constexpr uint32_t   LevelCount  = 4U;
+        static constexpr uint64_t   MaxDelay    = (1ULL << (SlotBits*LevelCount)) - 1ULL;   //~4.6 hours, longer delays are cascaded multiple times
+
+        TimerTaskHandle ScheduleOnce(uint64_t a_delayMs, std::function<void()> a_callback);
+
+        // First execution is after a_firstDelayMs, or after one period if it is 0
+        TimerTaskHandle SchedulePeriodic(uint64_t a_periodMs, std::function<void()> a_callback, uint64_t a_firstDelayMs = 0ULL);
+
+        // Advances time by a_delta seconds and executes all expired tasks. Returns number of executed callbacks.
+        // Periodic task is executed at most once per advance, periods missed because of long frame are skipped
+        size_t Advance(float a_delta);
+        size_t AdvanceTicks(uint64_t a_ticks);
+
+        void Clear();
+        uint64_t GetTime() const { return _now; }
+        size_t GetTaskCount() const;
+    private:
+        TimerTaskHandle Schedule(uint64_t a_delay, uint64_t a_period, std::function<void()> a_callback);
+        void InsertPending();
+        void Insert(TimerTaskHandle a_task);
+        void Cascade(uint32_t a_level);
+
+        uint64_t    _now        = 0ULL;
+        double      _remainder  = 0.0;  //unprocessed part of tick from last advance
+        std::array<std::array<std::vector<TimerTaskHandle>,SlotCount>,LevelCount> _wheel;
+        std::vector<TimerTaskHandle> _expired;
+
+        mutable Spinlock                _pendingLock;
+        std::vector<TimerTaskHandle>    _pending;   //tasks scheduled since last advance
+        std::atomic<bool>               _hasPending = false;
+        std::atomic<size_t>             _taskCount = 0;
+    };
+}
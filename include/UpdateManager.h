@@ -3,6 +3,8 @@
 #include "NodeHider.h"
 #include "Expression.h"
 #include "Config.h"
+#include "TimerWheel.h"
+#include "UpdateQueue.h"
 
 namespace DeviousDevices
 {
@@ -12,14 +14,55 @@ namespace DeviousDevices
     public:
         void Setup();
 
-        bool UpdateThread1 = false;
-        bool UpdateThread2 = false;
-        bool UpdateThread3 = false;
+        // Scheduler driven by player update. All tasks are executed on main thread, and only when no menu is open
+        TimerWheel& GetScheduler() { return _scheduler; }
+        void Reload();
+
+        // Prints hot path timings collected since last call, to log file or console
+        void LogProfile(bool a_console);
     private:
         bool _installed = false;
+        TimerWheel      _scheduler;
+        TimerTaskHandle _gagTask;
+        TimerTaskHandle _gagPresetTask;
+        TimerTaskHandle _nodeHiderTask;
+        TimerTaskHandle _statsTask;
+        TimerTaskHandle _configTask;
+        UpdateQueue     _npcQueue;
+        SnapshotPublisher<UpdateLODSettings> _lodSettings;   //read by NPC update threads, written on config reload
+        std::atomic<uint64_t> _frame = 0ULL;
+        void ApplyConfig(const ConfigSnapshot& a_config);
+        void ProcessNPCJob(const UpdateQueue::Job& a_job);
+        float GetLODMultiplier(RE::Actor* a_actor) const;
         static void UpdatePlayer(RE::Actor* a_actor, float a_delta);
         static void UpdateCharacter(RE::Actor* a_actor, float a_delta);
         inline static REL::Relocation<decltype(UpdatePlayer)>       UpdatePlayer_old;
         inline static REL::Relocation<decltype(UpdateCharacter)>    UpdateCharacter_old;
     };
+
+    inline void PrintProfile(PAPYRUSFUNCHANDLE)
+    {
+        if (!Instrumentation::IsEnabled())
+        {
+            CLOG("Profiling is disabled. Set bProfiling = true in DeviousDevices.ini")
+            return;
+        }
+        UpdateManager::GetSingleton()->LogProfile(true);
+    }
+
+    inline void ExportTrace(PAPYRUSFUNCHANDLE)
+    {
+        auto loc_folder = SKSE::log::log_directory();
+        if (!loc_folder) return;
+        const auto loc_path = *loc_folder / "DeviousDevicesNG_trace.json";
+        const int64_t loc_count = Instrumentation::ExportTrace(loc_path);
+        if (loc_count < 0)
+        {
+            CLOG("Failed to write trace to {}",loc_path.string())
+        }
+        else
+        {
+            CLOG("Trace with {} spans written to {}",loc_count,loc_path.string())
+        }
+    }
 }
\ No newline at end of file
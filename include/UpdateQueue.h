@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Utils.h"
+
+namespace DeviousDevices
+{
+    enum UpdateType : uint8_t
+    {
+        tGagExpression  = 0,
+        tNodeHider      = 1,
+        tUpdateTypeCount
+    };
+
+    // Level of detail of NPC updates, based on distance from camera and visibility
+    struct UpdateLODSettings
+    {
+        bool    enabled             = true;
+        float   nearDistance        = 1500.0f;  //NPCs closer than this are updated with base interval
+        float   farDistance         = 6000.0f;  //NPCs further than this are updated with farMultiplier*interval
+        float   farMultiplier       = 4.0f;
+        bool    deferOffscreen      = true;     //NPCs outside of camera view are not updated until they become visible
+
+        bool operator==(const UpdateLODSettings&) const = default;
+    };
+
+    // Returns multiplier of update interval. 0 = update is deferred
+    float GetUpdateLODMultiplier(const UpdateLODSettings& a_settings, float a_distance, bool a_visible);
+
+    // Central queue of periodic NPC updates.
+    // NPCs are registered from their update, and every update type is queued once its interval (in frames) elapses.
+    // First update of every NPC is offset by hash of its handle, so updates of NPCs which were loaded at once are spread across frames.
+    // Interval can be scaled per NPC by LOD multiplier, see GetUpdateLODMultiplier.
+    // Queue is drained once per frame with time budget. Jobs which do not fit to the budget are left for next frame
+    class UpdateQueue
+    {
+    public:
+        struct Job
+        {
+            uint32_t    handle;
+            UpdateType  type;
+        };
+
+        struct DrainStats
+        {
+            uint64_t    frames  = 0;    //number of frames in sample
+            float       p50     = 0.0f; //drain time in us
+            float       p99     = 0.0f;
+            float       max     = 0.0f;
+            size_t      backlog = 0;    //jobs left in queue
+        };
+
+        UpdateQueue();
+
+        // 0 = update type is disabled
+        void SetInterval(UpdateType a_type, uint32_t a_frames);
+        void SetBudget(uint32_t a_microseconds);
+
+        void Touch(uint32_t a_handle, uint64_t a_frame, float a_lodMultiplier = 1.0f);
+
+        // Executes queued jobs until budget is exhausted. At least one job is executed every frame, so queue can't stall
+        size_t Drain(const std::function<void(const Job&)>& a_func);
+
+        // Removes NPCs which were not touched for a while
+        size_t Sweep(uint64_t a_frame, const std::function<void(uint32_t)>& a_onExpired);
+
+        void Clear();
+        size_t GetActorCount() const;
+        size_t GetBacklog() const;
+        DrainStats GetDrainStats() const;
+        Spinlock::Stats GetLockStats(bool a_reset);
+
+        static uint32_t StaggerOffset(uint32_t a_handle, uint32_t a_interval);
+    private:
+        struct ActorState
+        {
+            std::array<int64_t,tUpdateTypeCount>    lastFrame   = {};   //frame in which last job was queued
+            std::array<bool,tUpdateTypeCount>       queued      = {};
+        };
+
+        static constexpr size_t StatsSamples = 1024;
+
+        mutable Spinlock                            _lock;
+        GenerationalSweeper<uint32_t,ActorState>    _actors = GenerationalSweeper<uint32_t,ActorState>(40,4); //actors are removed after 121-160 frames without update
+        std::deque<Job>                             _jobs;
+        std::array<uint32_t,tUpdateTypeCount>       _intervals;
+        uint32_t                                    _budget = 1000U;
+
+        std::array<float,StatsSamples>              _samples = {};
+        uint64_t                                    _sampleCount = 0ULL;
+    };
+}
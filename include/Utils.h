@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Spinlock.h"
+
 namespace DeviousDevices {
     namespace Utils {
         void ForEachReferenceInRange(
@@ -11,41 +13,222 @@ namespace DeviousDevices {
                                     std::function<void(RE::Actor* a_actor)> callback);
     }  // namespace Utils
 
-    class Spinlock
+    // Keeps values for keys which are regularly touched (once per frame or so) and drops the ones which were not touched for a while.
+    // Keys are bucketed by generation (group of a_generationFrames frames) in a ring of a_generations buckets,
+    // so sweep only visits buckets of expired generations instead of walking all entries.
+    // Key touched in generation G is dropped once the current generation reaches G + a_generations
+    template<typename K, typename V>
+    class GenerationalSweeper
     {
     public:
-        void Lock()
+        GenerationalSweeper(uint64_t a_generationFrames, uint32_t a_generations)
+        : _generationFrames(std::max<uint64_t>(a_generationFrames,1ULL)), _buckets(std::max<uint32_t>(a_generations,2U))
+        {}
+
+        // Marks key as used in passed frame. Returns value of the key, and true if the key was newly added
+        std::pair<V*,bool> Touch(const K& a_key, uint64_t a_frame)
         {
-            while (_lock.exchange(true))
+            const uint64_t loc_generation = a_frame/_generationFrames;
+            auto [loc_it,loc_inserted] = _entries.try_emplace(a_key);
+            if (loc_inserted || loc_it->second.generation != loc_generation)
             {
-                ;
+                //key is added to bucket only once per generation. Old references are dropped lazily by Sweep
+                loc_it->second.generation = loc_generation;
+                _buckets[loc_generation % _buckets.size()].push_back({a_key,loc_generation});
             }
+            return {&loc_it->second.value,loc_inserted};
+        }
+
+        V* Find(const K& a_key)
+        {
+            auto loc_it = _entries.find(a_key);
+            return (loc_it != _entries.end()) ? &loc_it->second.value : nullptr;
         }
-        void Unlock()
+
+        bool Erase(const K& a_key)
         {
-            _lock.store(false);
+            return _entries.erase(a_key) > 0;
+        }
+
+        // Removes all expired keys. a_onExpired(const K&, V&) is called for every key before it is removed
+        // Returns number of removed keys
+        template<typename F>
+        size_t Sweep(uint64_t a_frame, F&& a_onExpired)
+        {
+            const uint64_t loc_generation = a_frame/_generationFrames;
+            const uint64_t loc_ring       = _buckets.size();
+            if (loc_generation < loc_ring) return 0;
+
+            const uint64_t loc_expired = loc_generation - loc_ring; //newest expired generation
+            if (_swept != UINT64_MAX && loc_expired <= _swept) return 0;
+
+            //only last loc_ring generations can have non empty bucket
+            uint64_t loc_first = (_swept == UINT64_MAX) ? 0 : _swept + 1;
+            if (loc_expired - loc_first >= loc_ring) loc_first = loc_expired - loc_ring + 1;
+
+            size_t loc_res = 0;
+            for (uint64_t g = loc_first; g <= loc_expired; g++)
+            {
+                auto& loc_bucket = _buckets[g % loc_ring];
+                size_t loc_kept = 0;
+                for (size_t i = 0; i < loc_bucket.size(); i++)
+                {
+                    const BucketRef loc_ref = loc_bucket[i];
+                    if (loc_ref.generation > loc_expired)
+                    {
+                        //bucket was already reused by newer generation before sweep
+                        loc_bucket[loc_kept++] = loc_ref;
+                        continue;
+                    }
+
+                    auto loc_it = _entries.find(loc_ref.key);
+                    if (loc_it != _entries.end() && loc_it->second.generation == loc_ref.generation)
+                    {
+                        a_onExpired(loc_it->first,loc_it->second.value);
+                        _entries.erase(loc_it);
+                        loc_res++;
+                    }
+                }
+                loc_bucket.resize(loc_kept);
+            }
+            _swept = loc_expired;
+            return loc_res;
+        }
+
+        void Clear()
+        {
+            _entries.clear();
+            for (auto&& it : _buckets) it.clear();
+            _swept = UINT64_MAX;
+        }
+
+        size_t Size() const
+        {
+            return _entries.size();
         }
     private:
-        mutable std::atomic<bool> _lock   = false;
+        struct Entry
+        {
+            V           value       = V();
+            uint64_t    generation  = 0ULL;
+        };
+        struct BucketRef
+        {
+            K           key;
+            uint64_t    generation;
+        };
+
+        uint64_t                            _generationFrames;
+        uint64_t                            _swept = UINT64_MAX; //last swept generation
+        std::unordered_map<K,Entry>         _entries;
+        std::vector<std::vector<BucketRef>> _buckets;
     };
 
-    class UniqueLock
+    // Immutable value published to readers with single atomic pointer, so reading is just a load.
+    // Replaced values are retired, not freed, so references obtained by readers stay valid.
+    // Intended for values which are replaced rarely (like config reload)
+    template<typename T>
+    class SnapshotPublisher
     {
     public:
-        UniqueLock(Spinlock& a_lock)
+        SnapshotPublisher()
         {
-            _lock = &a_lock;
-            _lock->Lock();
+            Publish(std::make_unique<T>());
         }
-        ~UniqueLock()
+
+        const T& Get() const
         {
-            _lock->Unlock();
+            return *_current.load(std::memory_order_acquire);
         }
-        void Unlock()
+
+        void Publish(std::unique_ptr<T> a_value)
+        {
+            UniqueLock lock(_lock);
+            _current.store(a_value.get(),std::memory_order_release);
+            _snapshots.push_back(std::move(a_value));
+        }
+
+        size_t GetPublishCount() const
         {
-            _lock->Unlock();
+            UniqueLock lock(_lock);
+            return _snapshots.size();
+        }
+    private:
+        std::atomic<const T*>           _current = nullptr;
+        std::vector<std::unique_ptr<T>> _snapshots;
+        mutable Spinlock                _lock;
+    };
+
+    // xoshiro256** generator. Cheap to use on hot paths, where std::random_device + std::mt19937 would be created every call.
+    // Not suitable for anything security related
+    class FastRandom
+    {
+    public:
+        explicit FastRandom(uint64_t a_seed)
+        {
+            //splitmix64, so similar seeds give unrelated states
+            for (auto&& it : _state)
+            {
+                a_seed += 0x9E3779B97F4A7C15ULL;
+                uint64_t loc_z = a_seed;
+                loc_z = (loc_z ^ (loc_z >> 30))*0xBF58476D1CE4E5B9ULL;
+                loc_z = (loc_z ^ (loc_z >> 27))*0x94D049BB133111EBULL;
+                it = loc_z ^ (loc_z >> 31);
+            }
+        }
+
+        uint64_t Next()
+        {
+            const uint64_t loc_res = std::rotl(_state[1]*5,7)*9;
+            const uint64_t loc_t = _state[1] << 17;
+            _state[2] ^= _state[0];
+            _state[3] ^= _state[1];
+            _state[1] ^= _state[2];
+            _state[0] ^= _state[3];
+            _state[2] ^= loc_t;
+            _state[3] = std::rotl(_state[3],45);
+            return loc_res;
+        }
+
+        // Uniform value in range [a_min,a_max)
+        double NextDouble(double a_min = 0.0, double a_max = 1.0)
+        {
+            return a_min + (a_max - a_min)*(static_cast<double>(Next() >> 11)*0x1.0p-53);
+        }
+
+        // Generator of calling thread, seeded once per thread
+        static FastRandom& GetThreadLocal()
+        {
+            thread_local FastRandom loc_random((static_cast<uint64_t>(std::random_device()()) << 32) ^ std::random_device()() ^
+                                               std::hash<std::thread::id>()(std::this_thread::get_id()));
+            return loc_random;
+        }
+    private:
+        std::array<uint64_t,4> _state;
+    };
+
+    // Groups calls which come shortly after each other into one operation (for example taking all items from container,
+    // which calls pickup hook for every item). Window is measured from first call of batch, so continuous calls still
+    // start new batch at least once per window
+    class CallBatch
+    {
+    public:
+        explicit CallBatch(std::chrono::milliseconds a_window) : _window(a_window) {}
+
+        // Returns true if this call starts new batch
+        bool Next(std::chrono::steady_clock::time_point a_now = std::chrono::steady_clock::now())
+        {
+            const bool loc_new = !_started || (a_now - _start) > _window;
+            if (loc_new)
+            {
+                _started = true;
+                _start = a_now;
+            }
+            return loc_new;
         }
     private:
-        mutable Spinlock* _lock;
+        std::chrono::milliseconds               _window;
+        std::chrono::steady_clock::time_point   _start;
+        bool                                    _started = false;
     };
-}  // namespace DeviousDevices
\ No newline at end of file
+}  // namespace DeviousDevices
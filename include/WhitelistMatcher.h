@@ -0,0 +1,34 @@
+#pragma once
+
+namespace DeviousDevices
+{
+    // Multi pattern substring matcher (Aho-Corasick automaton compiled to DFA).
+    // Every pattern has mask of lists it belongs to. Match returns union of masks of all patterns found in text.
+    // Matching is case insensitive for ASCII letters, same as comparing std::tolower-ed strings
+    class WhitelistMatcher
+    {
+    public:
+        // Adds pattern. Empty and single space patterns are ignored, so they never match
+        void AddPattern(std::string_view a_pattern, uint8_t a_mask);
+
+        // Compiles automaton from added patterns. Has to be called before Match
+        void Build();
+
+        // Single pass over a_text. Stops early once all bits from a_stopMask were found
+        uint8_t Match(std::string_view a_text, uint8_t a_stopMask = 0xFF) const;
+
+        // Union of masks of all added patterns. Returns 0 for list which have no valid pattern
+        uint8_t GetMask() const { return _mask; }
+        size_t GetStateCount() const { return _output.size(); }
+
+        static char Fold(char a_char) { return static_cast<char>(std::tolower(static_cast<unsigned char>(a_char))); }
+    private:
+        std::vector<std::pair<std::string,uint8_t>> _patterns;
+        uint8_t                                     _mask       = 0;
+
+        std::array<uint16_t,256>                    _classMap   = {};   //byte -> class of its folded value. Class 0 = byte not used in any pattern
+        uint32_t                                    _classes    = 1;
+        std::vector<uint32_t>                       _next;              //state*_classes + class -> next state
+        std::vector<uint8_t>                        _output;            //state -> mask of patterns ending in this state (including suffixes)
+    };
+}
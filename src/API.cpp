@@ -76,7 +76,9 @@ std::vector<std::string> DeviousDevicesAPI::DeviousDevicesAPI::GetPropertyString
 
 bool DeviousDevicesAPI::DeviousDevicesAPI::ApplyExpression(RE::Actor* a_actor, const std::vector<float> a_expression, float a_strength, bool a_openMouth, int a_priority) const
 {
-    return DeviousDevices::ExpressionManager::GetSingleton()->ApplyExpression(a_actor,a_expression,a_strength,a_openMouth,a_priority);
+    DeviousDevices::Expression loc_expression;
+    if (!DeviousDevices::Expression::FromVector(a_expression,loc_expression)) return false;
+    return DeviousDevices::ExpressionManager::GetSingleton()->ApplyExpression(a_actor,loc_expression,a_strength,a_openMouth,a_priority);
 }
 
 bool DeviousDevicesAPI::DeviousDevicesAPI::ResetExpression(RE::Actor* a_actor, int a_priority) const
@@ -4,24 +4,148 @@ using DeviousDevices::ConfigManager;
 
 SINGLETONBODY(ConfigManager)
 
+namespace
+{
+    constexpr const char* ConfigPath = "Data\\skse\\plugins\\DeviousDevices.ini";
+
+    std::filesystem::file_time_type GetConfigWriteTime()
+    {
+        std::error_code loc_error;
+        const auto loc_res = std::filesystem::last_write_time(ConfigPath,loc_error);
+        return loc_error ? std::filesystem::file_time_type() : loc_res;
+    }
+}
+
 void ConfigManager::Setup()
 {
-    _config = boost::property_tree::ptree();
+    boost::property_tree::ptree loc_config;
+    std::unique_ptr<ConfigSnapshot> loc_snapshot;
+    _lastWrite      = GetConfigWriteTime();
+    _changedWrite   = _lastWrite;
+    if (!Load(loc_config,loc_snapshot)) return;
+
+    UniqueLock lock(_lock);
+    _config = std::move(loc_config);
+    _loaded = true;
+    _snapshot.Publish(std::move(loc_snapshot));
+}
+
+bool ConfigManager::Load(boost::property_tree::ptree& a_config, std::unique_ptr<ConfigSnapshot>& a_snapshot) const
+{
     try
     {
-        boost::property_tree::ini_parser::read_ini("Data\\skse\\plugins\\DeviousDevices.ini", _config);
-        _loaded = true;
+        boost::property_tree::ini_parser::read_ini(ConfigPath, a_config);
         DEBUG("DeviousDevices.ini loaded succesfully")
     }
     catch( std::exception &ex )
     {
         ERROR("ERROR LOADING ini FILE: {}",ex.what())
+        return false;
+    }
+
+    //parse all registered variables once, so readers only access fields of snapshot
+    a_snapshot = std::make_unique<ConfigSnapshot>();
+
+    #define DD_CONFIG_READ(a_section,a_name,a_type,a_default) \
+        a_snapshot->a_section##_##a_name = ReadVariable<a_type>(a_config,#a_section "." #a_name,a_default);
+    DD_CONFIG_VARIABLES(DD_CONFIG_READ)
+    #undef DD_CONFIG_READ
+
+    #define DD_CONFIG_READ_ARRAY(a_section,a_name,a_lowercase) \
+        a_snapshot->a_section##_##a_name = GetArrayRaw(a_config,#a_section "." #a_name,a_lowercase); \
+        std::erase(a_snapshot->a_section##_##a_name,"");
+    DD_CONFIG_ARRAYS(DD_CONFIG_READ_ARRAY)
+    #undef DD_CONFIG_READ_ARRAY
+
+    ValidateSnapshot(*a_snapshot);
+    return true;
+}
+
+void ConfigManager::ValidateSnapshot(ConfigSnapshot& a_snapshot)
+{
+    const ConfigSnapshot loc_default;
+
+    //values out of range are replaced by default ones
+    #define DD_CONFIG_MIN(a_section,a_name,a_min)                                                       \
+        if (a_snapshot.a_section##_##a_name < a_min)                                                    \
+        {                                                                                               \
+            ERROR("Config variable " #a_section "." #a_name " = {} is lower than {} - Using default value",a_snapshot.a_section##_##a_name,a_min) \
+            a_snapshot.a_section##_##a_name = loc_default.a_section##_##a_name;                         \
+        }
+
+    DD_CONFIG_MIN(Main,             iConfigPollTime,    0)
+    DD_CONFIG_MIN(GagExpression,    iUpdatePlayerTime,  1)
+    DD_CONFIG_MIN(GagExpression,    iNPCUpdateTime,     0)
+    DD_CONFIG_MIN(GagExpression,    iPresetRefreshTime, 0)
+    DD_CONFIG_MIN(Expression,       fFadeTime,          0.0f)
+    DD_CONFIG_MIN(Expression,       fGagFadeTime,       0.0f)
+    DD_CONFIG_MIN(UpdateManager,    iNPCFrameBudget,    0)
+    DD_CONFIG_MIN(UpdateManager,    fLODNearDistance,   0.0f)
+    DD_CONFIG_MIN(UpdateManager,    fLODFarDistance,    0.0f)
+    DD_CONFIG_MIN(UpdateManager,    fLODFarMultiplier,  1.0f)
+    DD_CONFIG_MIN(NodeHider,        iUpdatePlayerTime,  1)
+    DD_CONFIG_MIN(NodeHider,        iNPCUpdateTime,     0)
+
+    #undef DD_CONFIG_MIN
+}
+
+void ConfigManager::CheckForChanges()
+{
+    if (_loading) return;
+
+    //publish config parsed by worker thread
+    std::unique_ptr<ConfigSnapshot> loc_pending;
+    {
+        UniqueLock lock(_lock);
+        if (_pending)
+        {
+            loc_pending = std::move(_pending);
+            _config     = std::move(_pendingConfig);
+            _loaded     = true;
+        }
+    }
+    if (loc_pending)
+    {
+        const ConfigSnapshot& loc_old = GetConfig();
+        _snapshot.Publish(std::move(loc_pending));
+        LOG("ConfigManager::CheckForChanges() - Config reloaded")
+        for (auto&& it : _listeners) it(loc_old,GetConfig());
+        return;
+    }
+
+    const auto loc_write = GetConfigWriteTime();
+    if (loc_write == _lastWrite) return;
+
+    //file could be still written, so wait until it stops changing
+    if (loc_write != _changedWrite)
+    {
+        _changedWrite = loc_write;
         return;
     }
 
-    //clean catche, so if game is reloaded, the catche will be also reloaded
-    for (auto&& it : _catche) delete it.second;
-    _catche.clear();
+    _lastWrite  = loc_write;
+    _loading    = true;
+    std::thread([this]
+    {
+        boost::property_tree::ptree loc_config;
+        std::unique_ptr<ConfigSnapshot> loc_snapshot;
+        if (Load(loc_config,loc_snapshot))
+        {
+            UniqueLock lock(_lock);
+            _pending        = std::move(loc_snapshot);
+            _pendingConfig  = std::move(loc_config);
+        }
+        else
+        {
+            ERROR("ConfigManager - Reload failed, keeping previous config")
+        }
+        _loading = false;
+    }).detach();
+}
+
+void ConfigManager::AddReloadListener(ConfigReloadListener a_listener)
+{
+    _listeners.push_back(a_listener);
 }
 
 void DeviousDevices::ConfigManager::SetLoggingDisable(bool a_val)
@@ -34,12 +158,12 @@ bool DeviousDevices::ConfigManager::GetLoggingDisable() const
     return _LogDisable;
 }
 
-std::vector<std::string> ConfigManager::GetArrayRaw(std::string a_name, bool a_tolower, std::string a_sep) const
+std::vector<std::string> ConfigManager::GetArrayRaw(const boost::property_tree::ptree& a_config, std::string a_name, bool a_tolower, std::string a_sep)
 {
     std::vector<std::string> loc_res;
     try
     {
-        boost::split(loc_res,_config.get<std::string>(a_name),boost::is_any_of(a_sep));
+        boost::split(loc_res,a_config.get<std::string>(a_name),boost::is_any_of(a_sep));
     }
     catch(...)
     {
@@ -52,6 +176,11 @@ std::vector<std::string> ConfigManager::GetArrayRaw(std::string a_name, bool a_t
     {
         const auto loc_first = it.find_first_not_of(' ');
         const auto loc_last  = it.find_last_not_of(' ');
+        if (loc_first == std::string::npos)
+        {
+            it.clear();
+            continue;
+        }
         it = it.substr(loc_first,loc_last - loc_first + 1);
         if (a_tolower) std::transform(it.begin(), it.end(), it.begin(), ::tolower);
     }
@@ -60,28 +189,25 @@ std::vector<std::string> ConfigManager::GetArrayRaw(std::string a_name, bool a_t
 }
 
 template<typename T>
-T ConfigManager::GetVariable(std::string a_name, T a_def) const
+T ConfigManager::ReadVariable(const boost::property_tree::ptree& a_config, const std::string& a_name, T a_def)
 {
-    UniqueLock lock(_lock);
-    if (!_loaded) return a_def;
-
-    void* loc_cres = _catche[a_name];
-    if (loc_cres != nullptr) return *(T*)loc_cres;
-
-    T loc_res;
     try
     {
-        loc_res = _config.get<T>(a_name);
+        return a_config.get<T>(a_name);
     }
     catch(...)
     {
         ERROR("Can't get config variable {} - Returning default value",a_name)
-        loc_res = a_def;
+        return a_def;
     }
+}
 
-    _catche[a_name] = new T(loc_res);
-
-    return loc_res;
+template<typename T>
+T ConfigManager::GetVariable(std::string a_name, T a_def) const
+{
+    UniqueLock lock(_lock);
+    if (!_loaded) return a_def;
+    return ReadVariable<T>(_config,a_name,a_def);
 }
 
 template<typename T>
@@ -90,10 +216,7 @@ std::vector<T> ConfigManager::GetArray(std::string a_name, std::string a_sep) co
     UniqueLock lock(_lock);
     if (!_loaded) return std::vector<T>();
 
-    void* loc_cres = _catche[a_name];
-    if (loc_cres != nullptr) return *(std::vector<T>*)loc_cres;
-
-    std::vector<std::string> loc_raw = GetArrayRaw(a_name,true,a_sep);
+    std::vector<std::string> loc_raw = GetArrayRaw(_config,a_name,true,a_sep);
     std::vector<T> loc_res;
 
     for (auto&&it : loc_raw)
@@ -112,8 +235,6 @@ std::vector<T> ConfigManager::GetArray(std::string a_name, std::string a_sep) co
         }
     }
 
-    _catche[a_name] = new std::vector<T>(loc_res);
-
     return loc_res;
 }
 
@@ -122,14 +243,7 @@ std::vector<std::string> ConfigManager::GetArrayText(std::string a_name, bool a_
     UniqueLock lock(_lock);
     if (!_loaded) return std::vector<std::string>();
 
-    void* loc_cres = _catche[a_name];
-    if (loc_cres != nullptr) return *(std::vector<std::string>*)loc_cres;
-
-    std::vector<std::string> loc_res = GetArrayRaw(a_name,a_lowercase,a_sep);
-
-    _catche[a_name] = new std::vector<std::string>(loc_res);
-
-    return loc_res;
+    return GetArrayRaw(_config,a_name,a_lowercase,a_sep);
 }
 
 template int ConfigManager::GetVariable<int>(std::string a_name, int a_def) const;
@@ -0,0 +1,776 @@
+#include "DeviceParser.h"
+
+using namespace DeviousDevices;
+
+namespace
+{
+    //reads field data without going past its end. Lengths and counts are read from file, so every read checks
+    //remaining size first, and malformed record can't be read out of buffer
+    class FieldReader
+    {
+    public:
+        FieldReader(const uint8_t* a_data, size_t a_size) : _data(a_data), _size(a_size) {}
+
+        bool Fits(size_t a_size) const { return a_size <= _size - _pos; }
+
+        //reads value at a_offset from current position, without moving
+        template <typename T>
+        bool Peek(T& a_value, size_t a_offset = 0) const
+        {
+            if (a_offset > _size - _pos || !Fits(a_offset + sizeof(T))) return false;
+            memcpy(&a_value,_data + _pos + a_offset,sizeof(T));
+            return true;
+        }
+
+        template <typename T>
+        bool Read(T& a_value)
+        {
+            if (!Peek(a_value)) return false;
+            _pos += sizeof(T);
+            return true;
+        }
+
+        //wstring = uint16 length + characters
+        bool ReadWString(std::string& a_value)
+        {
+            uint16_t loc_size = 0;
+            if (!Peek(loc_size) || !Fits(2 + static_cast<size_t>(loc_size))) return false;
+            a_value.assign(reinterpret_cast<const char*>(_data + _pos + 2),loc_size);
+            _pos += 2 + static_cast<size_t>(loc_size);
+            return true;
+        }
+
+        //copies next a_size bytes to new buffer
+        bool Copy(size_t a_size, std::shared_ptr<uint8_t[]>& a_data)
+        {
+            if (!Fits(a_size)) return false;
+            a_data = std::unique_ptr<uint8_t[]>(new uint8_t[a_size]);
+            memcpy(a_data.get(),_data + _pos,a_size);
+            _pos += a_size;
+            return true;
+        }
+    private:
+        const uint8_t*  _data;
+        size_t          _size;
+        size_t          _pos = 0;
+    };
+
+    //size of raw property value at reader position, including its length or count. Unknown types have no value
+    bool GetValueSize(const FieldReader& a_reader, uint8_t a_type, size_t& a_size)
+    {
+        uint16_t loc_wsize = 0;
+        uint32_t loc_count = 0;
+        switch(static_cast<Property::PropertyTypes>(a_type))
+        {
+            case Property::PropertyTypes::kObject:
+                a_size = 8;
+                return true;
+            case Property::PropertyTypes::kWString:
+                if (!a_reader.Peek(loc_wsize)) return false;
+                a_size = 2 + static_cast<size_t>(loc_wsize);
+                return true;
+            case Property::PropertyTypes::kInt:
+            case Property::PropertyTypes::kFloat:
+                a_size = 4;
+                return true;
+            case Property::PropertyTypes::kBool:
+                a_size = 1;
+                return true;
+            case Property::PropertyTypes::kArrayObject:
+                if (!a_reader.Peek(loc_count)) return false;
+                a_size = 4 + static_cast<size_t>(loc_count)*8;
+                return true;
+            case Property::PropertyTypes::kArrayWString:
+                //every string have its own length. Walk stops on first string which does not fit
+                if (!a_reader.Peek(loc_count)) return false;
+                a_size = 4;
+                for (uint32_t v = 0; v < loc_count; v++)
+                {
+                    if (!a_reader.Peek(loc_wsize,a_size)) return false;
+                    a_size += 2 + static_cast<size_t>(loc_wsize);
+                }
+                return true;
+            case Property::PropertyTypes::kArrayInt:
+            case Property::PropertyTypes::kArrayFloat:
+                if (!a_reader.Peek(loc_count)) return false;
+                a_size = 4 + static_cast<size_t>(loc_count)*4;
+                return true;
+            case Property::PropertyTypes::kArrayBool:
+                if (!a_reader.Peek(loc_count)) return false;
+                a_size = 4 + static_cast<size_t>(loc_count);
+                return true;
+        }
+        a_size = 0;
+        return true;
+    }
+
+    bool ReadProperty(FieldReader& a_reader, Property& a_property)
+    {
+        size_t loc_size = 0;
+        if (!a_reader.ReadWString(a_property.propertyName))  return false;
+        if (!a_reader.Read(a_property.propertyType))         return false;
+        if (!a_reader.Read(a_property.status))               return false;
+        if (!GetValueSize(a_reader,a_property.propertyType,loc_size)) return false;
+        return (loc_size == 0) || a_reader.Copy(loc_size,a_property.data);
+    }
+
+    bool ReadScript(FieldReader& a_reader, Script& a_script)
+    {
+        if (!a_reader.ReadWString(a_script.scriptName))  return false;
+        if (!a_reader.Read(a_script.status))             return false;
+        if (!a_reader.Read(a_script.propertyCount))      return false;
+        for (int p = 0; p < a_script.propertyCount; p++)
+        {
+            a_script.properties.push_back(std::unique_ptr<Property>(new Property()));
+            if (!ReadProperty(a_reader,*a_script.properties.back())) return false;
+        }
+        return true;
+    }
+}
+
+DeviceMod::DeviceMod(std::string a_name, uint8_t* a_data, size_t a_size, const FormResolver* a_resolver)
+{
+    size = a_size;
+    rawdata = a_data;
+    name = a_name;
+    size_t loc_fptr = 0x00000000;
+
+    static const size_t loc_headersize = (sizeof(DeviceGroup) - sizeof(uint8_t*));
+
+    //parse
+    while ((loc_fptr + loc_headersize) <= size)
+    {
+        DeviceGroup loc_tmp;
+
+        memcpy(&loc_tmp,&rawdata[loc_fptr],loc_headersize);
+        loc_fptr += loc_headersize; //move file pointer
+
+        //soo, it looks like that the uesp wiki was lying. The data size is actually correct size of data without header. 
+        //And it is different for TES4 and other groups...
+        const bool   loc_tes4       = std::string(loc_tmp.grup,loc_tmp.grup + 4*sizeof(uint8_t)) == "TES4";
+        const size_t loc_datasize   = loc_tes4 ? loc_tmp.size : static_cast<size_t>(loc_tmp.size) - loc_headersize;
+
+        //truncated or corrupted file - stop instead of reading out of buffer
+        if ((!loc_tes4 && loc_tmp.size < loc_headersize) || loc_datasize > size - loc_fptr)
+        {
+            ERROR("DeviceMod - Mod {} is corrupted at offset 0x{:X}. Rest of the file is skipped",name,loc_fptr - loc_headersize)
+            break;
+        }
+
+        if (loc_tes4)
+        {
+            group_TES4      = loc_tmp;
+            group_TES4.data = new uint8_t[loc_datasize];
+            memcpy(group_TES4.data,&rawdata[loc_fptr],loc_datasize);
+        }
+        else if (std::string(loc_tmp.grup,loc_tmp.grup + 4*sizeof(uint8_t)) == "GRUP" && std::string(loc_tmp.label,loc_tmp.label + 4*sizeof(uint8_t)) == "ARMO")
+        {
+            group_ARMO      = loc_tmp;
+            group_ARMO.data = new uint8_t[loc_datasize];
+            memcpy(group_ARMO.data,&rawdata[loc_fptr],loc_datasize);
+        } 
+        loc_fptr += loc_datasize; //record data read, move pointer
+    }
+
+    ParseInfo();
+    ParseDevices(a_resolver);
+}
+
+void DeviceMod::ParseInfo()
+{
+    masters.clear();
+
+    size_t loc_fptr = 0x00000000;
+    while ((loc_fptr + sizeof(FieldHeader)) <= (group_TES4.size))
+    {
+        FieldHeader loc_field;
+
+        memcpy(&loc_field,&group_TES4.data[loc_fptr],sizeof(FieldHeader));
+        loc_fptr += sizeof(FieldHeader); //move file pointer
+
+        const size_t loc_datasize = loc_field.size;
+        if (loc_datasize > group_TES4.size - loc_fptr)
+        {
+            ERROR("DeviceMod::ParseInfo - Header of mod {} is truncated. Rest of the header is skipped",name)
+            break;
+        }
+
+        std::string loc_signature = std::string(loc_field.type,loc_field.type + 4*sizeof(uint8_t));
+        if (loc_signature == "MAST")
+        {
+            if (loc_datasize > 0)
+            {
+                std::string loc_master = std::string(&group_TES4.data[loc_fptr],&group_TES4.data[loc_fptr + loc_datasize - 1]);
+                masters.push_back(loc_master);
+            }
+        }
+        loc_fptr += loc_datasize; //field data read, move pointer
+    }
+    masters.push_back(name);
+
+    DEBUG("=== Final masters of mod {}",name)
+    for (int i = 0; i < masters.size();i++)
+    {
+        DEBUG("{:02X} = {}",i,masters[i])
+    }
+}
+
+size_t DeviceMod::ParseDevices(const FormResolver* a_resolver)
+{
+    size_t loc_fptr     = 0x00000000;
+    size_t loc_res      = 0;
+
+    static const size_t loc_headersize = (sizeof(DeviceRecord) - sizeof(uint8_t*));
+    static const size_t loc_groupheadersize = (sizeof(DeviceGroup) - sizeof(uint8_t*));
+
+    //group size includes its header, which is not part of data
+    const size_t loc_groupsize = (group_ARMO.size > loc_groupheadersize) ? group_ARMO.size - loc_groupheadersize : 0;
+
+    while ((loc_fptr + loc_headersize) <= loc_groupsize)
+    {
+        uint32_t loc_recordsize = 0;
+        memcpy(&loc_recordsize,&group_ARMO.data[loc_fptr + 4],sizeof(uint32_t));
+        if (loc_recordsize > loc_groupsize - loc_fptr - loc_headersize)
+        {
+            ERROR("DeviceMod::ParseDevices - Record at offset 0x{:X} of mod {} is truncated. Rest of the group is skipped",loc_fptr,name)
+            break;
+        }
+
+        devicerecords.push_back(std::shared_ptr<DeviceHandle>(new DeviceHandle));
+
+        memcpy(&devicerecords.back()->record,&group_ARMO.data[loc_fptr],loc_headersize);
+        loc_fptr += loc_headersize; //move file pointer
+
+        const size_t loc_datasize = devicerecords.back()->record.size;
+        devicerecords.back()->record.data = new uint8_t[loc_datasize];
+
+        memcpy(devicerecords.back()->record.data,&group_ARMO.data[loc_fptr],loc_datasize);
+        loc_fptr += loc_datasize; //field data read, move pointer
+
+        const uint32_t loc_formID = devicerecords.back()->record.formId;
+        const uint8_t  loc_modindex = (loc_formID & 0xFF000000) >> 24;
+        const std::string loc_modsource = masters[loc_modindex < masters.size() ? loc_modindex : masters.size() - 1];
+
+        devicerecords.back()->source = loc_modsource;
+        devicerecords.back()->mod    = this;
+
+        //data of compressed record is zlib stream, which would be read as garbage fields. Device is kept, but without scripts and keywords
+        if (devicerecords.back()->record.flags & DeviceRecord::fCompressed)
+        {
+            ERROR("DeviceMod::ParseDevices - Form 0x{:08X} of mod {} is compressed, and can't be read. Save mod without compression",loc_formID,name)
+        }
+        else if (a_resolver == nullptr || a_resolver->HasForm(0x00FFFFFF & loc_formID,loc_modsource))
+        {
+            //malformed device is kept same as compressed one, without scripts and keywords
+            if (!devicerecords.back()->LoadVM() || !devicerecords.back()->LoadKeywords())
+            {
+                ERROR("DeviceMod::ParseDevices - Form 0x{:08X} of mod {} has malformed scripts or keywords, and can't be read",loc_formID,name)
+                devicerecords.back()->scripts   = ScriptHandle();
+                devicerecords.back()->keywords  = KeywordsHandle();
+            }
+        }
+        //else LOG("Could not find Form !!!")
+
+        loc_res++;
+    }
+
+    return loc_res;
+}
+
+bool DeviceHandle::LoadVM()
+{
+    size_t   loc_fptr       = 0x00000000;
+    uint32_t loc_nextsize   = 0;    //size of field larger than 64 KB, stored in XXXX field before it
+    while ((loc_fptr + sizeof(FieldHeader)) <= (record.size))
+    {
+        FieldHeader loc_field;
+        memcpy(&loc_field,&record.data[loc_fptr],sizeof(FieldHeader));
+        loc_fptr += sizeof(FieldHeader); //move file pointer
+
+        const size_t loc_datasize = (loc_nextsize > 0) ? loc_nextsize : loc_field.size;
+        loc_nextsize = 0;
+        std::string loc_signature = std::string(loc_field.type,loc_field.type + 4*sizeof(uint8_t));
+        if (loc_signature == "XXXX")
+        {
+            if (loc_datasize < sizeof(uint32_t) || record.size - loc_fptr < sizeof(uint32_t)) return false;
+            memcpy(&loc_nextsize,&record.data[loc_fptr],sizeof(uint32_t));
+        }
+        else if (loc_signature == "EDID") //editor ID is stored before VMAD, so it is read in the same pass
+        {
+            const char* loc_edid = reinterpret_cast<const char*>(&record.data[loc_fptr]);
+            editorID = std::string(loc_edid,strnlen(loc_edid,std::min<size_t>(loc_datasize,record.size - loc_fptr)));
+        }
+        else if (loc_signature == "VMAD")
+        {
+            //every value is checked to fit to the field before it is read
+            if (loc_datasize > record.size - loc_fptr) return false;
+            FieldReader loc_reader(&record.data[loc_fptr],loc_datasize);
+            if (!loc_reader.Read(scripts.version) || !loc_reader.Read(scripts.objFormat) || !loc_reader.Read(scripts.scriptCount)) return false;
+            for (int i = 0; i < scripts.scriptCount; i++)
+            {
+                scripts.scripts.push_back(std::unique_ptr<Script>(new Script()));
+                if (!ReadScript(loc_reader,*scripts.scripts.back())) return false;
+            }
+            return true;
+        }
+        loc_fptr += loc_datasize; //field data read, move pointer
+    }
+    return true;
+}
+
+bool DeviousDevices::DeviceHandle::LoadKeywords()
+{
+    size_t loc_fptr = 0x00000000;
+    while ((loc_fptr + sizeof(FieldHeader)) <= (record.size))
+    {
+        FieldHeader loc_field;
+        memcpy(&loc_field,&record.data[loc_fptr],sizeof(FieldHeader));
+        loc_fptr += sizeof(FieldHeader); //move file pointer
+
+        const size_t loc_datasize = loc_field.size;
+        std::string loc_signature = std::string(loc_field.type,loc_field.type + 4*sizeof(uint8_t));
+        if (loc_signature == "KSIZ") //we only care about KSIZ
+        {
+            if (loc_datasize < sizeof(uint32_t) || record.size - loc_fptr < sizeof(uint32_t)) return false;
+            keywords.ksiz.header = loc_field;
+            memcpy(&keywords.ksiz.keywordcount,&record.data[loc_fptr],sizeof(uint32_t));
+        }  
+        else if (loc_signature == "KWDA")   
+        {
+            keywords.kwda.header = loc_field;
+            //KWDA size is not trusted, as it could be different from KSIZ count in broken mods
+            keywords.ksiz.keywordcount = std::min<uint32_t>(keywords.ksiz.keywordcount,static_cast<uint32_t>(std::min<size_t>(loc_datasize,record.size - loc_fptr)/sizeof(uint32_t)));
+            keywords.kwda.data = std::shared_ptr<uint32_t[]>(new uint32_t[keywords.ksiz.keywordcount]);  //1 kw = uint32_t
+            memcpy(keywords.kwda.data.get(),&record.data[loc_fptr],keywords.ksiz.keywordcount*sizeof(uint32_t));
+            break; //break loop after KWDA as we don't need any more fields
+        }
+
+        loc_fptr += loc_datasize; //field data read, move pointer
+    }
+    return true;
+}
+
+std::pair<std::shared_ptr<uint8_t[]>, uint8_t> DeviousDevices::DeviceHandle::GetPropertyRaw(std::string a_name) const
+{
+    const Property* loc_property = FindProperty(a_name);
+    if (loc_property != nullptr) return {loc_property->data, loc_property->propertyType};
+    return {nullptr,0};
+}
+
+const DeviousDevices::Property* DeviousDevices::DeviceHandle::FindProperty(std::string_view a_name) const
+{
+    //compared in lower case, without making lower case copies of names
+    auto loc_equal = [](char a_1, char a_2)
+    {
+        return ::tolower(static_cast<unsigned char>(a_1)) == ::tolower(static_cast<unsigned char>(a_2));
+    };
+
+    for (auto && it1 : scripts.scripts)
+    {
+        for (auto && it2 : it1->properties)
+        {
+            const std::string& loc_propertyname = it2->propertyName;
+            if (loc_propertyname.size() == a_name.size() && std::equal(a_name.begin(),a_name.end(),loc_propertyname.begin(),loc_equal))
+            {
+                return it2.get();
+            }
+        }
+    }
+    return nullptr;
+}
+
+namespace
+{
+    //matches all names in one pass over device properties, instead of searching whole device for every name.
+    //If multiple properties have same name, first one is used (same as FindProperty)
+    std::vector<const Property*> FindProperties(const DeviceHandle& a_handle, const std::vector<std::string>& a_names)
+    {
+        std::string loc_name;
+        auto loc_lower = [&loc_name](std::string_view a_name) -> const std::string&
+        {
+            loc_name.assign(a_name);
+            std::transform(loc_name.begin(),loc_name.end(),loc_name.begin(),[](unsigned char a_char){ return static_cast<char>(::tolower(a_char)); });
+            return loc_name;
+        };
+
+        std::unordered_map<std::string,const Property*> loc_found;
+        std::vector<const Property**> loc_slots(a_names.size());
+        loc_found.reserve(a_names.size());
+        for (size_t i = 0; i < a_names.size(); i++) loc_slots[i] = &loc_found.try_emplace(loc_lower(a_names[i]),nullptr).first->second;
+
+        for (auto && it1 : a_handle.scripts.scripts)
+        {
+            for (auto && it2 : it1->properties)
+            {
+                const auto loc_it = loc_found.find(loc_lower(it2->propertyName));
+                if (loc_it != loc_found.end() && loc_it->second == nullptr) loc_it->second = it2.get();
+            }
+        }
+
+        std::vector<const Property*> loc_res(a_names.size());
+        for (size_t i = 0; i < a_names.size(); i++) loc_res[i] = *loc_slots[i];
+        return loc_res;
+    }
+
+    //nothing is logged, so whole device can be read in one call
+    template <typename T, typename F>
+    std::vector<T> GetProperties(const DeviceHandle& a_handle, const std::vector<std::string>& a_names, const std::vector<T>& a_defvalues, Property::PropertyTypes a_type, F a_read)
+    {
+        const std::vector<const Property*> loc_properties = FindProperties(a_handle,a_names);
+        std::vector<T> loc_res;
+        loc_res.reserve(a_names.size());
+        for (size_t i = 0; i < a_names.size(); i++)
+        {
+            const Property* loc_property = loc_properties[i];
+            if (loc_property == nullptr || loc_property->data == nullptr)       loc_res.push_back(i < a_defvalues.size() ? a_defvalues[i] : T());
+            else if (loc_property->propertyType != static_cast<uint8_t>(a_type)) loc_res.push_back(T());
+            else loc_res.push_back(a_read(loc_property->data.get()));
+        }
+        return loc_res;
+    }
+}
+
+std::vector<uint32_t> DeviousDevices::DeviceHandle::GetPropertiesOBJ(const std::vector<std::string>& a_names, const std::vector<uint32_t>& a_defvalues) const
+{
+    return GetProperties<uint32_t>(*this,a_names,a_defvalues,Property::PropertyTypes::kObject,[](const uint8_t* a_data)
+    {
+        return *reinterpret_cast<const uint32_t*>(a_data + 4U);
+    });
+}
+
+std::vector<int32_t> DeviousDevices::DeviceHandle::GetPropertiesINT(const std::vector<std::string>& a_names, const std::vector<int32_t>& a_defvalues) const
+{
+    return GetProperties<int32_t>(*this,a_names,a_defvalues,Property::PropertyTypes::kInt,[](const uint8_t* a_data)
+    {
+        return *reinterpret_cast<const int32_t*>(a_data);
+    });
+}
+
+std::vector<float> DeviousDevices::DeviceHandle::GetPropertiesFLT(const std::vector<std::string>& a_names, const std::vector<float>& a_defvalues) const
+{
+    return GetProperties<float>(*this,a_names,a_defvalues,Property::PropertyTypes::kFloat,[](const uint8_t* a_data)
+    {
+        return *reinterpret_cast<const float*>(a_data);
+    });
+}
+
+std::vector<bool> DeviousDevices::DeviceHandle::GetPropertiesBOL(const std::vector<std::string>& a_names, const std::vector<bool>& a_defvalues) const
+{
+    return GetProperties<bool>(*this,a_names,a_defvalues,Property::PropertyTypes::kBool,[](const uint8_t* a_data)
+    {
+        return *reinterpret_cast<const bool*>(a_data);
+    });
+}
+
+std::vector<std::string> DeviousDevices::DeviceHandle::GetPropertiesSTR(const std::vector<std::string>& a_names, const std::vector<std::string>& a_defvalues) const
+{
+    return GetProperties<std::string>(*this,a_names,a_defvalues,Property::PropertyTypes::kWString,[](const uint8_t* a_data)
+    {
+        const uint16_t loc_wsize = *reinterpret_cast<const uint16_t*>(a_data);
+        return std::string(a_data + 2, a_data + 2 + loc_wsize); //convert wstring to zstring
+    });
+}
+
+uint32_t DeviceHandle::GetPropertyOBJ(std::string a_name, uint32_t a_defvalue, bool a_silence) const 
+{
+    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
+    if (loc_data != nullptr)
+    {
+        if (loc_type == (uint8_t)Property::PropertyTypes::kObject)
+        {
+            //LOG("GetPropertyOBJ: Raw Data = {:08X}", *(uint64_t*)loc_property.first.get())
+            return *reinterpret_cast<uint32_t*>(loc_data.get() + 4U);
+        }
+        else
+        {
+            if (!a_silence) ERROR("DeviceHandle::GetPropertyOBJ({},{},{}) - Property is of incorrect type. Type = {}", a_name,a_defvalue,a_silence,loc_type)
+            return 0x00000000;
+        }
+    }
+    else
+    {
+        LOG("DeviceHandle::GetPropertyOBJ({},{},{}): Property not found", a_name,a_defvalue,a_silence)
+        return a_defvalue;
+    }
+}
+
+int32_t DeviceHandle::GetPropertyINT(std::string a_name, int32_t a_defvalue) const
+{
+    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
+    if (loc_data != nullptr)
+    {
+        if (loc_type == (uint8_t)Property::PropertyTypes::kInt)
+        {
+            return *reinterpret_cast<int32_t*>(loc_data.get());
+        }
+        else
+        {
+            ERROR("DeviceHandle::GetPropertyINT({},{}) - Property is of incorrect type. Type = {}", a_name,a_defvalue,loc_type)
+            return 0x00000000;
+        }
+    }
+    else
+    {
+        WARN("DeviceHandle::GetPropertyINT({},{}): Property not found", a_name,a_defvalue)
+        return a_defvalue;
+    }
+}
+
+float DeviceHandle::GetPropertyFLT(std::string a_name, float a_defvalue) const
+{
+    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
+    if (loc_data != nullptr)
+    {
+        if (loc_type == (uint8_t)Property::PropertyTypes::kFloat)
+        {
+            return *reinterpret_cast<float*>(loc_data.get());
+        }
+        else
+        {
+            ERROR("DeviceHandle::GetPropertyFLT({},{}) - Property is of incorrect type. Type = {}", a_name,a_defvalue,loc_type)
+            return 0.0f;
+        }
+    }
+    else
+    {
+        WARN("DeviceHandle::GetPropertyFLT({},{}): Property not found", a_name,a_defvalue)
+        return a_defvalue;
+    }
+}
+
+bool DeviceHandle::GetPropertyBOL(std::string a_name, bool a_defvalue) const
+{
+    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
+    if (loc_data != nullptr)
+    {
+        if (loc_type == (uint8_t)Property::PropertyTypes::kBool)
+        {
+            return *reinterpret_cast<bool*>(loc_data.get());
+        }
+        else
+        {
+            ERROR("DeviceHandle::GetPropertyBOL({},{}) - Property is of incorrect type. Type = {}", a_name,a_defvalue,loc_type)
+            return false;
+        }
+    }
+    else
+    {
+        WARN("DeviceHandle::GetPropertyBOL({},{}): Property not found", a_name,a_defvalue)
+        return a_defvalue;
+    }
+}
+
+std::string DeviousDevices::DeviceHandle::GetPropertySTR(std::string a_name, std::string a_defvalue) const
+{
+    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
+    if (loc_data != nullptr)
+    {
+        if (loc_type == (uint8_t)Property::PropertyTypes::kWString)
+        {
+            uint16_t loc_wsize = *reinterpret_cast<uint16_t*>(loc_data.get());
+            std::string loc_res = std::string(loc_data.get() + 2, loc_data.get() + 2 + loc_wsize); //convert wstring to zstring
+            return loc_res;
+        }
+        else
+        {
+            ERROR("DeviceHandle::GetPropertySTR({},{}) - Property is of incorrect type. Type = {}", a_name,a_defvalue,loc_type)
+            return "";
+        }
+    }
+    else
+    {
+        WARN("DeviceHandle::GetPropertySTR({},{}): Property not found", a_name,a_defvalue)
+        return a_defvalue;
+    }
+}
+
+std::vector<uint32_t> DeviousDevices::DeviceHandle::GetPropertyOBJA(std::string a_name) const
+{
+    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
+    if (loc_data != nullptr)
+    {
+        if (loc_type == (uint8_t)Property::PropertyTypes::kArrayObject)
+        {
+            std::vector<uint32_t> loc_res;
+            uint32_t loc_fptr = 0x00000000;
+            const uint32_t loc_arraysize = *reinterpret_cast<uint32_t*>(&loc_data.get()[loc_fptr]);
+            loc_fptr += 4;
+
+            struct PropertyObject
+            {
+                uint16_t unk1;
+                uint16_t alias;
+                uint32_t formId;
+            };
+
+            for (size_t i = 0; i < loc_arraysize; i++)
+            {
+                  PropertyObject loc_object = *reinterpret_cast<PropertyObject*>(&loc_data.get()[loc_fptr]);
+                  loc_res.push_back(loc_object.formId);
+                  loc_fptr += sizeof(PropertyObject);
+            }
+
+            return loc_res;
+        }
+        else
+        {
+            return std::vector<uint32_t>();
+        }
+    }
+    else
+    {
+        return std::vector<uint32_t>();
+    }
+}
+
+std::vector<int32_t> DeviousDevices::DeviceHandle::GetPropertyINTA(std::string a_name) const
+{
+    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
+    if (loc_data != nullptr)
+    {
+        if (loc_type == (uint8_t)Property::PropertyTypes::kArrayInt)
+        {
+            std::vector<int32_t> loc_res;
+            uint32_t loc_fptr = 0x00000000;
+            const uint32_t loc_arraysize = *reinterpret_cast<uint32_t*>(&loc_data.get()[loc_fptr]);
+            loc_fptr += 4;
+
+            for (size_t i = 0; i < loc_arraysize; i++)
+            {
+                  int32_t loc_val = *reinterpret_cast<int32_t*>(&loc_data.get()[loc_fptr]);
+                  loc_res.push_back(loc_val);
+                  loc_fptr += sizeof(int32_t);
+            }
+
+            return loc_res;
+        }
+        else
+        {
+            return std::vector<int32_t>();
+        }
+    }
+    else
+    {
+        return std::vector<int32_t>();
+    }
+}
+
+std::vector<float> DeviousDevices::DeviceHandle::GetPropertyFLTA(std::string a_name) const
+{
+    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
+    if (loc_data != nullptr)
+    {
+        if (loc_type == (uint8_t)Property::PropertyTypes::kArrayFloat)
+        {
+            std::vector<float> loc_res;
+            uint32_t loc_fptr = 0x00000000;
+            const uint32_t loc_arraysize = *reinterpret_cast<uint32_t*>(&loc_data.get()[loc_fptr]);
+            loc_fptr += 4;
+
+            for (size_t i = 0; i < loc_arraysize; i++)
+            {
+                  float loc_val = *reinterpret_cast<float*>(&loc_data.get()[loc_fptr]);
+                  loc_res.push_back(loc_val);
+                  loc_fptr += sizeof(float);
+            }
+
+            return loc_res;
+        }
+        else
+        {
+            return std::vector<float>();
+        }
+    }
+    else
+    {
+        return std::vector<float>();
+    }
+}
+
+std::vector<bool> DeviousDevices::DeviceHandle::GetPropertyBOLA(std::string a_name) const
+{
+    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
+    if (loc_data != nullptr)
+    {
+        if (loc_type == (uint8_t)Property::PropertyTypes::kArrayBool)
+        {
+            std::vector<bool> loc_res;
+            uint32_t loc_fptr = 0x00000000;
+            const uint32_t loc_arraysize = *reinterpret_cast<uint32_t*>(&loc_data.get()[loc_fptr]);
+            loc_fptr += 4;
+
+            for (size_t i = 0; i < loc_arraysize; i++)
+            {
+                  bool loc_val = loc_data.get()[loc_fptr] != 0;
+                  loc_res.push_back(loc_val);
+                  loc_fptr += sizeof(bool);
+            }
+
+            return loc_res;
+        }
+        else
+        {
+            return std::vector<bool>();
+        }
+    }
+    else
+    {
+        return std::vector<bool>();
+    }
+}
+
+std::vector<std::string> DeviousDevices::DeviceHandle::GetPropertySTRA(std::string a_name) const
+{
+    const auto [loc_dataptr,loc_type] = GetPropertyRaw(a_name);
+    if (loc_dataptr != nullptr)
+    {
+        if (loc_type == (uint8_t)Property::PropertyTypes::kArrayWString)
+        {
+            std::vector<std::string> loc_res;
+            uint8_t* loc_data = loc_dataptr.get();
+
+            uint32_t loc_fptr = 0x00000000;
+            const uint32_t loc_arraysize = *reinterpret_cast<uint32_t*>(&loc_data[loc_fptr]);
+            loc_fptr += 4;
+
+            for (size_t i = 0; i < loc_arraysize; i++)
+            {
+                const uint16_t loc_wsize = *reinterpret_cast<uint16_t*>(&loc_data[loc_fptr]);
+                const std::string loc_val = std::string(&loc_data[loc_fptr] + 2, &loc_data[loc_fptr] + 2 + loc_wsize); //convert wstring to zstring
+                loc_res.push_back(loc_val);
+                loc_fptr += 2 + loc_wsize;
+            }
+
+            return loc_res;
+        }
+        else
+        {
+            return std::vector<std::string>();
+        }
+    }
+    else
+    {
+        return std::vector<std::string>();
+    }
+}
+
+const std::string& DeviceMod::GetSource(const uint32_t a_formID) const
+{
+    const uint8_t loc_modindex = (a_formID & 0xFF000000) >> 24;
+    return masters[loc_modindex >= masters.size() ? masters.size() - 1 : loc_modindex];
+}
+
+DeviceHistory::DeviceHistory(std::vector<Version> a_versions) : _versions(std::move(a_versions))
+{
+    std::stable_sort(_versions.begin(),_versions.end(),[](const Version& a_1, const Version& a_2){ return a_1.modIndex < a_2.modIndex; });
+
+    _modNames.reserve(_versions.size());
+    for (auto&& it : _versions) _modNames.push_back((it.handle && it.handle->mod) ? it.handle->mod->name : std::string());
+}
+
+const DeviceHandle* DeviceHistory::GetVersion(int a_version) const
+{
+    const int64_t loc_index = (a_version < 0) ? static_cast<int64_t>(_versions.size()) + a_version : a_version;
+    if (loc_index < 0 || loc_index >= static_cast<int64_t>(_versions.size())) return nullptr;
+    return _versions[static_cast<size_t>(loc_index)].handle.get();
+}
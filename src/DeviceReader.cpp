@@ -6,6 +6,18 @@ using namespace DeviousDevices;
 
 SINGLETONBODY(DeviceReader)
 
+namespace
+{
+    class GameFormResolver : public FormResolver
+    {
+    public:
+        bool HasForm(uint32_t a_formID, const std::string& a_mod) const override
+        {
+            return RE::TESDataHandler::GetSingleton()->LookupForm(a_formID,a_mod) != nullptr;
+        }
+    };
+}
+
 void DeviceReader::Setup()
 {
     if (!_installed)
@@ -16,20 +28,31 @@ void DeviceReader::Setup()
 
         _alwaysSilent = handler->LookupForm<RE::BGSListForm>(0x08A209, "Devious Devices - Integration.esm");
 
-        LoadDDMods();
-        ParseMods();
-        LoadDB();
+        {
+            DD_TRACE_SCOPE("LoadDDMods")
+            LoadDDMods();
+        }
+        {
+            DD_TRACE_SCOPE("ParseMods")
+            ParseMods();
+        }
+        {
+            DD_TRACE_SCOPE("LoadDB")
+            LoadDB();
+        }
         _installed = true; // to prevent db reset on game reload
     }
 }
 
 RE::TESObjectARMO* DeviceReader::GetDeviceRender(RE::TESObjectARMO* a_invdevice)
 {
+    DD_PROFILE_SCOPE(pDeviceReader)
     return _database[a_invdevice].deviceRendered;
 }
 
 RE::TESObjectARMO* DeviousDevices::DeviceReader::GetDeviceInventory(RE::TESObjectARMO* a_renddevice)
 {
+    DD_PROFILE_SCOPE(pDeviceReader)
     //RE::TESObjectARMO* loc_res;
     const auto loc_res = std::find_if(_database.begin(),_database.end(),[&](std::pair<RE::TESObjectARMO * const, DeviceUnit> &p)
     {
@@ -107,7 +130,8 @@ void DeviceReader::ParseMods()
             uint8_t* loc_rawdata = new uint8_t[loc_size];
             loc_file.read(reinterpret_cast<char *>(loc_rawdata),loc_size);
             loc_file.close();
-            _ddmodspars.push_back(std::shared_ptr<DeviceMod>(new DeviceMod(std::string(it->GetFilename()),loc_rawdata,loc_size)));
+            static const GameFormResolver loc_resolver;
+            _ddmodspars.push_back(std::shared_ptr<DeviceMod>(new DeviceMod(std::string(it->GetFilename()),loc_rawdata,loc_size,&loc_resolver)));
         }
         else ERROR("Failed to open file {}",it->GetFilename())
     }
@@ -115,6 +139,7 @@ void DeviceReader::ParseMods()
 
 DeviceReader::DeviceUnit DeviceReader::GetDeviceUnit(RE::TESObjectARMO* a_device, int a_mode)
 {
+    DD_PROFILE_SCOPE(pDeviceReader)
     if (a_device == nullptr) 
     {
         ERROR("GetDeviceUnit: Could not identify device");
@@ -143,43 +168,92 @@ DeviceReader::DeviceUnit DeviceReader::GetDeviceUnit(RE::TESObjectARMO* a_device
 
 DeviousDevices::DeviceReader::DeviceUnit DeviousDevices::DeviceReader::GetDeviceUnit(std::string a_name)
 {
-    for (auto&& it : _database)
+    DD_PROFILE_SCOPE(pDeviceReader)
+    const auto loc_device = _nameIndex.FindExact(a_name);
+    if (loc_device.has_value())
     {
-        if (it.first->GetName() == a_name) return it.second;
+        const auto loc_unit = _database.find(loc_device.value());
+        if (loc_unit != _database.end()) return loc_unit->second;
     }
     return DeviceUnit();
 }
 
+RE::TESObjectARMO* DeviousDevices::DeviceReader::FindDeviceByName(std::string_view a_name) const
+{
+    DD_PROFILE_SCOPE(pDeviceReader)
+    auto loc_device = _nameIndex.FindExact(a_name);
+    if (!loc_device.has_value()) loc_device = _nameIndex.FindNoCase(a_name);
+    return loc_device.value_or(nullptr);
+}
+
+std::vector<RE::TESObjectARMO*> DeviousDevices::DeviceReader::SearchDevices(std::string_view a_text, bool a_substring, size_t a_max) const
+{
+    DD_PROFILE_SCOPE(pDeviceReader)
+    return a_substring ? _nameIndex.FindSubstring(a_text,a_max) : _nameIndex.FindPrefix(a_text,a_max);
+}
+
 template<typename T>
-T* DeviousDevices::DeviceHandle::GetFormFromHandle(const RE::FormID& a_formid) const
+T* DeviousDevices::DeviceHandle::GetFormFromHandle(const uint32_t& a_formid) const
 {
-    const uint8_t loc_modindex = (a_formid & 0xFF000000) >> 24;
-    const std::string loc_modsource = mod->masters[loc_modindex >= mod->masters.size() ? mod->masters.size() - 1 : loc_modindex];
-    return reinterpret_cast<T*>(RE::TESDataHandler::GetSingleton()->LookupForm(0x00FFFFFF & a_formid, loc_modsource));
+    return reinterpret_cast<T*>(RE::TESDataHandler::GetSingleton()->LookupForm(0x00FFFFFF & a_formid, mod->GetSource(a_formid)));
 }
 
-template <typename T>
-T* DeviousDevices::DeviceReader::GetPropertyForm(RE::TESObjectARMO* a_invdevice, std::string a_propertyname,uint32_t a_defvalue, int a_mode) const
+DeviousDevices::DeviceReader::ResolvedForm DeviousDevices::DeviceReader::ResolveForm(const DeviceHandle* a_handle, const std::string& a_propertyname) const
 {
-    const auto loc_unit = DeviceReader::GetSingleton()->GetDeviceUnit(a_invdevice);
-    auto loc_handle = (a_mode == 0) ? loc_unit.deviceHandle : loc_unit.history.front().deviceHandle;
+    if (a_handle == nullptr) return ResolvedForm();
+
+    return _formCache.Get(a_handle,a_propertyname,[&]
+    {
+        ResolvedForm loc_res;
+        const Property* loc_property = a_handle->FindProperty(a_propertyname);
+        if (loc_property == nullptr || loc_property->data == nullptr) return loc_res;
 
-    if (loc_handle != nullptr) {
-        const uint32_t loc_formID = loc_handle->GetPropertyOBJ(a_propertyname,a_defvalue, true);
+        loc_res.found = true;
+        if (loc_property->propertyType != static_cast<uint8_t>(Property::PropertyTypes::kObject)) return loc_res;
 
         // we need to convert it to correct ID and get the form
-        if (loc_formID > 0) {
+        const uint32_t loc_formID = *reinterpret_cast<const uint32_t*>(loc_property->data.get() + 4U);
+        if (loc_formID > 0)
+        {
             //every mod iteration can use different masters, and so also the formIDs will be different
             //because of that, the source have to be selected
-            T* loc_form = loc_handle->GetFormFromHandle<T>(loc_formID);
-            if (loc_form != nullptr) {
-                //LOG("GetPropertyForm({} 0x{:08X} , {}) called - Result = {:X}",a_invdevice->GetName(),a_invdevice->GetFormID(),a_propertyname,loc_form->GetFormID())
-                return loc_form;
-            } else
-                ERROR("!!!Form 0x{:08X} not found!!! a_invdevice={}, a_propertyname={}, a_mode={}", loc_formID,a_invdevice->GetName(),a_propertyname,a_mode)
+            loc_res.form = a_handle->GetFormFromHandle<RE::TESForm>(loc_formID);
+            if (loc_res.form == nullptr) ERROR("!!!Form 0x{:08X} not found!!! device=0x{:08X}, source={}, a_propertyname={}",loc_formID,a_handle->record.formId,a_handle->source,a_propertyname)
         }
-    }
-    return nullptr;
+        return loc_res;
+    });
+}
+
+std::vector<RE::TESForm*> DeviousDevices::DeviceReader::ResolveFormArray(const DeviceHandle* a_handle, const std::string& a_propertyname) const
+{
+    if (a_handle == nullptr) return std::vector<RE::TESForm*>();
+
+    return _formArrayCache.Get(a_handle,a_propertyname,[&]
+    {
+        std::vector<RE::TESForm*> loc_res;
+        for (auto&& it : a_handle->GetPropertyOBJA(a_propertyname))
+        {
+            loc_res.push_back((it > 0) ? a_handle->GetFormFromHandle<RE::TESForm>(it) : nullptr);
+        }
+
+        if (!loc_res.empty())
+        {
+            LOG("ResolveFormArray(0x{:08X} , {}) - Result:",a_handle->record.formId,a_propertyname)
+            for (auto&& it : loc_res) LOG("\t0x{:08X} - {}",it ? it->GetFormID() : 0U,it ? it->GetName() : "NONE")
+        }
+        return loc_res;
+    });
+}
+
+template <typename T>
+T* DeviousDevices::DeviceReader::GetPropertyForm(RE::TESObjectARMO* a_invdevice, std::string a_propertyname,uint32_t a_defvalue, int a_mode) const
+{
+    DD_PROFILE_SCOPE(pDeviceReader)
+    const ResolvedForm loc_res = ResolveForm(GetDeviceHandle(a_invdevice,a_mode),a_propertyname);
+    if (loc_res.found) return static_cast<T*>(loc_res.form);
+
+    //default value is runtime form id, so it is not resolved through device masters
+    return (a_defvalue > 0) ? RE::TESForm::LookupByID<T>(a_defvalue) : nullptr;
 }
 
 RE::TESForm* DeviousDevices::DeviceReader::GetPropertyForm(RE::TESObjectARMO* a_invdevice, std::string a_propertyname, RE::TESForm* a_defvalue, int a_mode = 0) const
@@ -190,8 +264,8 @@ RE::TESForm* DeviousDevices::DeviceReader::GetPropertyForm(RE::TESObjectARMO* a_
 
 int DeviousDevices::DeviceReader::GetPropertyInt(RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_defvalue, int a_mode) const
 {
-    const auto loc_unit   = DeviceReader::GetSingleton()->GetDeviceUnit(a_invdevice);
-    const auto loc_handle = (a_mode == 0) ? loc_unit.deviceHandle : loc_unit.history.front().deviceHandle;
+    DD_PROFILE_SCOPE(pDeviceReader)
+    const DeviceHandle* loc_handle = GetDeviceHandle(a_invdevice,a_mode);
     
     if (loc_handle != nullptr)
     {
@@ -204,8 +278,8 @@ int DeviousDevices::DeviceReader::GetPropertyInt(RE::TESObjectARMO* a_invdevice,
 
 float DeviousDevices::DeviceReader::GetPropertyFloat(RE::TESObjectARMO* a_invdevice, std::string a_propertyname, float a_defvalue, int a_mode) const
 {
-    auto loc_unit   = DeviceReader::GetSingleton()->GetDeviceUnit(a_invdevice);
-    auto loc_handle = (a_mode == 0) ? loc_unit.deviceHandle : loc_unit.history.front().deviceHandle;
+    DD_PROFILE_SCOPE(pDeviceReader)
+    const DeviceHandle* loc_handle = GetDeviceHandle(a_invdevice,a_mode);
     
     if (loc_handle != nullptr)
     {
@@ -218,8 +292,8 @@ float DeviousDevices::DeviceReader::GetPropertyFloat(RE::TESObjectARMO* a_invdev
 
 bool DeviousDevices::DeviceReader::GetPropertyBool(RE::TESObjectARMO* a_invdevice, std::string a_propertyname, bool a_defvalue, int a_mode) const
 {
-    auto loc_unit   = DeviceReader::GetSingleton()->GetDeviceUnit(a_invdevice);
-    auto loc_handle = (a_mode == 0) ? loc_unit.deviceHandle : loc_unit.history.front().deviceHandle;
+    DD_PROFILE_SCOPE(pDeviceReader)
+    const DeviceHandle* loc_handle = GetDeviceHandle(a_invdevice,a_mode);
     
     if (loc_handle != nullptr)
     {
@@ -232,8 +306,8 @@ bool DeviousDevices::DeviceReader::GetPropertyBool(RE::TESObjectARMO* a_invdevic
 
 std::string DeviousDevices::DeviceReader::GetPropertyString(RE::TESObjectARMO* a_invdevice, std::string a_propertyname, std::string a_defvalue, int a_mode) const
 {
-    auto loc_unit   = DeviceReader::GetSingleton()->GetDeviceUnit(a_invdevice);
-    auto loc_handle = (a_mode == 0) ? loc_unit.deviceHandle : loc_unit.history.front().deviceHandle;
+    DD_PROFILE_SCOPE(pDeviceReader)
+    const DeviceHandle* loc_handle = GetDeviceHandle(a_invdevice,a_mode);
     
     if (loc_handle != nullptr)
     {
@@ -247,44 +321,24 @@ std::string DeviousDevices::DeviceReader::GetPropertyString(RE::TESObjectARMO* a
 template <typename T>
 std::vector<T*> DeviousDevices::DeviceReader::GetPropertyFormArray(RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_mode) const
 {
-    auto loc_unit   = DeviceReader::GetSingleton()->GetDeviceUnit(a_invdevice);
-    auto loc_handle = (a_mode == 0) ? loc_unit.deviceHandle : loc_unit.history.front().deviceHandle;
-    
-    if (loc_handle != nullptr)
-    {
-        std::vector<uint32_t> loc_formIDs = loc_handle->GetPropertyOBJA(a_propertyname);
-        std::vector<T*> loc_res;
-        //we need to convert it to correct ID and get the form
-        if (loc_formIDs.size() > 0)
-        {
+    DD_PROFILE_SCOPE(pDeviceReader)
+    const std::vector<RE::TESForm*> loc_forms = ResolveFormArray(GetDeviceHandle(a_invdevice,a_mode),a_propertyname);
 
-            for(auto&& it : loc_formIDs)
-            {
-                if (it > 0)
-                {
-                    T* loc_form = loc_unit.deviceMod->GetForm<T>(it);
-                    loc_res.push_back(loc_form);
-                }
-                else loc_res.push_back(nullptr);
-            }
-
-            LOG("GetPropertyFormArray({} 0x{:08X} , {}) called - Result:",a_invdevice->GetName(),a_invdevice->GetFormID(),a_propertyname)
-            for (auto&& it2 : loc_res) LOG("\t0x{:08X} - {}",it2->GetFormID(),it2->GetName())
-            return loc_res;
-        }
-    }
-    return std::vector<T*>();
+    std::vector<T*> loc_res(loc_forms.size());
+    std::transform(loc_forms.begin(),loc_forms.end(),loc_res.begin(),[](RE::TESForm* a_form){ return static_cast<T*>(a_form); });
+    return loc_res;
 }
 
 std::vector<RE::TESForm*> DeviousDevices::DeviceReader::GetPropertyFormArray(RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_mode = 0) const
 {
-    return GetPropertyFormArray<RE::TESForm>(a_invdevice, a_propertyname, a_mode);
+    DD_PROFILE_SCOPE(pDeviceReader)
+    return ResolveFormArray(GetDeviceHandle(a_invdevice,a_mode),a_propertyname);
 }
 
 std::vector<int> DeviousDevices::DeviceReader::GetPropertyIntArray(RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_mode) const
 {
-    auto loc_unit   = DeviceReader::GetSingleton()->GetDeviceUnit(a_invdevice);
-    auto loc_handle = (a_mode == 0) ? loc_unit.deviceHandle : loc_unit.history.front().deviceHandle;
+    DD_PROFILE_SCOPE(pDeviceReader)
+    const DeviceHandle* loc_handle = GetDeviceHandle(a_invdevice,a_mode);
     
     if (loc_handle != nullptr)
     {
@@ -298,8 +352,8 @@ std::vector<int> DeviousDevices::DeviceReader::GetPropertyIntArray(RE::TESObject
 
 std::vector<float> DeviousDevices::DeviceReader::GetPropertyFloatArray(RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_mode) const
 {
-    auto loc_unit   = DeviceReader::GetSingleton()->GetDeviceUnit(a_invdevice);
-    auto loc_handle = (a_mode == 0) ? loc_unit.deviceHandle : loc_unit.history.front().deviceHandle;
+    DD_PROFILE_SCOPE(pDeviceReader)
+    const DeviceHandle* loc_handle = GetDeviceHandle(a_invdevice,a_mode);
     
     if (loc_handle != nullptr)
     {
@@ -313,8 +367,8 @@ std::vector<float> DeviousDevices::DeviceReader::GetPropertyFloatArray(RE::TESOb
 
 std::vector<bool> DeviousDevices::DeviceReader::GetPropertyBoolArray(RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_mode) const
 {
-    auto loc_unit   = DeviceReader::GetSingleton()->GetDeviceUnit(a_invdevice);
-    auto loc_handle = (a_mode == 0) ? loc_unit.deviceHandle : loc_unit.history.front().deviceHandle;
+    DD_PROFILE_SCOPE(pDeviceReader)
+    const DeviceHandle* loc_handle = GetDeviceHandle(a_invdevice,a_mode);
     
     if (loc_handle != nullptr)
     {
@@ -328,8 +382,8 @@ std::vector<bool> DeviousDevices::DeviceReader::GetPropertyBoolArray(RE::TESObje
 
 std::vector<std::string> DeviousDevices::DeviceReader::GetPropertyStringArray(RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_mode) const
 {
-    auto loc_unit   = DeviceReader::GetSingleton()->GetDeviceUnit(a_invdevice);
-    auto loc_handle = (a_mode == 0) ? loc_unit.deviceHandle : loc_unit.history.front().deviceHandle;
+    DD_PROFILE_SCOPE(pDeviceReader)
+    const DeviceHandle* loc_handle = GetDeviceHandle(a_invdevice,a_mode);
     
     if (loc_handle != nullptr)
     {
@@ -341,6 +395,82 @@ std::vector<std::string> DeviousDevices::DeviceReader::GetPropertyStringArray(RE
     return std::vector<std::string>();
 }
 
+const DeviousDevices::DeviceHandle* DeviousDevices::DeviceReader::GetDeviceHandle(RE::TESObjectARMO* a_invdevice, int a_mode) const
+{
+    if (a_invdevice == nullptr) return nullptr;
+
+    //unit is used for last version, as it is also updated while database is being built
+    if (a_mode == 0)
+    {
+        const auto loc_unit = _devicesByInventory.find(a_invdevice->GetFormID());
+        return (loc_unit != _devicesByInventory.end() && loc_unit->second != nullptr) ? loc_unit->second->deviceHandle.get() : nullptr;
+    }
+
+    const DeviceHistory* loc_history = GetDeviceHistory(a_invdevice);
+    return loc_history ? loc_history->GetOriginal() : nullptr;
+}
+
+const DeviousDevices::DeviceHistory* DeviousDevices::DeviceReader::GetDeviceHistory(RE::TESObjectARMO* a_invdevice) const
+{
+    if (a_invdevice == nullptr) return nullptr;
+    const auto loc_history = _deviceHistories.find(a_invdevice->GetFormID());
+    return (loc_history != _deviceHistories.end()) ? &loc_history->second : nullptr;
+}
+
+RE::TESForm* DeviousDevices::DeviceReader::GetPropertyFormAtVersion(RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_version, RE::TESForm* a_defvalue) const
+{
+    DD_PROFILE_SCOPE(pDeviceReader)
+    const DeviceHistory* loc_history = GetDeviceHistory(a_invdevice);
+    const ResolvedForm loc_res = ResolveForm(loc_history ? loc_history->GetVersion(a_version) : nullptr,a_propertyname);
+    return loc_res.found ? loc_res.form : a_defvalue;
+}
+
+std::vector<RE::TESForm*> DeviousDevices::DeviceReader::GetPropertiesForm(RE::TESObjectARMO* a_invdevice, const std::vector<std::string>& a_propertynames, const std::vector<RE::TESForm*>& a_defvalues, int a_mode) const
+{
+    DD_PROFILE_SCOPE(pDeviceReader)
+    std::vector<RE::TESForm*> loc_res(a_propertynames.size(),nullptr);
+    const DeviceHandle* loc_handle = GetDeviceHandle(a_invdevice,a_mode);
+    for (size_t i = 0; i < loc_res.size(); i++)
+    {
+        const ResolvedForm loc_form = ResolveForm(loc_handle,a_propertynames[i]);
+        if (loc_form.found) loc_res[i] = loc_form.form;
+        else if (i < a_defvalues.size()) loc_res[i] = a_defvalues[i];
+    }
+    return loc_res;
+}
+
+std::vector<int> DeviousDevices::DeviceReader::GetPropertiesInt(RE::TESObjectARMO* a_invdevice, const std::vector<std::string>& a_propertynames, const std::vector<int>& a_defvalues, int a_mode) const
+{
+    DD_PROFILE_SCOPE(pDeviceReader)
+    const DeviceHandle* loc_handle = GetDeviceHandle(a_invdevice,a_mode);
+    if (loc_handle != nullptr) return loc_handle->GetPropertiesINT(a_propertynames,a_defvalues);
+    return std::vector<int>(a_propertynames.size(),0);
+}
+
+std::vector<float> DeviousDevices::DeviceReader::GetPropertiesFloat(RE::TESObjectARMO* a_invdevice, const std::vector<std::string>& a_propertynames, const std::vector<float>& a_defvalues, int a_mode) const
+{
+    DD_PROFILE_SCOPE(pDeviceReader)
+    const DeviceHandle* loc_handle = GetDeviceHandle(a_invdevice,a_mode);
+    if (loc_handle != nullptr) return loc_handle->GetPropertiesFLT(a_propertynames,a_defvalues);
+    return std::vector<float>(a_propertynames.size(),0.0f);
+}
+
+std::vector<bool> DeviousDevices::DeviceReader::GetPropertiesBool(RE::TESObjectARMO* a_invdevice, const std::vector<std::string>& a_propertynames, const std::vector<bool>& a_defvalues, int a_mode) const
+{
+    DD_PROFILE_SCOPE(pDeviceReader)
+    const DeviceHandle* loc_handle = GetDeviceHandle(a_invdevice,a_mode);
+    if (loc_handle != nullptr) return loc_handle->GetPropertiesBOL(a_propertynames,a_defvalues);
+    return std::vector<bool>(a_propertynames.size(),false);
+}
+
+std::vector<std::string> DeviousDevices::DeviceReader::GetPropertiesString(RE::TESObjectARMO* a_invdevice, const std::vector<std::string>& a_propertynames, const std::vector<std::string>& a_defvalues, int a_mode) const
+{
+    DD_PROFILE_SCOPE(pDeviceReader)
+    const DeviceHandle* loc_handle = GetDeviceHandle(a_invdevice,a_mode);
+    if (loc_handle != nullptr) return loc_handle->GetPropertiesSTR(a_propertynames,a_defvalues);
+    return std::vector<std::string>(a_propertynames.size(),"");
+}
+
 void DeviceReader::LoadDB() {
 
     auto dataHandler = RE::TESDataHandler::GetSingleton();
@@ -350,6 +480,10 @@ void DeviceReader::LoadDB() {
 
     ConfigManager::GetSingleton()->SetLoggingDisable(true);
     DEBUG("=== Building database")
+    _formCache.Clear();
+    _formArrayCache.Clear();
+    _deviceHistories.clear();
+    _nameIndex.Clear();
     for (auto && it1 : _ddmodspars)
     {
         //LOG("Checking devices in mod {}",it1->name)
@@ -378,6 +512,10 @@ void DeviceReader::LoadDB() {
                     _database[loc_ID].deviceHandle    = it2;
                     _database[loc_ID].deviceMod       = it1;
 
+                    //properties below are read through lookups, so they have to point to the device already
+                    _devicesByInventory[_database[loc_ID].deviceInventory->GetFormID()] = &_database[loc_ID];
+                    _devicesByRendered[_database[loc_ID].deviceRendered->GetFormID()] = &_database[loc_ID];
+
                     // keywords
                     _database[loc_ID].kwd = GetPropertyForm<RE::BGSKeyword>(loc_ID, "zad_DeviousDevice",NULL, 0);
                     _database[loc_ID].equipConflictingDeviceKwds =
@@ -397,9 +535,6 @@ void DeviceReader::LoadDB() {
                         GetPropertyForm<RE::BGSMessage>(loc_ID, "zad_EquipConflictFailMsg",NULL, 0);
                    
 
-                    _devicesByInventory[_database[loc_ID].deviceInventory->GetFormID()] = &_database[loc_ID];
-                    _devicesByRendered[_database[loc_ID].deviceRendered->GetFormID()] = &_database[loc_ID];
-
                     std::vector<RE::BGSKeyword*> loc_keywords(_database[loc_ID].deviceHandle->keywords.ksiz.keywordcount);
  
                     _database[loc_ID].lockable = _database[loc_ID].deviceInventory->HasKeywordString("zad_Lockable") ||
@@ -432,10 +567,36 @@ void DeviceReader::LoadDB() {
         }
     }
 
+    //mods are parsed in load order, so their index is also their load order
+    std::unordered_map<const DeviceMod*,uint32_t> loc_modIndices;
+    for (uint32_t i = 0; i < _ddmodspars.size(); i++) loc_modIndices[_ddmodspars[i].get()] = i;
+
+    for (auto&& [loc_device,loc_unit] : _database)
+    {
+        std::vector<DeviceHistory::Version> loc_versions;
+        for (auto&& it : loc_unit.history) loc_versions.push_back({loc_modIndices[it.deviceMod.get()],it.deviceHandle});
+        _deviceHistories.emplace(loc_device->GetFormID(),DeviceHistory(std::move(loc_versions)));
+    }
+
+    //devices are added sorted by name, so searches return them in the same order
+    std::vector<RE::TESObjectARMO*> loc_devices;
+    for (auto&& it : _database) loc_devices.push_back(it.first);
+    std::sort(loc_devices.begin(),loc_devices.end(),[](RE::TESObjectARMO* a_1, RE::TESObjectARMO* a_2)
+    {
+        return std::string_view(a_1->GetName()) < std::string_view(a_2->GetName());
+    });
+    for (auto&& it : loc_devices)
+    {
+        const DeviceHandle* loc_handle = _database[it].deviceHandle.get();
+        _nameIndex.Add(it->GetName(),it);
+        _nameIndex.Add((loc_handle && !loc_handle->editorID.empty()) ? std::string_view(loc_handle->editorID) : std::string_view(it->GetFormEditorID()),it);
+    }
+    _nameIndex.Build();
+
     DEBUG("=== Building database DONE - Size = {}",_database.size())
     CLOG("Database loaded! Size = {}",_database.size())
 
-    if (ConfigManager::GetSingleton()->GetVariable<bool>("Main.bPrintDB",false) == 1)
+    if (ConfigManager::GetSingleton()->GetConfig().Main_bPrintDB == 1)
     {
         for (auto&& it : _database) 
         {
@@ -519,7 +680,7 @@ void DeviceReader::ShowEquipMenu(DeviceUnit* device, std::function<void(bool)> c
 void DeviceReader::ShowManipulateMenu(RE::Actor* actor, DeviceUnit* device) 
 {
     SetManipulated(actor, device->deviceInventory, false);
-    if (Settings::GetSingleton().GetSetting<bool>("UseItemManipulation") && device->lockable && device->canManipulate) {
+    if (Settings::GetSingleton().GetMirror().UseItemManipulation && device->lockable && device->canManipulate) {
         auto menu = device->GetManipulationMenu();
         if (menu != nullptr)
             UI::MessageBox::Show(menu, [actor, device](uint32_t result) { 
@@ -572,620 +733,10 @@ bool DeviceReader::UnequipRenderedDevice(RE::Actor* actor, DeviceUnit* device)
 }
 
 
-DeviceMod::DeviceMod(std::string a_name, uint8_t* a_data, size_t a_size)
-{
-    size = a_size;
-    rawdata = a_data;
-    name = a_name;
-    size_t loc_fptr = 0x00000000;
-
-    static const size_t loc_headersize = (sizeof(DeviceGroup) - sizeof(uint8_t*));
-
-    //parse
-    while ((loc_fptr + loc_headersize) < size)
-    {
-        DeviceGroup loc_tmp;
-
-        memcpy(&loc_tmp,&rawdata[loc_fptr],loc_headersize);
-        loc_fptr += loc_headersize; //move file pointer
-
-        //soo, it looks like that the uesp wiki was lying. The data size is actually correct size of data without header. 
-        //And it is different for TES4 and other groups...
-        size_t loc_datasize = 0;
-
-        if (std::string(loc_tmp.grup,loc_tmp.grup + 4*sizeof(uint8_t)) == "TES4")
-        {
-            loc_datasize = loc_tmp.size;
-            group_TES4      = loc_tmp;
-            group_TES4.data = new uint8_t[loc_datasize];
-            memcpy(group_TES4.data,&rawdata[loc_fptr],loc_datasize);
-        }
-        else if (std::string(loc_tmp.grup,loc_tmp.grup + 4*sizeof(uint8_t)) == "GRUP" && std::string(loc_tmp.label,loc_tmp.label + 4*sizeof(uint8_t)) == "ARMO")
-        {
-            loc_datasize = loc_tmp.size - loc_headersize;
-            group_ARMO      = loc_tmp;
-            group_ARMO.data = new uint8_t[loc_datasize];
-            memcpy(group_ARMO.data,&rawdata[loc_fptr],loc_datasize);
-        } 
-        else
-        {
-            loc_datasize = loc_tmp.size - loc_headersize;
-        }
-        loc_fptr += loc_datasize; //record data read, move pointer
-    }
-
-    ParseInfo();
-    ParseDevices();
-}
-
-void DeviceMod::ParseInfo()
-{
-    masters.clear();
-
-    size_t loc_fptr = 0x00000000;
-    while ((loc_fptr) < (group_TES4.size))
-    {
-        FieldHeader loc_field;
-
-        memcpy(&loc_field,&group_TES4.data[loc_fptr],sizeof(FieldHeader));
-        loc_fptr += sizeof(FieldHeader); //move file pointer
-
-        const size_t loc_datasize = loc_field.size;
-        std::string loc_signature = std::string(loc_field.type,loc_field.type + 4*sizeof(uint8_t));
-        if (loc_signature == "MAST")
-        {
-            if (loc_datasize > 0)
-            {
-                std::string loc_master = std::string(&group_TES4.data[loc_fptr],&group_TES4.data[loc_fptr + loc_datasize - 1]);
-                masters.push_back(loc_master);
-            }
-        }
-        loc_fptr += loc_datasize; //field data read, move pointer
-    }
-    masters.push_back(name);
-
-    DEBUG("=== Final masters of mod {}",name)
-    for (int i = 0; i < masters.size();i++)
-    {
-        DEBUG("{:02X} = {}",i,masters[i])
-    }
-}
-
-size_t DeviceMod::ParseDevices()
-{
-    size_t loc_fptr     = 0x00000000;
-    size_t loc_res      = 0;
-
-    static const size_t loc_headersize = (sizeof(DeviceRecord) - sizeof(uint8_t*));
-
-    while ((loc_fptr + loc_headersize) < group_ARMO.size)
-    {
-        devicerecords.push_back(std::shared_ptr<DeviceHandle>(new DeviceHandle));
-
-        memcpy(&devicerecords.back()->record,&group_ARMO.data[loc_fptr],loc_headersize);
-        loc_fptr += loc_headersize; //move file pointer
-
-        const size_t loc_datasize = devicerecords.back()->record.size;
-        devicerecords.back()->record.data = new uint8_t[loc_datasize];
-
-        memcpy(devicerecords.back()->record.data,&group_ARMO.data[loc_fptr],loc_datasize);
-        loc_fptr += loc_datasize; //field data read, move pointer
-
-        const uint32_t loc_formID = devicerecords.back()->record.formId;
-        const uint8_t  loc_modindex = (loc_formID & 0xFF000000) >> 24;
-        const std::string loc_modsource = masters[loc_modindex < masters.size() ? loc_modindex : masters.size() - 1];
-
-        devicerecords.back()->source = loc_modsource;
-        devicerecords.back()->mod    = this;
-
-        if (devicerecords.back()->record.flags & 0x00040000) ERROR("Form is compressed!")
-
-        RE::TESForm* loc_form = GetForm(devicerecords.back().get());
-
-        if (loc_form != nullptr) 
-        {
-            devicerecords.back()->LoadVM();
-            devicerecords.back()->LoadKeywords();
-        }
-        //else LOG("Could not find Form !!!")
-
-        loc_res++;
-    }
-
-    return loc_res;
-}
-
-RE::TESForm* DeviceMod::GetForm(const DeviceHandle* a_handle) const
-{
-    RE::TESForm* loc_form = RE::TESDataHandler::GetSingleton()->LookupForm(0x00FFFFFF & a_handle->record.formId,a_handle->source);
-
-    return loc_form;
-}
-
 template <typename T>
 T* DeviceMod::GetForm(const uint32_t a_formID) const 
 {
-    const uint8_t loc_modindex = (a_formID & 0xFF000000) >> 24;
-    const std::string loc_modsource = masters[loc_modindex >= masters.size() ? masters.size() - 1 : loc_modindex];
-    return reinterpret_cast<T*>(RE::TESDataHandler::GetSingleton()->LookupForm(0x00FFFFFF & a_formID, loc_modsource));
-}
-
-void DeviceHandle::LoadVM()
-{
-    size_t loc_fptr = 0x00000000;
-    while ((loc_fptr) < (record.size))
-    {
-        FieldHeader loc_field;
-        memcpy(&loc_field,&record.data[loc_fptr],sizeof(FieldHeader));
-        loc_fptr += sizeof(FieldHeader); //move file pointer
-
-        const size_t loc_datasize = loc_field.size;
-        std::string loc_signature = std::string(loc_field.type,loc_field.type + 4*sizeof(uint8_t));
-        if (loc_signature == "VMAD") //we only care about VMAD
-        {
-            static const size_t loc_VMheadersize = 6;
-            memcpy(&scripts,&record.data[loc_fptr],loc_VMheadersize);
-            loc_fptr += loc_VMheadersize;
-            for (int i = 0; i < scripts.scriptCount; i++)
-            {
-                scripts.scripts.push_back(std::unique_ptr<Script>(new Script()));
-                Script* loc_script = scripts.scripts.back().get();
-
-                //parse script name
-                uint16_t loc_wscriptsize = *reinterpret_cast<uint16_t*>(&record.data[loc_fptr]);
-                std::string loc_scriptname = std::string(&record.data[loc_fptr + 2],&record.data[loc_fptr + 2 + loc_wscriptsize]);
-                loc_script->scriptName = loc_scriptname;
-
-                loc_fptr += 2 + loc_wscriptsize;
-
-                //parse script status
-                loc_script->status = record.data[loc_fptr];
-                loc_fptr += 1;
-
-                //parse property count
-                loc_script->propertyCount = *reinterpret_cast<uint16_t*>(&record.data[loc_fptr]);
-                loc_fptr += 2;
-
-                //parse properties
-                for (int p = 0; p < loc_script->propertyCount; p++)
-                {
-                    loc_script->properties.push_back(std::unique_ptr<Property>(new Property()));
-                    Property* loc_property = loc_script->properties.back().get();
-
-                    static const size_t loc_propertyheadersize = sizeof(Property) - sizeof(std::unique_ptr<uint8_t>);
-
-                    //parse property name
-                    uint16_t loc_wpropertysize = *reinterpret_cast<uint16_t*>(&record.data[loc_fptr]);
-                    std::string loc_propertyname = std::string(&record.data[loc_fptr + 2],&record.data[loc_fptr + 2 + loc_wpropertysize]);
-                    loc_property->propertyName = loc_propertyname;
-                    loc_fptr += 2 + loc_wpropertysize;
-
-                    //parse property type
-                    loc_property->propertyType = record.data[loc_fptr];
-                    loc_fptr += 1;
-
-                    //parse status
-                    loc_property->status = record.data[loc_fptr];
-                    loc_fptr += 1;
-
-                    //parse raw property data
-                    switch(static_cast<Property::PropertyTypes>(loc_property->propertyType))
-                    {
-                        case Property::PropertyTypes::kObject:
-                            {
-                                loc_property->data = std::unique_ptr<uint8_t>(new uint8_t[8]);
-                                memcpy(loc_property->data.get(),&record.data[loc_fptr],8);
-                                loc_fptr += 8;
-                            }
-                            break;
-                        case Property::PropertyTypes::kWString:
-                            {
-                                uint16_t loc_wvaluesize = *reinterpret_cast<uint16_t*>(&record.data[loc_fptr]);
-                                loc_property->data = std::unique_ptr<uint8_t>(new uint8_t[2 + loc_wvaluesize]);
-                                memcpy(loc_property->data.get(),&record.data[loc_fptr],2 + loc_wvaluesize);
-                                loc_fptr += 2 + loc_wvaluesize;
-                            }
-                            break;
-                        case Property::PropertyTypes::kInt:
-                        case Property::PropertyTypes::kFloat:
-                            {
-                                loc_property->data = std::unique_ptr<uint8_t>(new uint8_t[4]);
-                                memcpy(loc_property->data.get(),&record.data[loc_fptr],4);
-                                loc_fptr += 4;
-                            }
-                            break;
-                        case Property::PropertyTypes::kBool:
-                            {
-                                loc_property->data = std::unique_ptr<uint8_t>(new uint8_t[1]);
-                                memcpy(loc_property->data.get(),&record.data[loc_fptr],1);
-                                loc_fptr += 1;
-                            }
-                            break;
-                        case Property::PropertyTypes::kArrayObject:
-                            {
-                                const uint32_t loc_arraysize = *reinterpret_cast<uint32_t*>(&record.data[loc_fptr]);
-                                const uint32_t loc_varsize = 4 + loc_arraysize*8;
-                                loc_property->data = std::unique_ptr<uint8_t>(new uint8_t[loc_varsize]);
-                                memcpy(loc_property->data.get(),&record.data[loc_fptr],loc_varsize);
-                                loc_fptr += loc_varsize;
-                            }
-                            break;
-                        case Property::PropertyTypes::kArrayWString:
-                            {
-                                //we are entering pain area
-                                const uint32_t loc_arraysize = *reinterpret_cast<uint32_t*>(&record.data[loc_fptr]);
-                                uint32_t loc_fptr2 = loc_fptr;
-                                loc_fptr2 += 4;
-                                for (int v = 0; v < loc_arraysize; v++)
-                                {
-                                    uint16_t loc_wvaluesize = *reinterpret_cast<uint16_t*>(&record.data[loc_fptr2]);
-                                    loc_fptr2 += 2 + loc_wvaluesize;
-                                }
-                                const uint32_t loc_size = loc_fptr2 - loc_fptr;
-                                loc_property->data = std::unique_ptr<uint8_t>(new uint8_t[loc_size]);
-                                memcpy(loc_property->data.get(),&record.data[loc_fptr],loc_size);
-                                loc_fptr = loc_fptr2;
-                            }
-                            break;
-                        case Property::PropertyTypes::kArrayInt:
-                        case Property::PropertyTypes::kArrayFloat:
-                            {
-                                const uint32_t loc_arraysize = *reinterpret_cast<uint32_t*>(&record.data[loc_fptr]);
-                                const uint32_t loc_varsize = 4 + loc_arraysize*4;
-                                loc_property->data = std::unique_ptr<uint8_t>(new uint8_t[loc_varsize]);
-                                memcpy(loc_property->data.get(),&record.data[loc_fptr],loc_varsize);
-                                loc_fptr += loc_varsize;
-                            }
-                            break;
-                        case Property::PropertyTypes::kArrayBool:
-                            {
-                                const uint32_t loc_arraysize = *reinterpret_cast<uint32_t*>(&record.data[loc_fptr]);
-                                const uint32_t loc_varsize = 4 + loc_arraysize*1;
-                                loc_property->data = std::unique_ptr<uint8_t>(new uint8_t[loc_varsize]);
-                                memcpy(loc_property->data.get(),&record.data[loc_fptr],loc_varsize);
-                                loc_fptr += loc_varsize;
-                            }
-                            break;
-                    }
-                }
-            }
-            break;
-        }
-        loc_fptr += loc_datasize; //field data read, move pointer
-    }
-}
-
-void DeviousDevices::DeviceHandle::LoadKeywords()
-{
-    size_t loc_fptr = 0x00000000;
-    while ((loc_fptr) < (record.size))
-    {
-        FieldHeader loc_field;
-        memcpy(&loc_field,&record.data[loc_fptr],sizeof(FieldHeader));
-        loc_fptr += sizeof(FieldHeader); //move file pointer
-
-        const size_t loc_datasize = loc_field.size;
-        std::string loc_signature = std::string(loc_field.type,loc_field.type + 4*sizeof(uint8_t));
-        if (loc_signature == "KSIZ") //we only care about KSIZ
-        {
-            keywords.ksiz.header = loc_field;
-            keywords.ksiz.keywordcount = *reinterpret_cast<uint32_t*>(&record.data[loc_fptr]);
-        }  
-        else if (loc_signature == "KWDA")   
-        {
-            keywords.kwda.header = loc_field;
-            keywords.kwda.data = std::shared_ptr<uint32_t>(new uint32_t[keywords.ksiz.keywordcount]);  //1 kw = uint32_t
-            memcpy(keywords.kwda.data.get(),&record.data[loc_fptr],keywords.kwda.header.size);
-            break; //break loop after KWDA as we don't need any more fields
-        }
-
-        loc_fptr += loc_datasize; //field data read, move pointer
-    }
-}
-
-std::pair<std::shared_ptr<uint8_t>, uint8_t> DeviousDevices::DeviceHandle::GetPropertyRaw(std::string a_name) const
-{
-    transform(a_name.begin(), a_name.end(), a_name.begin(), ::tolower);
-
-    for (auto && it1 : scripts.scripts)
-    {
-        for (auto && it2 : it1->properties)
-        {
-            std::string loc_propertyname = it2->propertyName;
-
-            //check in lower case
-            transform(loc_propertyname.begin(), loc_propertyname.end(), loc_propertyname.begin(), ::tolower);
-
-            if (loc_propertyname == a_name)
-            {
-                return {it2->data, it2->propertyType};
-            }
-        }
-    }
-    return {nullptr,0};
-}
-
-RE::FormID DeviceHandle::GetPropertyOBJ(std::string a_name, uint32_t a_defvalue, bool a_silence) const 
-{
-    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
-    if (loc_data != nullptr)
-    {
-        if (loc_type == (uint8_t)Property::PropertyTypes::kObject)
-        {
-            //LOG("GetPropertyOBJ: Raw Data = {:08X}", *(uint64_t*)loc_property.first.get())
-            return *reinterpret_cast<uint32_t*>(loc_data.get() + 4U);
-        }
-        else
-        {
-            if (!a_silence) ERROR("DeviceHandle::GetPropertyOBJ({},{},{}) - Property is of incorrect type. Type = {}", a_name,a_defvalue,a_silence,loc_type)
-            return 0x00000000;
-        }
-    }
-    else
-    {
-        LOG("DeviceHandle::GetPropertyOBJ({},{},{}): Property not found", a_name,a_defvalue,a_silence)
-        return a_defvalue;
-    }
-}
-
-int32_t DeviceHandle::GetPropertyINT(std::string a_name, int32_t a_defvalue) const
-{
-    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
-    if (loc_data != nullptr)
-    {
-        if (loc_type == (uint8_t)Property::PropertyTypes::kInt)
-        {
-            return *reinterpret_cast<int32_t*>(loc_data.get());
-        }
-        else
-        {
-            ERROR("DeviceHandle::GetPropertyINT({},{}) - Property is of incorrect type. Type = {}", a_name,a_defvalue,loc_type)
-            return 0x00000000;
-        }
-    }
-    else
-    {
-        WARN("DeviceHandle::GetPropertyINT({},{}): Property not found", a_name,a_defvalue)
-        return a_defvalue;
-    }
-}
-
-float DeviceHandle::GetPropertyFLT(std::string a_name, float a_defvalue) const
-{
-    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
-    if (loc_data != nullptr)
-    {
-        if (loc_type == (uint8_t)Property::PropertyTypes::kFloat)
-        {
-            return *reinterpret_cast<float*>(loc_data.get());
-        }
-        else
-        {
-            ERROR("DeviceHandle::GetPropertyFLT({},{}) - Property is of incorrect type. Type = {}", a_name,a_defvalue,loc_type)
-            return 0.0f;
-        }
-    }
-    else
-    {
-        WARN("DeviceHandle::GetPropertyFLT({},{}): Property not found", a_name,a_defvalue)
-        return a_defvalue;
-    }
-}
-
-bool DeviceHandle::GetPropertyBOL(std::string a_name, bool a_defvalue) const
-{
-    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
-    if (loc_data != nullptr)
-    {
-        if (loc_type == (uint8_t)Property::PropertyTypes::kBool)
-        {
-            return *reinterpret_cast<bool*>(loc_data.get());
-        }
-        else
-        {
-            ERROR("DeviceHandle::GetPropertyBOL({},{}) - Property is of incorrect type. Type = {}", a_name,a_defvalue,loc_type)
-            return false;
-        }
-    }
-    else
-    {
-        WARN("DeviceHandle::GetPropertyBOL({},{}): Property not found", a_name,a_defvalue)
-        return a_defvalue;
-    }
-}
-
-std::string DeviousDevices::DeviceHandle::GetPropertySTR(std::string a_name, std::string a_defvalue) const
-{
-    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
-    if (loc_data != nullptr)
-    {
-        if (loc_type == (uint8_t)Property::PropertyTypes::kWString)
-        {
-            uint16_t loc_wsize = *reinterpret_cast<uint16_t*>(loc_data.get());
-            std::string loc_res = std::string(loc_data.get() + 2, loc_data.get() + 2 + loc_wsize); //convert wstring to zstring
-            return loc_res;
-        }
-        else
-        {
-            ERROR("DeviceHandle::GetPropertySTR({},{}) - Property is of incorrect type. Type = {}", a_name,a_defvalue,loc_type)
-            return "";
-        }
-    }
-    else
-    {
-        WARN("DeviceHandle::GetPropertySTR({},{}): Property not found", a_name,a_defvalue)
-        return a_defvalue;
-    }
-}
-
-std::vector<uint32_t> DeviousDevices::DeviceHandle::GetPropertyOBJA(std::string a_name) const
-{
-    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
-    if (loc_data != nullptr)
-    {
-        if (loc_type == (uint8_t)Property::PropertyTypes::kArrayObject)
-        {
-            std::vector<uint32_t> loc_res;
-            uint32_t loc_fptr = 0x00000000;
-            const uint32_t loc_arraysize = *reinterpret_cast<uint32_t*>(&loc_data.get()[loc_fptr]);
-            loc_fptr += 4;
-
-            struct PropertyObject
-            {
-                uint16_t unk1;
-                uint16_t alias;
-                uint32_t formId;
-            };
-
-            for (size_t i = 0; i < loc_arraysize; i++)
-            {
-                  PropertyObject loc_object = *reinterpret_cast<PropertyObject*>(&loc_data.get()[loc_fptr]);
-                  loc_res.push_back(loc_object.formId);
-                  loc_fptr += sizeof(PropertyObject);
-            }
-
-            return loc_res;
-        }
-        else
-        {
-            return std::vector<uint32_t>();
-        }
-    }
-    else
-    {
-        return std::vector<uint32_t>();
-    }
-}
-
-std::vector<int32_t> DeviousDevices::DeviceHandle::GetPropertyINTA(std::string a_name) const
-{
-    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
-    if (loc_data != nullptr)
-    {
-        if (loc_type == (uint8_t)Property::PropertyTypes::kArrayInt)
-        {
-            std::vector<int32_t> loc_res;
-            uint32_t loc_fptr = 0x00000000;
-            const uint32_t loc_arraysize = *reinterpret_cast<uint32_t*>(&loc_data.get()[loc_fptr]);
-            loc_fptr += 4;
-
-            for (size_t i = 0; i < loc_arraysize; i++)
-            {
-                  int32_t loc_val = *reinterpret_cast<int32_t*>(&loc_data.get()[loc_fptr]);
-                  loc_res.push_back(loc_val);
-                  loc_fptr += sizeof(int32_t);
-            }
-
-            return loc_res;
-        }
-        else
-        {
-            return std::vector<int32_t>();
-        }
-    }
-    else
-    {
-        return std::vector<int32_t>();
-    }
-}
-
-std::vector<float> DeviousDevices::DeviceHandle::GetPropertyFLTA(std::string a_name) const
-{
-    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
-    if (loc_data != nullptr)
-    {
-        if (loc_type == (uint8_t)Property::PropertyTypes::kArrayFloat)
-        {
-            std::vector<float> loc_res;
-            uint32_t loc_fptr = 0x00000000;
-            const uint32_t loc_arraysize = *reinterpret_cast<uint32_t*>(&loc_data.get()[loc_fptr]);
-            loc_fptr += 4;
-
-            for (size_t i = 0; i < loc_arraysize; i++)
-            {
-                  float loc_val = *reinterpret_cast<float*>(&loc_data.get()[loc_fptr]);
-                  loc_res.push_back(loc_val);
-                  loc_fptr += sizeof(float);
-            }
-
-            return loc_res;
-        }
-        else
-        {
-            return std::vector<float>();
-        }
-    }
-    else
-    {
-        return std::vector<float>();
-    }
-}
-
-std::vector<bool> DeviousDevices::DeviceHandle::GetPropertyBOLA(std::string a_name) const
-{
-    const auto [loc_data,loc_type] = GetPropertyRaw(a_name);
-    if (loc_data != nullptr)
-    {
-        if (loc_type == (uint8_t)Property::PropertyTypes::kArrayFloat)
-        {
-            std::vector<bool> loc_res;
-            uint32_t loc_fptr = 0x00000000;
-            const uint32_t loc_arraysize = *reinterpret_cast<uint32_t*>(&loc_data.get()[loc_fptr]);
-            loc_fptr += 4;
-
-            for (size_t i = 0; i < loc_arraysize; i++)
-            {
-                  float loc_val = *reinterpret_cast<bool*>(&loc_data.get()[loc_fptr]);
-                  loc_res.push_back(loc_val);
-                  loc_fptr += sizeof(bool);
-            }
-
-            return loc_res;
-        }
-        else
-        {
-            return std::vector<bool>();
-        }
-    }
-    else
-    {
-        return std::vector<bool>();
-    }
-}
-
-std::vector<std::string> DeviousDevices::DeviceHandle::GetPropertySTRA(std::string a_name) const
-{
-    const auto [loc_dataptr,loc_type] = GetPropertyRaw(a_name);
-    if (loc_dataptr != nullptr)
-    {
-        if (loc_type == (uint8_t)Property::PropertyTypes::kArrayWString)
-        {
-            std::vector<std::string> loc_res;
-            uint8_t* loc_data = loc_dataptr.get();
-
-            uint32_t loc_fptr = 0x00000000;
-            const uint32_t loc_arraysize = *reinterpret_cast<uint32_t*>(&loc_data[loc_fptr]);
-            loc_fptr += 4;
-
-            for (size_t i = 0; i < loc_arraysize; i++)
-            {
-                const uint16_t loc_wsize = *reinterpret_cast<uint16_t*>(&loc_data[loc_fptr]);
-                const std::string loc_val = std::string(&loc_data[loc_fptr] + 2, &loc_data[loc_fptr] + 2 + loc_wsize); //convert wstring to zstring
-                loc_res.push_back(loc_val);
-                loc_fptr += 2 + loc_wsize;
-            }
-
-            return loc_res;
-        }
-        else
-        {
-            return std::vector<std::string>();
-        }
-    }
-    else
-    {
-        return std::vector<std::string>();
-    }
+    return reinterpret_cast<T*>(RE::TESDataHandler::GetSingleton()->LookupForm(0x00FFFFFF & a_formID, GetSource(a_formID)));
 }
 
 RE::TESObjectARMO* DeviousDevices::GetRenderDevice(PAPYRUSFUNCHANDLE, RE::TESObjectARMO* a_invdevice)
@@ -1235,9 +786,13 @@ RE::TESObjectARMO* DeviousDevices::GetInventoryDevice(PAPYRUSFUNCHANDLE, RE::TES
 RE::TESObjectARMO* DeviousDevices::GetDeviceByName(PAPYRUSFUNCHANDLE, std::string a_name) 
 {
     LOG("GetDeviceByName called")
-    auto loc_reader = DeviceReader::GetSingleton();
-    auto loc_unit = loc_reader->GetDeviceUnit(a_name);
-    return loc_unit.deviceInventory;
+    return DeviceReader::GetSingleton()->FindDeviceByName(a_name);
+}
+
+std::vector<RE::TESObjectARMO*> DeviousDevices::SearchDevices(PAPYRUSFUNCHANDLE, std::string a_text, bool a_substring, int a_maxcount)
+{
+    LOG("SearchDevices called")
+    return DeviceReader::GetSingleton()->SearchDevices(a_text,a_substring,static_cast<size_t>(std::max(a_maxcount,0)));
 }
 
 RE::TESForm* DeviousDevices::GetPropertyForm(PAPYRUSFUNCHANDLE, RE::TESObjectARMO* a_invdevice, std::string a_propertyname, RE::TESForm* a_defvalue, int a_mode)
@@ -1300,15 +855,76 @@ std::vector<std::string> DeviousDevices::GetPropertyStringArray(PAPYRUSFUNCHANDL
     return DeviceReader::GetSingleton()->GetPropertyStringArray(a_invdevice,a_propertyname,a_mode);
 }
 
+std::vector<RE::TESForm*> DeviousDevices::GetPropertiesForm(PAPYRUSFUNCHANDLE, RE::TESObjectARMO* a_invdevice, std::vector<std::string> a_propertynames, std::vector<RE::TESForm*> a_defvalues, int a_mode)
+{
+    LOG("GetPropertiesForm called - {} properties",a_propertynames.size())
+    return DeviceReader::GetSingleton()->GetPropertiesForm(a_invdevice,a_propertynames,a_defvalues,a_mode);
+}
+
+std::vector<int> DeviousDevices::GetPropertiesInt(PAPYRUSFUNCHANDLE, RE::TESObjectARMO* a_invdevice, std::vector<std::string> a_propertynames, std::vector<int> a_defvalues, int a_mode)
+{
+    LOG("GetPropertiesInt called - {} properties",a_propertynames.size())
+    return DeviceReader::GetSingleton()->GetPropertiesInt(a_invdevice,a_propertynames,a_defvalues,a_mode);
+}
+
+std::vector<float> DeviousDevices::GetPropertiesFloat(PAPYRUSFUNCHANDLE, RE::TESObjectARMO* a_invdevice, std::vector<std::string> a_propertynames, std::vector<float> a_defvalues, int a_mode)
+{
+    LOG("GetPropertiesFloat called - {} properties",a_propertynames.size())
+    return DeviceReader::GetSingleton()->GetPropertiesFloat(a_invdevice,a_propertynames,a_defvalues,a_mode);
+}
+
+std::vector<bool> DeviousDevices::GetPropertiesBool(PAPYRUSFUNCHANDLE, RE::TESObjectARMO* a_invdevice, std::vector<std::string> a_propertynames, std::vector<bool> a_defvalues, int a_mode)
+{
+    LOG("GetPropertiesBool called - {} properties",a_propertynames.size())
+    return DeviceReader::GetSingleton()->GetPropertiesBool(a_invdevice,a_propertynames,a_defvalues,a_mode);
+}
+
+std::vector<std::string> DeviousDevices::GetPropertiesString(PAPYRUSFUNCHANDLE, RE::TESObjectARMO* a_invdevice, std::vector<std::string> a_propertynames, std::vector<std::string> a_defvalues, int a_mode)
+{
+    LOG("GetPropertiesString called - {} properties",a_propertynames.size())
+    return DeviceReader::GetSingleton()->GetPropertiesString(a_invdevice,a_propertynames,a_defvalues,a_mode);
+}
+
 std::vector<std::string> DeviousDevices::GetEditingMods(PAPYRUSFUNCHANDLE, RE::TESObjectARMO* a_invdevice)
 {
     LOG("GetEditingMods called")
-    std::vector<std::string> loc_res;
-    auto loc_unit   = DeviceReader::GetSingleton()->GetDeviceUnit(a_invdevice);
+    const DeviceHistory* loc_history = DeviceReader::GetSingleton()->GetDeviceHistory(a_invdevice);
+    return loc_history ? loc_history->GetModNames() : std::vector<std::string>();
+}
 
-    for (auto&& it : loc_unit.history) loc_res.push_back(it.deviceMod->name);
+int DeviousDevices::GetDeviceVersionCount(PAPYRUSFUNCHANDLE, RE::TESObjectARMO* a_invdevice)
+{
+    LOG("GetDeviceVersionCount called")
+    const DeviceHistory* loc_history = DeviceReader::GetSingleton()->GetDeviceHistory(a_invdevice);
+    return loc_history ? static_cast<int>(loc_history->GetVersionCount()) : 0;
+}
 
-    constexpr size_t loc_s = sizeof(DeviceGroup);
+RE::TESForm* DeviousDevices::GetPropertyFormAtVersion(PAPYRUSFUNCHANDLE, RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_version, RE::TESForm* a_defvalue)
+{
+    LOG("GetPropertyFormAtVersion called")
+    return DeviceReader::GetSingleton()->GetPropertyFormAtVersion(a_invdevice,a_propertyname,a_version,a_defvalue);
+}
 
-    return loc_res;
+int DeviousDevices::GetPropertyIntAtVersion(PAPYRUSFUNCHANDLE, RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_version, int a_defvalue)
+{
+    LOG("GetPropertyIntAtVersion called")
+    return DeviceReader::GetSingleton()->GetPropertyAtVersion<int32_t>(a_invdevice,a_propertyname,a_version,a_defvalue);
+}
+
+float DeviousDevices::GetPropertyFloatAtVersion(PAPYRUSFUNCHANDLE, RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_version, float a_defvalue)
+{
+    LOG("GetPropertyFloatAtVersion called")
+    return DeviceReader::GetSingleton()->GetPropertyAtVersion<float>(a_invdevice,a_propertyname,a_version,a_defvalue);
+}
+
+bool DeviousDevices::GetPropertyBoolAtVersion(PAPYRUSFUNCHANDLE, RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_version, bool a_defvalue)
+{
+    LOG("GetPropertyBoolAtVersion called")
+    return DeviceReader::GetSingleton()->GetPropertyAtVersion<bool>(a_invdevice,a_propertyname,a_version,a_defvalue);
+}
+
+std::string DeviousDevices::GetPropertyStringAtVersion(PAPYRUSFUNCHANDLE, RE::TESObjectARMO* a_invdevice, std::string a_propertyname, int a_version, std::string a_defvalue)
+{
+    LOG("GetPropertyStringAtVersion called")
+    return DeviceReader::GetSingleton()->GetPropertyAtVersion<std::string>(a_invdevice,a_propertyname,a_version,a_defvalue);
 }
@@ -12,22 +12,31 @@ namespace DeviousDevices
         if (!_installed)
         {
             _installed = true;
-            _NPCUpdateTime = ConfigManager::GetSingleton()->GetVariable<float>("GagExpression.iNPCUpdateTime",120);
             RE::TESDataHandler* loc_datahandler = RE::TESDataHandler::GetSingleton();
             if (loc_datahandler)
             {
                 _BlockFaction = reinterpret_cast<RE::TESFaction*>(loc_datahandler->LookupForm(0x000811, "Devious Devices - Integration.esm"));
             }
-            else
+            if (_BlockFaction == nullptr)
             {
-                WARN("ExpressionManager::Setup() - Could not load block faction!")
+                WARN("ExpressionManager::Setup() - Could not load block faction! Expression priorities will not be saved")
             }
+
+            _FadeTime       = ConfigManager::GetSingleton()->GetConfig().Expression_fFadeTime;
+            _GagFadeTime    = ConfigManager::GetSingleton()->GetConfig().Expression_fGagFadeTime;
+
+            ConfigManager::GetSingleton()->AddReloadListener([this](const ConfigSnapshot&, const ConfigSnapshot& a_new)
+            {
+                UniqueLock lock(_LayerLock);
+                _FadeTime       = a_new.Expression_fFadeTime;
+                _GagFadeTime    = a_new.Expression_fGagFadeTime;
+            });
         }
     }
 
-    bool ExpressionManager::ApplyExpression(RE::Actor* a_actor, const std::vector<float> &a_expression, float a_strength, bool a_openMouth,int a_priority)
+    bool ExpressionManager::ApplyExpression(RE::Actor* a_actor, const Expression& a_expression, float a_strength, bool a_openMouth,int a_priority, float a_weight, float a_fadeTime)
     {
-        LOG("ApplyExpression({},{},{},{}) called",a_actor ? a_actor->GetName() : "NONE",a_strength,a_openMouth,a_priority)
+        LOG("ApplyExpression({},{},{},{},{},{}) called",a_actor ? a_actor->GetName() : "NONE",a_strength,a_openMouth,a_priority,a_weight,a_fadeTime)
 
         if (a_actor == nullptr || !a_actor->Is3DLoaded())
         {
@@ -35,143 +44,63 @@ namespace DeviousDevices
             return false;
         }
 
-        if (a_expression.size() != 32)
-        {
-            ERROR("ExpressionManager::ApplyExpression - Expression size have to be 32!")
-            return false;
-        }
-
         //validate values
         a_strength = std::clamp(a_strength,0.0f,100.0f);
         a_priority = std::clamp(a_priority,0,100);
+        a_weight   = std::clamp(a_weight,0.0f,1.0f);
 
-        if (CheckExpressionBlock(a_actor,a_priority,mSet))
-        {
-            std::vector<float> loc_exp = a_expression;
-            if (a_openMouth) loc_exp[0] = 0.75f;
+        Expression loc_exp = a_expression;
+        if (a_openMouth) loc_exp[0] = 0.75f;
+        loc_exp.ApplyStrength(a_strength);
 
-            loc_exp = ApplyStrengthToExpression(loc_exp,a_strength);
-            ApplyExpressionRaw(a_actor, loc_exp);
-            return true;
-        }
-        else
-        {
-            return false;
-        }
-    }
+        UniqueLock lock(_LayerLock);
+        ExpressionLayerStack& loc_stack = GetLayerStack(a_actor);
 
-    std::vector<float> ExpressionManager::ApplyExpressionRaw(RE::Actor* a_actor, const std::vector<float> &a_expression)
-    {
-        LOG("ApplyExpressionRaw({}) called",a_actor ? a_actor->GetName() : "NONE")
-
-        if (a_actor == nullptr) return std::vector<float>();
+        const int  loc_block = GetBlockPriority(a_actor,&loc_stack);
+        const bool loc_res   = a_priority >= loc_block;
 
-        if (a_expression.size() != 32) 
-        {
-            ERROR("Expression is of incorrect size - returning")
-            return GetExpression(a_actor);
-        }
-        std::vector<float> loc_expression = GetExpression(a_actor);
+        //lower priority expression is only kept under higher priority layer of this stack, so it is shown once that layer
+        //is reset. If it is blocked only by faction rank (layer is not loaded or was set before save), it is refused
+        if (!loc_res && loc_stack.GetTopPriority(lMod) < loc_block) return false;
 
-        //check if its not same
-        if (loc_expression == a_expression) 
-        {
-            //WARN("Expression is same as previous one - returning")
-            return loc_expression;
-        }
-
-        RE::BSFaceGenAnimationData* loc_expdata = a_actor->GetFaceGenAnimationData();
-
-        if (loc_expdata == nullptr) return std::vector<float>();
-
-        RE::BSSpinLockGuard locker(loc_expdata->lock);
-
-        bool loc_phonems    = !IsGagged(a_actor);
-        bool loc_mods       = true;
-
-        //set phonems and modifiers 
-        for(int i = 0; i < a_expression.size();i++)
-        {
-            switch(i)
-            {
-                //phonems
-                case 0:  //Aah    
-                case 1:  //BigAah 
-                case 2:  //BMP    
-                case 3:  //ChJSh  
-                case 4:  //DST    
-                case 5:  //Eee    
-                case 6:  //Eh     
-                case 7:  //FV     
-                case 8:  //I      
-                case 9:  //K      
-                case 10: //N      
-                case 11: //Oh     
-                case 12: //OohQ   
-                case 13: //R      
-                case 14: //Th     
-                case 15: //W      
-                    if (loc_phonems) loc_expdata->phenomeKeyFrame.SetValue(i, a_expression[i]);
-                    break;
-                //modifiers
-                case 16: //BlinkLeft    
-                case 17: //BlinkRight   
-                case 18: //BrowDownLeft 
-                case 19: //BrowDownRight
-                case 20: //BrowInLeft   
-                case 21: //BrowInRight  
-                case 22: //BrowUpLeft   
-                case 23: //BrowUpRight  
-                case 24: //LookDown     
-                case 25: //LookLeft     
-                case 26: //LookRight    
-                case 27: //LookUp       
-                case 28: //SquintLeft   
-                case 29: //SquintRight  
-                    if (loc_mods) loc_expdata->modifierKeyFrame.SetValue(i - 16, a_expression[i]);
-                    break;
-            }
-        }
-
-        //apply expression override
-        if (loc_mods)
-        {
-            if ((loc_expression[30] != a_expression[30]) || (loc_expression[31] != a_expression[31]))
-            {
-                loc_expdata->exprOverride = false;
-                loc_expdata->SetExpressionOverride(std::lround(a_expression[30]),a_expression[31]);
-                loc_expdata->exprOverride = true;
-                
-            }
-        }
-
-        return GetExpression(a_actor);
+        loc_stack.SetLayer(lMod,a_priority,loc_exp,ExpressionAllMask,a_weight,(a_fadeTime >= 0.0f) ? a_fadeTime : _FadeTime);
+        if (loc_res) SetBlockPriority(a_actor,a_priority);
+        ComposeAndWrite(a_actor,loc_stack,0.0f);
+        return loc_res;
     }
 
-    std::vector<float> ExpressionManager::GetExpression(RE::Actor* a_actor)
+    Expression ExpressionManager::GetExpression(RE::Actor* a_actor)
     {
         LOG("GetExpression({}) called",a_actor ? a_actor->GetName() : "NONE")
 
-        if (a_actor == nullptr) return std::vector<float>(32,0.0f);
+        Expression loc_res;
+
+        if (a_actor == nullptr) return loc_res;
 
         RE::BSFaceGenAnimationData* loc_expdata = a_actor->GetFaceGenAnimationData();
         
-        if (loc_expdata == nullptr) return std::vector<float>(32,0.0f);
+        if (loc_expdata == nullptr) return loc_res;
 
-        std::vector<float> loc_res;
+        ReadFace(loc_expdata,loc_res);
+        return loc_res;
+    }
 
-        for (int i = 0; i < 16; i++) loc_res.push_back(loc_expdata->phenomeKeyFrame.values[i]); 
-        for (int i = 0; i < 14; i++) loc_res.push_back(loc_expdata->modifierKeyFrame.values[i]);
+    bool ExpressionManager::ReadFace(RE::BSFaceGenAnimationData* a_expdata, Expression& a_result)
+    {
+        //same lock as writes, so values are not read while the game or compositor changes them
+        RE::BSSpinLockGuard locker(a_expdata->lock);
 
+        for (int i = 0; i < Expression::PhonemeCount; i++) a_result[i] = a_expdata->phenomeKeyFrame.values[i];
+        for (int i = 0; i < Expression::ModifierCount; i++) a_result[Expression::ModifierOffset + i] = a_expdata->modifierKeyFrame.values[i];
 
         bool loc_found = false;
-        const size_t loc_count_exp = loc_expdata->expressionKeyFrame.count;
+        const size_t loc_count_exp = a_expdata->expressionKeyFrame.count;
         for (int i = 0; i < loc_count_exp;i++)
         {
-            if (loc_expdata->expressionKeyFrame.values[i] != 0.0f)
+            if (a_expdata->expressionKeyFrame.values[i] != 0.0f)
             {
-                loc_res.push_back(i);
-                loc_res.push_back(loc_expdata->expressionKeyFrame.values[i]);
+                a_result[Expression::ExpressionID]  = static_cast<float>(i);
+                a_result[Expression::ExpressionStr] = a_expdata->expressionKeyFrame.values[i];
                 loc_found = true;
                 break;
             }
@@ -180,22 +109,37 @@ namespace DeviousDevices
         if (!loc_found)
         {
             //add neutral mood
-            loc_res.push_back(7);
-            loc_res.push_back(0.5f);
+            a_result[Expression::ExpressionID]  = 7.0f;
+            a_result[Expression::ExpressionStr] = 0.5f;
         }
-
-
-        return loc_res;
+        return a_expdata->exprOverride;
     }
 
-    bool ExpressionManager::ResetExpression(RE::Actor* a_actor, int a_priority)
+    bool ExpressionManager::ResetExpression(RE::Actor* a_actor, int a_priority, float a_fadeTime)
     {
-        LOG("ResetExpression({},{}) called",a_actor ? a_actor->GetName() : "NONE",a_priority)
+        LOG("ResetExpression({},{},{}) called",a_actor ? a_actor->GetName() : "NONE",a_priority,a_fadeTime)
 
         if (a_actor == nullptr) return false;
-        
-        if (!CheckExpressionBlock(a_actor,a_priority,mReset)) return false;
 
+        {
+            UniqueLock lock(_LayerLock);
+            auto loc_it = _LayerStacks.find(a_actor->GetHandle().native_handle());
+            ExpressionLayerStack* loc_stack = (loc_it != _LayerStacks.end()) ? &loc_it->second : nullptr;
+
+            if (a_priority < GetBlockPriority(a_actor,loc_stack)) return false;
+
+            if (loc_stack != nullptr)
+            {
+                //layers fade out, and stack is released by UpdateLayers once it is empty
+                loc_stack->RemoveLayers(lMod,a_priority,(a_fadeTime >= 0.0f) ? a_fadeTime : _FadeTime);
+                SetBlockPriority(a_actor,std::max(loc_stack->GetTopPriority(lMod),0));
+                ComposeAndWrite(a_actor,*loc_stack,0.0f);
+                return true;
+            }
+            SetBlockPriority(a_actor,0);
+        }
+
+        //expression was not set by this plugin, so just clear it
         RE::BSFaceGenAnimationData* loc_expdata = a_actor->GetFaceGenAnimationData();
 
         if (loc_expdata == nullptr) return false;
@@ -210,148 +154,170 @@ namespace DeviousDevices
         return true;
     }
 
-    std::vector<float> ExpressionManager::FactionsToPreset(RE::Actor* a_actor, std::vector<RE::TESFaction*> a_factions, std::vector<int> a_defaults)
+    bool ExpressionManager::IsGagged(RE::Actor* a_actor) const
     {
-        if (a_actor == nullptr) return std::vector<float>(32,0.0f);
+        if (a_actor == nullptr) return false;
 
-        std::vector<float> loc_preset(32,0.0f);
+        const RE::TESObjectARMO* loc_gag = LibFunctions::GetSingleton()->GetWornArmor(a_actor,{"zad_DeviousGag","zadNG_GagOverride"},true);
+        return loc_gag != nullptr;
+    }
 
-        if (a_factions.size() > 0)
-        {
-            for(int i =0; i < a_factions.size();i++)
-            {
-                int loc_rank = std::clamp(a_actor->GetFactionRank(a_factions[i],a_actor->IsPlayer()),-1,100);
-                if (loc_rank >= 0)  (loc_preset[i] = loc_rank/100.0f);
-                else                (loc_preset[i] = a_defaults[i]/100.0f);
-            }
-        }
-        else
+    void ExpressionManager::UpdateLayers(float a_delta)
+    {
+        UniqueLock lock(_LayerLock);
+        for (auto it = _LayerStacks.begin(); it != _LayerStacks.end();)
         {
-            for(int i =0; i < a_defaults.size();i++)
+            RE::ActorPtr loc_actor = RE::Actor::LookupByHandle(it->first);
+            if (loc_actor == nullptr || !loc_actor->Is3DLoaded())
             {
-                loc_preset[i] = std::clamp(a_defaults[i],0,100)/100.0f;
+                UniqueLock cachelock(_GagCacheLock);
+                _GagPresetCache.Invalidate(it->first);
+                it = _LayerStacks.erase(it);
+                continue;
             }
+
+            if (!it->second.IsSettled()) ComposeAndWrite(loc_actor.get(),it->second,a_delta);
+
+            //last values were written, so there is nothing to keep
+            if (it->second.IsEmpty() && it->second.IsSettled()) it = _LayerStacks.erase(it);
+            else it++;
         }
-        return loc_preset;
     }
 
-    bool ExpressionManager::IsGagged(RE::Actor* a_actor) const
+    void ExpressionManager::Reload()
     {
-        if (a_actor == nullptr) return false;
+        UniqueLock lock(_LayerLock);
+        _LayerStacks.clear();
 
-        const RE::TESObjectARMO* loc_gag = LibFunctions::GetSingleton()->GetWornArmor(a_actor,{"zad_DeviousGag","zadNG_GagOverride"},true);
-        return loc_gag != nullptr;
+        UniqueLock cachelock(_GagCacheLock);
+        _GagPresetCache.Clear();
     }
 
-    void ExpressionManager::Reload()
+    void ExpressionManager::InvalidateGagPreset(RE::Actor* a_actor)
     {
-        UniqueLock lock(_SaveLock);
-        _UpdatedActors.clear();
+        UniqueLock lock(_GagCacheLock);
+        if (a_actor == nullptr) _GagPresetCache.InvalidateAll();
+        else _GagPresetCache.Invalidate(a_actor->GetHandle().native_handle());
     }
 
-    void ExpressionManager::CleanUnusedActors()
+    ExpressionLayerStack& ExpressionManager::GetLayerStack(RE::Actor* a_actor)
     {
-        UniqueLock lock(_SaveLock);
-        //DEBUG("CleanUnusedActors() called")
-        std::vector<RE::Actor*> loc_toremove;
-        for (auto&& [actor,updateHandle] : _UpdatedActors)
+        auto [loc_it,loc_created] = _LayerStacks.try_emplace(a_actor->GetHandle().native_handle());
+        if (loc_created)
         {
-            // If actor was not updated atleast for 3600 frames (60 seconds for 60 FPS), clean them
-            if ((updateHandle.lastUpdateFrame + 3600) < _UpdateCounter)
+            //layers fade in from the current face instead of from zero
+            RE::BSFaceGenAnimationData* loc_expdata = a_actor->GetFaceGenAnimationData();
+            if (loc_expdata != nullptr)
             {
-                //DEBUG("CleanUnusedActors() - Removing actor 0x{:016X}",(uintptr_t)actor)
-                loc_toremove.push_back(actor);
+                ComposedExpression loc_base;
+                loc_base.mood = ReadFace(loc_expdata,loc_base.values);
+                loc_it->second.SetBase(loc_base);
             }
         }
+        return loc_it->second;
+    }
+
+    int ExpressionManager::GetBlockPriority(RE::Actor* a_actor, const ExpressionLayerStack* a_stack) const
+    {
+        int loc_res = (a_stack != nullptr) ? a_stack->GetTopPriority(lMod) : INT_MIN;
 
-        for (auto&& actor : loc_toremove)
+        //layer stacks are not saved and are released when actor is unloaded, so the priority is also kept as faction rank
+        if (_BlockFaction != nullptr && a_actor->IsInFaction(_BlockFaction))
         {
-            _UpdatedActors.erase(actor);
+            loc_res = std::max(loc_res,static_cast<int>(a_actor->GetFactionRank(_BlockFaction,a_actor->IsPlayer())));
         }
+        return loc_res;
     }
 
-    void ExpressionManager::IncUpdateCounter()
+    void ExpressionManager::SetBlockPriority(RE::Actor* a_actor, int a_priority) const
     {
-        _UpdateCounter++;
+        if (_BlockFaction == nullptr) return;
+        if (a_actor->IsInFaction(_BlockFaction) && a_actor->GetFactionRank(_BlockFaction,a_actor->IsPlayer()) == a_priority) return;
+        a_actor->AddToFaction(_BlockFaction,static_cast<int8_t>(a_priority));
     }
 
-    void ExpressionManager::ApplyGagExpression(RE::Actor* a_actor, const std::vector<float>& a_expression)
+    void ExpressionManager::ComposeAndWrite(RE::Actor* a_actor, ExpressionLayerStack& a_stack, float a_delta)
     {
-        if (a_actor == nullptr) return;
+        ComposedExpression loc_exp;
+        const uint32_t loc_mask = a_stack.Compose(a_delta,loc_exp);
+        if (loc_mask != 0) WriteComposed(a_actor,loc_exp,loc_mask);
+    }
 
-        if (a_expression.size() != 16) 
-        {
-            ERROR("ExpressionManager::ApplyGagExpression - Expression is of incorrect size - returning")
-            return;
-        }
+    void ExpressionManager::WriteComposed(RE::Actor* a_actor, const ComposedExpression& a_expression, uint32_t a_mask)
+    {
+        if (a_actor == nullptr) return;
 
         RE::BSFaceGenAnimationData* loc_expdata = a_actor->GetFaceGenAnimationData();
 
         if (loc_expdata == nullptr) return;
 
-        RE::BSSpinLockGuard locker(loc_expdata->lock);
+        //diff is done on a copy read under short lock, so lock is only held for writes which are really needed.
+        //Values are compared with the face instead of last written ones, so values changed by the game are written again
+        Expression loc_current;
+        const bool loc_override = ReadFace(loc_expdata,loc_current);
 
-        //set phonems and modifiers 
-        for(int i = 0; i < 16;i++)
+        uint32_t loc_write = GetChangedChannels(loc_current,a_expression.values,a_mask & ~ExpressionMoodMask);
+        if (a_mask & ExpressionMoodMask)
         {
-            switch(i)
-            {
-                //phonems
-                case 0:  //Aah    
-                case 1:  //BigAah 
-                case 2:  //BMP    
-                case 3:  //ChJSh  
-                case 4:  //DST    
-                case 5:  //Eee    
-                case 6:  //Eh     
-                case 7:  //FV     
-                case 8:  //I      
-                case 9:  //K      
-                case 10: //N      
-                case 11: //Oh     
-                case 12: //OohQ   
-                case 13: //R      
-                case 14: //Th     
-                case 15: //W      
-                    loc_expdata->phenomeKeyFrame.SetValue(i, a_expression[i]);
-                    break;
-            }
+            //override can't be checked by value, as neutral mood is returned when there is no override
+            if (a_expression.mood != loc_override) loc_write |= ExpressionMoodMask;
+            else if (a_expression.mood) loc_write |= GetChangedChannels(loc_current,a_expression.values,ExpressionMoodMask);
         }
 
-        //prevent Combat shout expression as it makes gag looking worse
-        if (loc_expdata->phenomeKeyFrame.values[30] == 16) loc_expdata->SetExpressionOverride(16,0);
+        const uint32_t loc_requested = std::popcount(a_mask & ~ExpressionMoodMask) + ((a_mask & ExpressionMoodMask) ? 1 : 0);
+        const uint32_t loc_written   = std::popcount(loc_write & ~ExpressionMoodMask) + ((loc_write & ExpressionMoodMask) ? 1 : 0);
+        _WriteStats.skipped += loc_requested - loc_written;
 
-    }
+        if (loc_write == 0) return;
 
-    bool ExpressionManager::CheckExpressionBlock(RE::Actor* a_actor, int a_priority, BlockCheckMode a_mode)
-    {
-        if (!a_actor->IsInFaction(_BlockFaction))
+        const auto loc_start = std::chrono::steady_clock::now();
         {
-            if (a_mode == mSet)
+            RE::BSSpinLockGuard locker(loc_expdata->lock);
+
+            for (int i = 0; i < Expression::PhonemeCount; i++)
             {
-                a_actor->AddToFaction(_BlockFaction,a_priority);
+                if (loc_write & (1U << i)) loc_expdata->phenomeKeyFrame.SetValue(i, a_expression.values[i]);
             }
-            return true;
-        }
-
-        if (a_priority >= a_actor->GetFactionRank(_BlockFaction,a_actor->IsPlayer()))
-        {
-            if (a_mode == mSet)
+            for (int i = 0; i < Expression::ModifierCount; i++)
             {
-                a_actor->AddToFaction(_BlockFaction,a_priority);
-                return true;
+                if (loc_write & (1U << (Expression::ModifierOffset + i))) loc_expdata->modifierKeyFrame.SetValue(i, a_expression.values[Expression::ModifierOffset + i]);
             }
-            else if (a_mode == mReset)
+
+            if (loc_write & ExpressionMoodMask)
             {
-                a_actor->AddToFaction(_BlockFaction,0);
-                return true;
+                if (a_expression.mood)
+                {
+                    loc_expdata->exprOverride = false;
+                    loc_expdata->SetExpressionOverride(std::lround(a_expression.values[Expression::ExpressionID]),a_expression.values[Expression::ExpressionStr]);
+                    loc_expdata->exprOverride = true;
+                }
+                else
+                {
+                    loc_expdata->ClearExpressionOverride();
+                }
             }
-        
         }
-        return false;
+        const uint64_t loc_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - loc_start).count();
+
+        _WriteStats.written    += loc_written;
+        _WriteStats.locks      += 1;
+        _WriteStats.lockTime   += loc_time;
+        uint64_t loc_max = _WriteStats.maxLockTime;
+        while (loc_time > loc_max && !_WriteStats.maxLockTime.compare_exchange_weak(loc_max,loc_time)) {}
+    }
+
+    ExpressionManager::WriteStats ExpressionManager::GetWriteStats(bool a_reset)
+    {
+        WriteStats loc_res;
+        loc_res.written     = a_reset ? _WriteStats.written.exchange(0)     : _WriteStats.written.load();
+        loc_res.skipped     = a_reset ? _WriteStats.skipped.exchange(0)     : _WriteStats.skipped.load();
+        loc_res.locks       = a_reset ? _WriteStats.locks.exchange(0)       : _WriteStats.locks.load();
+        loc_res.lockTime    = a_reset ? _WriteStats.lockTime.exchange(0)    : _WriteStats.lockTime.load();
+        loc_res.maxLockTime = a_reset ? _WriteStats.maxLockTime.exchange(0) : _WriteStats.maxLockTime.load();
+        return loc_res;
     }
 
-    void ExpressionManager::ApplyPhonemsFaction(RE::Actor* a_actor, std::vector<float>& a_exp, std::vector<RE::TESFaction*> a_factions, std::vector<int> a_defaults)
+    void ExpressionManager::ApplyPhonemsFaction(RE::Actor* a_actor, GagPreset& a_exp, const std::vector<RE::TESFaction*>& a_factions, const std::vector<int>& a_defaults)
     {
         if (a_actor == nullptr) return;
 
@@ -366,7 +332,7 @@ namespace DeviousDevices
         }
         else
         {
-            for(int i = 0; i < a_defaults.size();i++)
+            for(int i = 0; i < std::min(a_defaults.size(),GagPreset::Size);i++)
             {
                 a_exp[i] = std::clamp(a_defaults[i],0,100)/100.0f;
             }
@@ -375,48 +341,30 @@ namespace DeviousDevices
 
     void ExpressionManager::UpdateGagExpression(RE::Actor* a_actor)
     {
+        DD_PROFILE_SCOPE(pUpdateGagExpression)
         if (a_actor == nullptr) return;
 
-        const std::vector<float> loc_new = GetGagEffectPreset(a_actor);
+        GagPreset loc_new;
+        const bool loc_gagged = GetGagEffectPreset(a_actor,loc_new);
 
-        if (loc_new.size() > 0)
+        UniqueLock lock(_LayerLock);
+        if (loc_gagged)
         {
-            ApplyGagExpression(a_actor,loc_new);
-        }
-    }
+            Expression loc_exp;
+            std::copy(loc_new.values.begin(),loc_new.values.end(),loc_exp.values.begin());
 
-    void ExpressionManager::UpdateGagExpressionTimed(RE::Actor* a_actor)
-    {
-        UniqueLock lock(_SaveLock);
-        //DEBUG("UpdateGagExpressionTimed({}) called",a_actor ? a_actor->GetName() : "NONE")
-
-        if (!a_actor) return;
-
-        auto loc_refBase = a_actor->GetActorBase();
-        if(a_actor->IsDisabled() || !a_actor->Is3DLoaded() || !(a_actor->Is(RE::FormType::NPC) || (loc_refBase && loc_refBase->Is(RE::FormType::NPC))))
-        {
-            LOG("ExpressionManager::UpdateGagExpressionTimed({}) - Actor is invalid",a_actor ? a_actor->GetName() : "NONE")
-            return;
+            ExpressionLayerStack& loc_stack = GetLayerStack(a_actor);
+            loc_stack.SetLayer(lGag,GagLayerPriority,loc_exp,ExpressionPhonemeMask,1.0f,_GagFadeTime);
+            ComposeAndWrite(a_actor,loc_stack,0.0f);
         }
-
-        auto loc_id = _UpdatedActors.find(a_actor);
-
-        if (loc_id == _UpdatedActors.end())
-        {
-            _UpdatedActors[a_actor] = {0,_UpdateCounter};
-            LOG("ExpressionManager::UpdateGagExpressionTimed({}) - Actor registered",a_actor ? a_actor->GetName() : "NONE")
-            return;
-        }
-
-        loc_id->second.elapsedFrames++;
-        loc_id->second.lastUpdateFrame   = _UpdateCounter;
-
-        //DEBUG("ExpressionManager::UpdateGagExpressionTimed({}) - Elapsed frames = {}, Total Frames = {}",a_actor ? a_actor->GetName() : "NONE",loc_id->second.elapsedFrames,loc_id->second.lastUpdateFrame)
-
-        if (loc_id->second.elapsedFrames >= _NPCUpdateTime)
+        else
         {
-            loc_id->second.elapsedFrames -= _NPCUpdateTime;
-            UpdateGagExpression(a_actor);
+            //do not create stacks for actors which were never gagged
+            auto loc_it = _LayerStacks.find(a_actor->GetHandle().native_handle());
+            if (loc_it != _LayerStacks.end() && loc_it->second.RemoveLayers(lGag,GagLayerPriority,_GagFadeTime) > 0)
+            {
+                ComposeAndWrite(a_actor,loc_it->second,0.0f);
+            }
         }
     }
 
@@ -426,6 +374,18 @@ namespace DeviousDevices
         
         if (IsGagged(a_actor)) return;
 
+        {
+            UniqueLock lock(_LayerLock);
+            auto loc_it = _LayerStacks.find(a_actor->GetHandle().native_handle());
+            if (loc_it != _LayerStacks.end())
+            {
+                //phonemes fade back to the ones set by mods
+                loc_it->second.RemoveLayers(lGag,GagLayerPriority,_GagFadeTime);
+                ComposeAndWrite(a_actor,loc_it->second,0.0f);
+                return;
+            }
+        }
+
         RE::BSFaceGenAnimationData* loc_expdata = a_actor->GetFaceGenAnimationData();
 
         if (loc_expdata == nullptr) return;
@@ -452,7 +412,10 @@ namespace DeviousDevices
         });
         if (loc_foundit != _GagTypes.end()) return false;
 
+        UniqueLock lock(_GagCacheLock);
         _GagTypes.push_back({a_keyword,a_factions,a_defaults});
+        _GagTypeIndex.Add(a_keyword,_GagTypes.size() - 1);
+        _GagPresetCache.InvalidateAll();
         return true;
     }
 
@@ -465,66 +428,81 @@ namespace DeviousDevices
             return false;
         }
 
+        UniqueLock lock(_GagCacheLock);
         _DefaultGagType = {nullptr,a_factions,a_defaults};
+        _GagPresetCache.InvalidateAll();
 
         return true;
     }
 
-    std::vector<float> ExpressionManager::ApplyStrengthToExpression(const std::vector<float>& a_expression, float a_strength)
+    RE::TESObjectARMO* ExpressionManager::GetWornGag(RE::Actor* a_actor) const
     {
-        if (a_expression.size() != 32) return a_expression;
-
-        std::vector<float> loc_res = a_expression;
+        if (a_actor == nullptr) return nullptr;
 
-        const float loc_mult  = std::clamp(a_strength,0.0f,1.0f);
-
-        for (int i = 0; i < 30; i++)
+        //gag override takes precedence over gag in mouth slot. Both are found in single pass over worn items
+        RE::TESObjectARMO* loc_override = nullptr;
+        RE::TESObjectARMO* loc_mouth    = nullptr;
+        auto loc_visitor = WornVisitor([&loc_override,&loc_mouth](RE::InventoryEntryData* a_entry)
         {
-            loc_res[i] *= loc_mult;
-        }
+            #undef GetObject
+            auto loc_object = a_entry->GetObject();
+            if (loc_object == nullptr || !loc_object->IsArmor()) return RE::BSContainer::ForEachResult::kContinue;
 
-        loc_res[31] *= loc_mult;
+            RE::TESObjectARMO* loc_armor = static_cast<RE::TESObjectARMO*>(loc_object);
+            if (loc_armor->HasKeywordString("zadNG_GagOverride"))
+            {
+                loc_override = loc_armor;
+                return RE::BSContainer::ForEachResult::kStop;
+            }
+            if (loc_mouth == nullptr && ((int)loc_armor->GetSlotMask() & (int)RE::BIPED_MODEL::BipedObjectSlot::kModMouth))
+            {
+                loc_mouth = loc_armor;
+            }
+            return RE::BSContainer::ForEachResult::kContinue;
+        });
+        a_actor->GetInventoryChanges()->VisitWornItems(loc_visitor.AsNativeVisitor());
 
-        return loc_res;
+        if (loc_override != nullptr) return loc_override;
+        if (loc_mouth != nullptr && loc_mouth->HasKeywordString("zad_DeviousGag")) return loc_mouth;
+        return nullptr;
     }
 
-    std::vector<float> ExpressionManager::GetGagEffectPreset(RE::Actor* a_actor)
+    bool ExpressionManager::GetGagEffectPreset(RE::Actor* a_actor, GagPreset& a_preset)
     {
-        const RE::TESObjectARMO* loc_gag = nullptr;
+        const RE::TESObjectARMO* loc_gag = GetWornGag(a_actor);
+        const uint32_t loc_handle = a_actor->GetHandle().native_handle();
 
-        const RE::TESObjectARMO* loc_gagoverride = LibFunctions::GetSingleton()->GetWornArmor(a_actor,"zadNG_GagOverride");
+        UniqueLock lock(_GagCacheLock);
 
-        if (loc_gagoverride == nullptr)
+        //preset of removed gag would be kept until actor is unloaded
+        if (loc_gag == nullptr)
         {
-            loc_gag = LibFunctions::GetSingleton()->GetWornArmor(a_actor,(int)RE::BIPED_MODEL::BipedObjectSlot::kModMouth);
-
-            if (loc_gag == nullptr || !loc_gag->HasKeywordString("zad_DeviousGag")) return std::vector<float>();
+            _GagPresetCache.Invalidate(loc_handle);
+            return false;
         }
-        else
+
+        const GagPreset* loc_cached = _GagPresetCache.Find(loc_handle,loc_gag->GetFormID());
+        if (loc_cached != nullptr)
         {
-            loc_gag = loc_gagoverride;
+            a_preset = *loc_cached;
+            return true;
         }
 
-        std::vector<float> loc_res(16,0);
+        a_preset = GagPreset();
 
-        bool loc_gagtypefound = false;
-        for (auto&& it : _GagTypes)
+        const size_t loc_type = _GagTypeIndex.Find(loc_gag->keywords,loc_gag->numKeywords);
+        if (loc_type != GagTypeIndex::npos)
         {
-            if (loc_gag->HasKeyword(it.keyword))
-            {
-                ApplyPhonemsFaction(a_actor,loc_res,it.factions,it.defaults);
-                loc_gagtypefound = true;
-                break;
-            }
+            const GagType& loc_gagtype = _GagTypes[loc_type];
+            ApplyPhonemsFaction(a_actor,a_preset,loc_gagtype.factions,loc_gagtype.defaults);
         }
-
-        //check if gag type was found. If not, use default one
-        if (!loc_gagtypefound) 
+        else
         {
-            //WARN("No gag type found! Using default type")
-            ApplyPhonemsFaction(a_actor,loc_res,_DefaultGagType.factions,_DefaultGagType.defaults);
+            //no gag type found, use default one
+            ApplyPhonemsFaction(a_actor,a_preset,_DefaultGagType.factions,_DefaultGagType.defaults);
         }
 
-        return loc_res;
+        _GagPresetCache.Store(loc_handle,loc_gag->GetFormID(),a_preset);
+        return true;
     }
 }
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "ExpressionLayers.h"
+
+uint32_t DeviousDevices::GetChangedChannels(const Expression& a_current, const Expression& a_target, uint32_t a_mask, float a_epsilon)
+{
+    uint32_t loc_res = 0;
+    for (size_t i = 0; i < Expression::ExpressionID; i++)
+    {
+        if ((a_mask & (1U << i)) && std::abs(a_target[i] - a_current[i]) > a_epsilon) loc_res |= (1U << i);
+    }
+
+    if ((a_mask & ExpressionMoodMask) &&
+        (a_target[Expression::ExpressionID] != a_current[Expression::ExpressionID] ||
+         std::abs(a_target[Expression::ExpressionStr] - a_current[Expression::ExpressionStr]) > a_epsilon))
+    {
+        loc_res |= ExpressionMoodMask;
+    }
+    return loc_res;
+}
+
+float DeviousDevices::ExpressionLayerStack::GetSpeed(float a_fadeTime)
+{
+    return (a_fadeTime > 0.0f) ? 1.0f/a_fadeTime : 0.0f;
+}
+
+DeviousDevices::Expression DeviousDevices::ExpressionLayerStack::Layer::GetValues() const
+{
+    if (progress >= 1.0f) return target;
+
+    Expression loc_res;
+    for (size_t i = 0; i < Expression::Size; i++)
+    {
+        loc_res[i] = from[i] + (target[i] - from[i])*progress;
+    }
+    //mood id can't be interpolated
+    loc_res[Expression::ExpressionID] = target[Expression::ExpressionID];
+    return loc_res;
+}
+
+void DeviousDevices::ExpressionLayerStack::SetBase(const ComposedExpression& a_base)
+{
+    //base is what is already on the face, so it does not have to be written
+    _base = a_base;
+    if (_layers.empty())
+    {
+        _last   = a_base;
+        _dirty  = false;
+    }
+    else
+    {
+        _dirty  = true;
+    }
+}
+
+void DeviousDevices::ExpressionLayerStack::SetLayer(ExpressionLayerType a_type, int a_priority, const Expression& a_values, uint32_t a_mask, float a_weight, float a_fadeTime)
+{
+    const float loc_speed = GetSpeed(a_fadeTime);
+
+    auto loc_it = std::find_if(_layers.begin(),_layers.end(),[&](const Layer& a_layer)
+    {
+        return a_layer.type == a_type && a_layer.priority == a_priority;
+    });
+
+    if (loc_it != _layers.end())
+    {
+        loc_it->from        = loc_it->GetValues();
+        loc_it->target      = a_values;
+        loc_it->progress    = (loc_speed > 0.0f && loc_it->fade > 0.0f) ? 0.0f : 1.0f;
+        loc_it->mask        = a_mask;
+        loc_it->weight      = std::clamp(a_weight,0.0f,1.0f);
+        loc_it->fadeSpeed   = loc_speed;
+        loc_it->removing    = false;
+    }
+    else
+    {
+        Layer loc_layer;
+        loc_layer.type      = a_type;
+        loc_layer.priority  = a_priority;
+        loc_layer.mask      = a_mask;
+        loc_layer.weight    = std::clamp(a_weight,0.0f,1.0f);
+        loc_layer.fadeSpeed = loc_speed;
+        loc_layer.from      = a_values;
+        loc_layer.target    = a_values;
+
+        const auto loc_pos = std::upper_bound(_layers.begin(),_layers.end(),loc_layer,[](const Layer& a_first, const Layer& a_second)
+        {
+            return std::tie(a_first.priority,a_first.type) < std::tie(a_second.priority,a_second.type);
+        });
+        _layers.insert(loc_pos,loc_layer);
+    }
+
+    //values are written again even if they did not change, as game could have changed them in meantime
+    _forceMask |= a_mask;
+    _dirty = true;
+}
+
+size_t DeviousDevices::ExpressionLayerStack::RemoveLayers(ExpressionLayerType a_type, int a_maxPriority, float a_fadeTime)
+{
+    size_t loc_res = 0;
+    for (auto&& it : _layers)
+    {
+        if (it.type == a_type && it.priority <= a_maxPriority && !it.removing)
+        {
+            it.removing  = true;
+            it.fadeSpeed = GetSpeed(a_fadeTime);
+            _forceMask |= it.mask;
+            loc_res++;
+        }
+    }
+    if (loc_res > 0) _dirty = true;
+    return loc_res;
+}
+
+int DeviousDevices::ExpressionLayerStack::GetTopPriority(ExpressionLayerType a_type) const
+{
+    for (auto it = _layers.rbegin(); it != _layers.rend(); it++)
+    {
+        if (it->type == a_type && !it->removing) return it->priority;
+    }
+    return INT_MIN;
+}
+
+uint32_t DeviousDevices::ExpressionLayerStack::Compose(float a_delta, ComposedExpression& a_result)
+{
+    if (IsSettled())
+    {
+        a_result = _last;
+        return 0;
+    }
+
+    //advance fades
+    bool loc_changing = false;
+    for (auto&& it : _layers)
+    {
+        const float loc_step = (it.fadeSpeed > 0.0f) ? a_delta*it.fadeSpeed : 1.0f;
+        it.fade     = std::clamp(it.fade + (it.removing ? -loc_step : loc_step),0.0f,1.0f);
+        it.progress = std::min(it.progress + loc_step,1.0f);
+        loc_changing |= it.removing ? (it.fade > 0.0f) : (it.fade < 1.0f || it.progress < 1.0f);
+    }
+    std::erase_if(_layers,[](const Layer& a_layer){ return a_layer.removing && a_layer.fade <= 0.0f; });
+
+    //blend from lowest priority to highest
+    ComposedExpression loc_res = _base;
+    for (auto&& it : _layers)
+    {
+        const float loc_weight = it.weight*it.fade;
+        if (loc_weight <= 0.0f) continue;
+
+        const Expression loc_values = it.GetValues();
+        for (size_t i = 0; i < Expression::ExpressionID; i++)
+        {
+            if (it.mask & (1U << i)) loc_res.values[i] += (loc_values[i] - loc_res.values[i])*loc_weight;
+        }
+
+        if ((it.mask & ExpressionMoodMask) == ExpressionMoodMask)
+        {
+            //mood can't be blended, so top layer wins. Strength fades from the previous mood only if it is the same one
+            const float loc_prev = (loc_res.mood && loc_res.values[Expression::ExpressionID] == loc_values[Expression::ExpressionID]) ? loc_res.values[Expression::ExpressionStr] : 0.0f;
+            loc_res.values[Expression::ExpressionID]  = loc_values[Expression::ExpressionID];
+            loc_res.values[Expression::ExpressionStr] = loc_prev + (loc_values[Expression::ExpressionStr] - loc_prev)*loc_weight;
+            loc_res.mood = true;
+        }
+    }
+
+    uint32_t loc_changed = _forceMask;
+    for (size_t i = 0; i < Expression::ExpressionID; i++)
+    {
+        if (loc_res.values[i] != _last.values[i]) loc_changed |= (1U << i);
+    }
+    if (loc_res.mood != _last.mood ||
+        loc_res.values[Expression::ExpressionID] != _last.values[Expression::ExpressionID] ||
+        loc_res.values[Expression::ExpressionStr] != _last.values[Expression::ExpressionStr])
+    {
+        loc_changed |= ExpressionMoodMask;
+    }
+
+    _last       = loc_res;
+    _forceMask  = 0;
+    _dirty      = loc_changing;
+    a_result    = loc_res;
+    return loc_changed;
+}
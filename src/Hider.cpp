@@ -148,9 +148,9 @@ bool DeviousDevices::DeviceHiderManager::ProcessHider(RE::TESObjectARMO* a_armor
 {
     std::unordered_map<RE::TESObjectARMO*,uint32_t> loc_devices;
 
-    static const bool loc_onlydevices = ConfigManager::GetSingleton()->GetVariable<bool>("DeviceHider.bOnlyDevices",true);
+    const bool loc_onlydevices = ConfigManager::GetSingleton()->GetConfig().DeviceHider_bOnlyDevices;
 
-    auto loc_visitor = WornVisitor([this,&loc_devices](RE::InventoryEntryData* a_entry)
+    auto loc_visitor = WornVisitor([this,&loc_devices,loc_onlydevices](RE::InventoryEntryData* a_entry)
     {
         #undef GetObject
         //LOG("DeviceHiderManager::ProcessHider() - Visited = {} {:08X}",a_entry->GetDisplayName(),a_entry->GetObject()->GetFormID())
@@ -178,7 +178,7 @@ inline uint16_t DeviousDevices::DeviceHiderManager::UpdateActors3D()
 
     Update3DSafe(loc_player);
 
-    if (!ConfigManager::GetSingleton()->GetVariable<bool>("DeviceHider.bNPCsEnabled", true)) {
+    if (!ConfigManager::GetSingleton()->GetConfig().DeviceHider_bNPCsEnabled) {
         return 1;
     }
 
@@ -316,6 +316,7 @@ void DeviousDevices::DeviceHiderManager::InitWornArmorAddon(RE::TESObjectARMA* a
 
 void DeviousDevices::DeviceHiderManager::InitWornArmor(RE::TESObjectARMO* a_armor, RE::Actor* a_actor, RE::BSTSmartPointer<RE::BipedAnim>* a_biped)
 {
+    DD_PROFILE_SCOPE(pInitWornArmor)
     RE::TESRace*    loc_race    = a_actor->GetRace();
     RE::SEX         loc_sex     = a_actor->GetActorBase()->GetSex();
     //LOG("InitWornArmor called")
@@ -370,6 +371,7 @@ void DeviousDevices::DeviceHiderManager::Update3DSafe(RE::Actor* a_actor)
     auto loc_handle = a_actor->GetHandle();
     SKSE::GetTaskInterface()->AddTask([loc_handle]
     {
+        DD_TRACE_SCOPE("Update3DSafe")
         if (auto actor = loc_handle.get(); actor && actor->Is3DLoaded()) {
             Update3D(actor.get());
         }
@@ -26,7 +26,7 @@ void DeviousDevices::HooksVirtual::ProcessButton(RE::MovementHandler* a_this, RE
         loc_running = a_data->running;
     }
 
-    static auto loc_kwds = ConfigManager::GetSingleton()->GetArrayText("Movement.asForceWalkKeywords",false);
+    const auto& loc_kwds = ConfigManager::GetSingleton()->GetConfig().Movement_asForceWalkKeywords;
     
     for (auto&& it :loc_kwds)
     {
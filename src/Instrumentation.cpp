@@ -0,0 +1,224 @@
+#include "Instrumentation.h"
+
+namespace DeviousDevices
+{
+    Spinlock                                                Instrumentation::_threadsLock;
+    std::vector<std::unique_ptr<Instrumentation::ThreadData>> Instrumentation::_threads;
+    std::array<LatencyHistogram,pZoneCount>                 Instrumentation::_previous;
+    std::chrono::steady_clock::time_point                   Instrumentation::_previousTime = std::chrono::steady_clock::now();
+
+    uint64_t LatencyHistogram::GetPercentile(double a_percentile) const
+    {
+        if (_total == 0) return 0;
+        const uint64_t loc_rank = std::max<uint64_t>(1,static_cast<uint64_t>(std::ceil(a_percentile/100.0*_total)));
+        uint64_t loc_sum = 0;
+        for (size_t i = 0; i < Buckets; i++)
+        {
+            loc_sum += _counts[i];
+            if (loc_sum >= loc_rank)
+            {
+                const uint64_t loc_low  = GetBucketValue(i);
+                const uint64_t loc_high = (i + 1 < Buckets) ? GetBucketValue(i + 1) : loc_low;
+                return loc_low + (loc_high - loc_low)/2;
+            }
+        }
+        return GetBucketValue(Buckets - 1);
+    }
+
+    void TraceBuffer::Add(const char* a_name, uint64_t a_start, uint64_t a_duration)
+    {
+        //reader checks _reserved after copying, so it knows which slots could have been overwritten during copy
+        const uint64_t loc_index = _written.load(std::memory_order_relaxed);
+        _reserved.store(loc_index + 1,std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        Slot& loc_slot = _slots[loc_index % _slots.size()];
+        loc_slot.name.store(a_name,std::memory_order_relaxed);
+        loc_slot.start.store(a_start,std::memory_order_relaxed);
+        loc_slot.duration.store(a_duration,std::memory_order_relaxed);
+
+        _written.store(loc_index + 1,std::memory_order_release);
+    }
+
+    std::vector<TraceBuffer::Event> TraceBuffer::Read() const
+    {
+        const uint64_t loc_capacity = _slots.size();
+        const uint64_t loc_end      = _written.load(std::memory_order_acquire);
+        const uint64_t loc_begin    = (loc_end > loc_capacity) ? loc_end - loc_capacity : 0;
+
+        std::vector<Event> loc_res;
+        loc_res.reserve(static_cast<size_t>(loc_end - loc_begin));
+        for (uint64_t i = loc_begin; i < loc_end; i++)
+        {
+            const Slot& loc_slot = _slots[i % loc_capacity];
+            loc_res.push_back({loc_slot.name.load(std::memory_order_relaxed),loc_slot.start.load(std::memory_order_relaxed),loc_slot.duration.load(std::memory_order_relaxed)});
+        }
+
+        //slot of event i is reused by event i + capacity. Every event below this index could be partially overwritten
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t loc_reserved = _reserved.load(std::memory_order_relaxed);
+        const uint64_t loc_valid    = (loc_reserved > loc_capacity) ? loc_reserved - loc_capacity : 0;
+        if (loc_valid > loc_begin) loc_res.erase(loc_res.begin(),loc_res.begin() + static_cast<ptrdiff_t>(std::min(loc_valid,loc_end) - loc_begin));
+        return loc_res;
+    }
+
+    Instrumentation::ThreadData& Instrumentation::GetThreadData()
+    {
+        thread_local ThreadData* loc_data = nullptr;
+        if (loc_data == nullptr)
+        {
+            auto loc_new = std::make_unique<ThreadData>();
+            loc_data = loc_new.get();
+            UniqueLock lock(_threadsLock);
+            loc_new->index = static_cast<uint32_t>(_threads.size());
+            _threads.push_back(std::move(loc_new));
+        }
+        return *loc_data;
+    }
+
+    void Instrumentation::Record(ProfileZone a_zone, uint64_t a_ns)
+    {
+        //only this thread writes, so plain load + store is enough
+        ZoneData& loc_zone = GetThreadData().zones[a_zone];
+        std::atomic<uint64_t>& loc_bucket = loc_zone.buckets[LatencyHistogram::GetBucket(a_ns)];
+        loc_bucket.store(loc_bucket.load(std::memory_order_relaxed) + 1,std::memory_order_relaxed);
+        if (a_ns > loc_zone.max.load(std::memory_order_relaxed)) loc_zone.max.store(a_ns,std::memory_order_relaxed);
+    }
+
+    std::array<ZoneStats,pZoneCount> Instrumentation::Collect()
+    {
+        UniqueLock lock(_threadsLock);
+
+        std::array<LatencyHistogram,pZoneCount> loc_totals;
+        std::array<uint64_t,pZoneCount>         loc_max = {};
+        for (auto&& it : _threads)
+        {
+            for (size_t z = 0; z < pZoneCount; z++)
+            {
+                const ZoneData& loc_zone = it->zones[z];
+                for (size_t b = 0; b < LatencyHistogram::Buckets; b++)
+                {
+                    const uint64_t loc_count = loc_zone.buckets[b].load(std::memory_order_relaxed);
+                    loc_totals[z]._counts[b] += loc_count;
+                    loc_totals[z]._total     += loc_count;
+                }
+                //max is since start, as it can't be reset by collector
+                loc_max[z] = std::max(loc_max[z],loc_zone.max.load(std::memory_order_relaxed));
+            }
+        }
+
+        const auto loc_now = std::chrono::steady_clock::now();
+        const double loc_elapsed = std::max(std::chrono::duration<double>(loc_now - _previousTime).count(),1e-9);
+
+        std::array<ZoneStats,pZoneCount> loc_res;
+        for (size_t z = 0; z < pZoneCount; z++)
+        {
+            LatencyHistogram loc_delta;
+            for (size_t b = 0; b < LatencyHistogram::Buckets; b++) loc_delta._counts[b] = loc_totals[z]._counts[b] - _previous[z]._counts[b];
+            loc_delta._total = loc_totals[z]._total - _previous[z]._total;
+
+            ZoneStats& loc_stats = loc_res[z];
+            loc_stats.name  = GetZoneName(static_cast<ProfileZone>(z));
+            loc_stats.calls = loc_delta.GetCount();
+            loc_stats.rate  = loc_stats.calls/loc_elapsed;
+            loc_stats.p50   = loc_delta.GetPercentile(50.0);
+            loc_stats.p95   = loc_delta.GetPercentile(95.0);
+            loc_stats.p99   = loc_delta.GetPercentile(99.0);
+            loc_stats.max   = loc_max[z];
+        }
+        _previous       = loc_totals;
+        _previousTime   = loc_now;
+        return loc_res;
+    }
+
+    const char* Instrumentation::GetZoneName(ProfileZone a_zone)
+    {
+        static constexpr std::array<const char*,pZoneCount> loc_names =
+        {
+            "InitWornArmor","EquipObject2","EquipFilter","UpdatePlayer","UpdateCharacter","UpdateGagExpression","NodeHiderUpdate","DeviceReader"
+        };
+        return (a_zone < pZoneCount) ? loc_names[a_zone] : "Unknown";
+    }
+
+    void Instrumentation::Setup()
+    {
+        auto loc_apply = [](const ConfigSnapshot& a_config)
+        {
+            SetEnabled(a_config.Main_bProfiling);
+            SetTracing(a_config.Main_bTracing,static_cast<size_t>(std::max(a_config.Main_iTraceBufferSize,1)));
+        };
+        loc_apply(ConfigManager::GetSingleton()->GetConfig());
+        ConfigManager::GetSingleton()->AddReloadListener([loc_apply](const ConfigSnapshot&, const ConfigSnapshot& a_new)
+        {
+            loc_apply(a_new);
+        });
+    }
+
+    void Instrumentation::SetTracing(bool a_enabled, size_t a_bufferSize)
+    {
+        //threads which already have buffer keep its size, as buffer can't be safely replaced while its thread writes to it
+        _traceBufferSize.store(a_bufferSize,std::memory_order_relaxed);
+        _tracing.store(a_enabled,std::memory_order_relaxed);
+    }
+
+    void Instrumentation::Trace(const char* a_name, std::chrono::steady_clock::time_point a_start, std::chrono::steady_clock::time_point a_end)
+    {
+        ThreadData& loc_data = GetThreadData();
+        if (loc_data.trace == nullptr)
+        {
+            auto loc_buffer = std::make_unique<TraceBuffer>(_traceBufferSize.load(std::memory_order_relaxed),loc_data.index);
+            UniqueLock lock(_threadsLock);
+            loc_data.trace = std::move(loc_buffer);
+        }
+        loc_data.trace->Add(a_name,
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(a_start.time_since_epoch()).count(),
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(a_end - a_start).count());
+    }
+
+    void Instrumentation::ExportTrace(std::ostream& a_stream, size_t* a_count)
+    {
+        std::vector<std::pair<uint32_t,std::vector<TraceBuffer::Event>>> loc_threads;
+        {
+            UniqueLock lock(_threadsLock);
+            for (auto&& it : _threads)
+            {
+                if (it->trace) loc_threads.emplace_back(it->trace->GetThread(),it->trace->Read());
+            }
+        }
+
+        //timestamps are made relative to first event, so they are easier to read
+        uint64_t loc_origin = UINT64_MAX;
+        for (auto&& [thread,events] : loc_threads)
+        {
+            for (auto&& it : events) loc_origin = std::min(loc_origin,it.start);
+        }
+
+        size_t loc_count = 0;
+        a_stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        a_stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"DeviousDevicesNG\"}}";
+        char loc_line[256];
+        for (auto&& [thread,events] : loc_threads)
+        {
+            a_stream << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread << ",\"args\":{\"name\":\"Thread " << thread << "\"}}";
+            for (auto&& it : events)
+            {
+                //names are literals from source code, so they need no escaping
+                std::snprintf(loc_line,sizeof(loc_line),",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    it.name ? it.name : "Unknown",thread,(it.start - loc_origin)/1000.0,it.duration/1000.0);
+                a_stream << loc_line;
+                loc_count++;
+            }
+        }
+        a_stream << "\n]}\n";
+        if (a_count) *a_count = loc_count;
+    }
+
+    int64_t Instrumentation::ExportTrace(const std::filesystem::path& a_path)
+    {
+        std::ofstream loc_file(a_path,std::ios::out | std::ios::trunc);
+        if (!loc_file.is_open()) return -1;
+        size_t loc_count = 0;
+        ExportTrace(loc_file,&loc_count);
+        return static_cast<int64_t>(loc_count);
+    }
+}
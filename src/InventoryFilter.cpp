@@ -22,25 +22,32 @@ RE::TESObjectARMO* DeviousDevices::InventoryFilter::GetWornWithDeviousKeyword(RE
 }
 
 bool DeviousDevices::InventoryFilter::TakeFilter(RE::Actor* a_actor, RE::TESBoundObject* obj) {
-    if (!Settings::GetSingleton().GetSetting<bool>("mittensDropToggle") || obj == nullptr || obj->GetName() == "" ||
-        a_actor->GetFormID() != 20 || UI::GetMenu<RE::BarterMenu>().get())
-        return false;
+    if (a_actor == nullptr || a_actor->GetFormID() != 20) return false;
+
+    UniqueLock lock(_takeLock);
+
+    // Taking all items from container calls this for every item, so worn mittens and menus are only checked once per batch,
+    // and every notification is shown only once per batch
+    if (_takeBatch.Next()) {
+        _takeState.enabled = Settings::GetSingleton().GetMirror().mittensDropToggle && !UI::GetMenu<RE::BarterMenu>().get() &&
+                             GetWornWithDeviousKeyword(a_actor, _deviousBondageMittensKwd);
+        _takeState.notifiedFailure = false;
+        _takeState.notifiedSuccess = false;
+    }
+
+    if (!_takeState.enabled || obj == nullptr || obj->GetName()[0] == '\0') return false;
 
     if (!obj->Is(RE::FormType::Weapon) && !obj->Is(RE::FormType::KeyMaster) &&
         (!obj->Is(RE::FormType::Armor) || LibFunctions::GetSingleton()->IsDevice(obj->As<RE::TESObjectARMO>())))
         return false;
 
-    if (!GetWornWithDeviousKeyword(a_actor, _deviousBondageMittensKwd)) return false;
-
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> distr(0.0f, 100.0f);
+    const bool loc_rollFailure = FastRandom::GetThreadLocal().NextDouble(0.0, 100.0) < 80.0;
 
-    bool loc_rollFailure = distr(gen) < 80.0f;
-
-    if (loc_rollFailure) {
+    if (loc_rollFailure && !_takeState.notifiedFailure) {
+        _takeState.notifiedFailure = true;
         RE::DebugNotification("Locked in bondage mittens, you cannot pick up the item.");
-    } else {
+    } else if (!loc_rollFailure && !_takeState.notifiedSuccess) {
+        _takeState.notifiedSuccess = true;
         RE::DebugNotification("Despite wearing bondage mittens, you manage to pick up the item.");
     }
 
@@ -48,8 +55,61 @@ bool DeviousDevices::InventoryFilter::TakeFilter(RE::Actor* a_actor, RE::TESBoun
 }
 
 bool DeviousDevices::InventoryFilter::EquipFilter(RE::Actor* a_actor, RE::TESBoundObject* a_item) {
+    DD_PROFILE_SCOPE(pEquipFilter)
     if ((a_actor == nullptr) || (a_item == nullptr)) return true;
 
+    // Outfit managers re-equip same items to NPCs many times, so their verdicts are cached until NPC equipment changes.
+    // Verdicts are keyed by form ids, and ids of dynamic forms can be reused for different actor or item, so they are not cached
+    bool loc_cacheable = !a_actor->IsPlayerRef() && !a_actor->IsDynamicForm() && !a_item->IsDynamicForm();
+    uint64_t loc_ticket = 0;
+    if (loc_cacheable) {
+        UniqueLock lock(_verdictLock);
+        const auto loc_verdict = _verdictCache.Find(a_actor->GetFormID(), a_item->GetFormID(), loc_ticket);
+        if (loc_verdict.has_value()) return *loc_verdict;
+    }
+
+    const bool loc_res = ComputeEquipFilter(a_actor, a_item, loc_cacheable);
+
+    // equipped device changes verdicts for other items. Equip event comes later, so cache is invalidated right away
+    const bool loc_equipsDevice = !loc_res && a_item->Is(RE::FormType::Armor) && LibFunctions::GetSingleton()->IsDevice(a_item->As<RE::TESObjectARMO>());
+
+    UniqueLock lock(_verdictLock);
+    if (loc_cacheable) _verdictCache.Store(a_actor->GetFormID(), a_item->GetFormID(), loc_ticket, loc_res);
+    if (loc_equipsDevice) _verdictCache.InvalidateActor(a_actor->GetFormID());
+
+    return loc_res;
+}
+
+void DeviousDevices::InventoryFilter::InvalidateEquipVerdicts(RE::Actor* a_actor) {
+    UniqueLock lock(_verdictLock);
+    if (a_actor == nullptr)
+        _verdictCache.InvalidateAll();
+    else
+        _verdictCache.InvalidateActor(a_actor->GetFormID());
+}
+
+DeviousDevices::EquipVerdictCache::Stats DeviousDevices::InventoryFilter::GetEquipVerdictStats(bool a_reset) {
+    UniqueLock lock(_verdictLock);
+    return _verdictCache.GetStats(a_reset);
+}
+
+RE::BSEventNotifyControl DeviousDevices::InventoryFilter::ProcessEvent(const RE::TESEquipEvent* a_event, RE::BSTEventSource<RE::TESEquipEvent>*) {
+    if (a_event != nullptr && a_event->actor) {
+        UniqueLock lock(_verdictLock);
+        _verdictCache.InvalidateActor(a_event->actor->GetFormID());
+    }
+    return RE::BSEventNotifyControl::kContinue;
+}
+
+// Player verdicts are not cached, but NPC ones can depend on open menus too (gag filter menu mode)
+RE::BSEventNotifyControl DeviousDevices::InventoryFilter::ProcessEvent(const RE::MenuOpenCloseEvent* a_event, RE::BSTEventSource<RE::MenuOpenCloseEvent>*) {
+    if (a_event != nullptr) InvalidateEquipVerdicts(nullptr);
+    return RE::BSEventNotifyControl::kContinue;
+}
+
+// Computes verdict of EquipFilter. a_cacheable is set to false if verdict has side effect which would be lost by caching it
+bool DeviousDevices::InventoryFilter::ComputeEquipFilter(RE::Actor* a_actor, RE::TESBoundObject* a_item, bool& a_cacheable) {
+
     //DEBUG("EquipFilter({},{})",a_actor->GetName(),a_item->GetName())
 
     // item have no name -> most likely used internaly by other mod, and not equipped by player -> never filter it out
@@ -71,7 +131,7 @@ bool DeviousDevices::InventoryFilter::EquipFilter(RE::Actor* a_actor, RE::TESBou
     bool loc_checkinventory = false;
     if (loc_needgagcheck) {
         if (!CheckWhitelistFood(a_item)) return false;  // check food filter
-        if (ConfigManager::GetSingleton()->GetVariable<bool>("InventoryFilter.bGagFilterModeMenu", false) == 1)
+        if (ConfigManager::GetSingleton()->GetConfig().InventoryFilter_bGagFilterModeMenu == 1)
             loc_checkinventory = true;
 
         // UI can be still not loaded even after save is loaded.
@@ -83,6 +143,7 @@ bool DeviousDevices::InventoryFilter::EquipFilter(RE::Actor* a_actor, RE::TESBou
             ERROR("Cant check if inventory menu is open because UI singleton is not initiated")
 
         if ((!loc_checkinventory || loc_invMenu.get()) && LibFunctions::GetSingleton()->ActorHasBlockingGag(a_actor)) {
+            a_cacheable = false;
             RE::DebugNotification("You can't eat or drink while wearing this gag.");
             return true;
         }
@@ -98,6 +159,7 @@ bool DeviousDevices::InventoryFilter::EquipFilter(RE::Actor* a_actor, RE::TESBou
             ERROR("Cant check if inventory menu is open because UI singleton is not initiated")
 
         if (loc_magMenu.get()) {
+            a_cacheable = false;
             RE::DebugNotification("You can't equip this while wearing this gag!");
         }
         LOG("EquipFilter({},{}) - Prevented equipping shout",a_actor->GetName(),a_item->GetName())
@@ -163,7 +225,7 @@ bool DeviousDevices::InventoryFilter::EquipFilter(RE::Actor* a_actor, RE::TESBou
                 return true;
             }
             
-            if (loc_isshield || (ConfigManager::GetSingleton()->GetVariable<bool>("InventoryFilter.bEquipFilterModeMenu", false) == 0))
+            if (loc_isshield || (ConfigManager::GetSingleton()->GetConfig().InventoryFilter_bEquipFilterModeMenu == 0))
             {
                 LOG("EquipFilter({},{}) - Prevented equipping armor",a_actor->GetName(),a_item->GetName())
                 return true;
@@ -218,87 +280,81 @@ bool DeviousDevices::InventoryFilter::IsStrapon(RE::TESBoundObject* obj) {
 }
 
 int DeviousDevices::InventoryFilter::GetMaskForKeyword(RE::Actor* a_actor, RE::BGSKeyword* kwd) {
-    if (kwd == _deviousArmCuffsKwd)
-        return GetMaskForSlot(59);
-    else if (kwd == _deviousGagKwd)
-        return GetMaskForSlot(44);
-    else if (kwd == _deviousHarnessKwd)
-        return GetMaskForSlot(58);
-    else if (kwd == _deviousCorsetKwd)
-        return GetMaskForSlot(58);
-    else if (kwd == _deviousCollarKwd)
-        return GetMaskForSlot(45);
-    else if (kwd == _deviousHeavyBondageKwd) {
+    // strait jacket is heavy bondage device worn in body slot
+    if (kwd == _deviousHeavyBondageKwd) {
         if (auto worn = a_actor->GetWornArmor(RE::BIPED_MODEL::BipedObjectSlot::kBody)) {
             if (worn->HasKeyword(_deviousStraitJacketKwd)) return GetMaskForSlot(32);
         }
-        return GetMaskForSlot(46);
-    } else if (kwd == _deviousPlugAnalKwd)
-        return GetMaskForSlot(48);
-    else if (kwd == _deviousBeltKwd)
-        return GetMaskForSlot(49);
-    else if (kwd == _deviousPiercingsVaginalKwd)
-        return GetMaskForSlot(50);
-    else if (kwd == _deviousPiercingsNippleKwd)
-        return GetMaskForSlot(51);
-    else if (kwd == _deviousLegCuffsKwd)
-        return GetMaskForSlot(53);
-    else if (kwd == _deviousBlindfoldKwd)
-        return GetMaskForSlot(55);
-    else if (kwd == _deviousBraKwd)
-        return GetMaskForSlot(56);
-    else if (kwd == _deviousPlugVaginalKwd)
-        return GetMaskForSlot(57);
-    else if (kwd == _deviousSuitKwd)
-        return GetMaskForSlot(32);
-    else if (kwd == _deviousGlovesKwd)
-        return GetMaskForSlot(33);
-    else if (kwd == _deviousHoodKwd)
-        return GetMaskForSlot(30);
-    else if (kwd == _deviousBootsKwd)
-        return GetMaskForSlot(37);
-    else if (kwd == _deviousBondageMittensKwd)
-        return GetMaskForSlot(33);
-    else
-        return -1;
-}
-
-bool DeviousDevices::InventoryFilter::CheckWhitelist(const RE::TESBoundObject* a_item) const {
-    if (a_item == nullptr) return false;
-    auto loc_whitelist = ConfigManager::GetSingleton()->GetArray<std::string>("InventoryFilter.asWhitelist");
-
-    if (loc_whitelist.size() == 0) return true;
-
-    std::string loc_name = a_item->GetName();
-    std::transform(loc_name.begin(), loc_name.end(), loc_name.begin(), ::tolower);  // to lower case
+    }
 
-    if (loc_name == "") return false;
+    const int loc_slot = _keywordSlots.Get().Find(kwd);
+    return (loc_slot >= 0) ? GetMaskForSlot(loc_slot) : -1;
+}
 
-    // check whitelist
-    for (auto&& it : loc_whitelist) {
-        if ((it != "") && (it != " ") && (loc_name.find(it) != std::string::npos)) return false;
+void DeviousDevices::InventoryFilter::BuildKeywordSlots(const ConfigSnapshot& a_config) {
+    std::vector<std::string> loc_entries = a_config.InventoryFilter_asKeywordSlots;
+    if (loc_entries.empty()) loc_entries.assign(KeywordSlotTable::DefaultEntries.begin(), KeywordSlotTable::DefaultEntries.end());
+
+    auto loc_table = std::make_unique<KeywordSlotTable>();
+    for (auto&& it : loc_entries) {
+        std::string loc_editorID;
+        uint32_t loc_slot = 0;
+        if (!KeywordSlotTable::ParseEntry(it, loc_editorID, loc_slot)) {
+            WARN("InventoryFilter::BuildKeywordSlots() - Invalid entry '{}'", it)
+            continue;
+        }
+        RE::BGSKeyword* loc_kwd = RE::TESForm::LookupByEditorID<RE::BGSKeyword>(loc_editorID);
+        if (loc_kwd == nullptr) {
+            WARN("InventoryFilter::BuildKeywordSlots() - Keyword {} not found", loc_editorID)
+            continue;
+        }
+        if (!loc_table->Add(loc_kwd, loc_slot)) WARN("InventoryFilter::BuildKeywordSlots() - Keyword {} is already mapped", loc_editorID)
     }
+    DEBUG("InventoryFilter::BuildKeywordSlots() - {} keywords mapped", loc_table->Size())
+    _keywordSlots.Publish(std::move(loc_table));
+}
 
-    return true;
+bool DeviousDevices::InventoryFilter::CheckWhitelist(const RE::TESBoundObject* a_item) const {
+    return !(GetWhitelistMatch(a_item,wGeneral) & wGeneral);
 }
 
 bool DeviousDevices::InventoryFilter::CheckWhitelistFood(const RE::TESBoundObject* a_item) const {
-    if (a_item == nullptr) return false;
-    auto loc_whitelist = ConfigManager::GetSingleton()->GetArray<std::string>("InventoryFilter.asWhitelistFood");
+    return !(GetWhitelistMatch(a_item,wFood) & wFood);
+}
 
-    if (loc_whitelist.size() == 0) return true;
+// Returns mask of whitelists which contain a_item. Item without name is treated as whitelisted, unless the list is empty
+uint8_t DeviousDevices::InventoryFilter::GetWhitelistMatch(const RE::TESBoundObject* a_item, uint8_t a_list) const {
+    if (a_item == nullptr) return a_list;
 
-    std::string loc_name = a_item->GetName();
-    std::transform(loc_name.begin(), loc_name.end(), loc_name.begin(), ::tolower);  // to lower case
+    const Whitelist& loc_whitelist = _whitelist.Get();
+    if (!(loc_whitelist.matcher.GetMask() & a_list)) return 0;
 
-    if (loc_name == "") return false;
+    // dynamic forms (like player made potions) can have their id reused for different item, so they are not cached
+    const RE::FormID loc_id = a_item->GetFormID();
+    const bool loc_cacheable = !a_item->IsDynamicForm();
+    if (loc_cacheable) {
+        UniqueLock lock(loc_whitelist.lock);
+        auto loc_it = loc_whitelist.cache.find(loc_id);
+        if (loc_it != loc_whitelist.cache.end()) return loc_it->second;
+    }
+
+    const std::string_view loc_name = a_item->GetName();
+    const uint8_t loc_res = loc_name.empty() ? loc_whitelist.matcher.GetMask() : loc_whitelist.matcher.Match(loc_name);
 
-    // check whitelist
-    for (auto&& it : loc_whitelist) {
-        if ((it != "") && (it != " ") && (loc_name.find(it) != std::string::npos)) return false;
+    if (loc_cacheable) {
+        UniqueLock lock(loc_whitelist.lock);
+        loc_whitelist.cache[loc_id] = loc_res;
     }
+    return loc_res;
+}
 
-    return true;
+void DeviousDevices::InventoryFilter::BuildWhitelist(const ConfigSnapshot& a_config) {
+    auto loc_whitelist = std::make_unique<Whitelist>();
+    for (auto&& it : a_config.InventoryFilter_asWhitelist) loc_whitelist->matcher.AddPattern(it, wGeneral);
+    for (auto&& it : a_config.InventoryFilter_asWhitelistFood) loc_whitelist->matcher.AddPattern(it, wFood);
+    loc_whitelist->matcher.Build();
+    DEBUG("InventoryFilter::BuildWhitelist() - {} states", loc_whitelist->matcher.GetStateCount())
+    _whitelist.Publish(std::move(loc_whitelist));
 }
 
 void DeviousDevices::InventoryFilter::Setup() {
@@ -354,5 +410,18 @@ void DeviousDevices::InventoryFilter::Setup() {
         _inventoryDeviceKwd = RE::TESForm::LookupByEditorID<RE::BGSKeyword>("zad_InventoryDevice");
 
         _PermitOralKwd = RE::TESForm::LookupByEditorID<RE::BGSKeyword>("zad_PermitOral");
+
+        BuildWhitelist(ConfigManager::GetSingleton()->GetConfig());
+        BuildKeywordSlots(ConfigManager::GetSingleton()->GetConfig());
+        ConfigManager::GetSingleton()->AddReloadListener([this](const ConfigSnapshot& a_old, const ConfigSnapshot& a_new)
+        {
+            if (a_old.InventoryFilter_asWhitelist != a_new.InventoryFilter_asWhitelist ||
+                a_old.InventoryFilter_asWhitelistFood != a_new.InventoryFilter_asWhitelistFood) BuildWhitelist(a_new);
+            if (a_old.InventoryFilter_asKeywordSlots != a_new.InventoryFilter_asKeywordSlots) BuildKeywordSlots(a_new);
+            InvalidateEquipVerdicts(nullptr);
+        });
+
+        RE::ScriptEventSourceHolder::GetSingleton()->AddEventSink<RE::TESEquipEvent>(this);
+        RE::UI::GetSingleton()->AddEventSink<RE::MenuOpenCloseEvent>(this);
     }
 }
\ No newline at end of file
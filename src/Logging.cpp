@@ -0,0 +1,66 @@
+#include "Logging.h"
+
+namespace DeviousDevices
+{
+    void Logging::Setup(spdlog::sink_ptr a_sink)
+    {
+        _sync = std::make_shared<spdlog::logger>("log",a_sink);
+        _sync->set_level(spdlog::level::trace);
+        _sync->flush_on(spdlog::level::trace);
+
+        //sync logger is created even if it is not used, so it can take over at shutdown.
+        //If queue is full, oldest messages are dropped instead of blocking caller
+        _pool        = std::make_shared<spdlog::details::thread_pool>(QueueSize,1);
+        _asyncLogger = std::make_shared<spdlog::async_logger>("async",a_sink,_pool,spdlog::async_overflow_policy::overrun_oldest);
+        _asyncLogger->set_level(spdlog::level::trace);
+        _asyncLogger->flush_on(spdlog::level::warn);
+
+        _async = true;
+        spdlog::set_default_logger(_asyncLogger);
+    }
+
+    void Logging::SetAsync(bool a_async)
+    {
+        if (_sync == nullptr || _pool == nullptr || a_async == _async) return;
+        _async = a_async;
+        spdlog::set_default_logger(a_async ? _asyncLogger : _sync);
+    }
+
+    void Logging::Shutdown()
+    {
+        if (_sync == nullptr) return;
+
+        //messages logged from now on are written directly, so the queue can only get shorter
+        _async = false;
+        spdlog::set_default_logger(_sync);
+        if (_pool == nullptr) return;
+
+        //messages are taken from queue one by one, so once the flush queued behind them is taken, all of them are written.
+        //Wait is only done here, at exit, and is limited, as the thread could be already stopped by the process
+        _asyncLogger->flush();
+        const auto loc_end = std::chrono::steady_clock::now() + std::chrono::milliseconds(ShutdownTimeout);
+        bool loc_drained = true;
+        while (_pool->queue_size() > 0)
+        {
+            if (std::chrono::steady_clock::now() >= loc_end)
+            {
+                loc_drained = false;
+                break;
+            }
+            std::this_thread::yield();
+        }
+
+        //async logger only keeps weak pointer to the pool, so releasing the pool stops the thread once it writes the
+        //queue. If the thread did not drain it, join would wait forever
+        if (loc_drained)
+        {
+            _pool.reset();
+        }
+        else
+        {
+            //intentionally leaked, as destructor would join the thread
+            new std::shared_ptr<spdlog::details::thread_pool>(std::move(_pool));
+        }
+        _sync->flush();
+    }
+}
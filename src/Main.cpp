@@ -32,21 +32,31 @@ namespace {
         if (!logsFolder) SKSE::stl::report_and_fail("SKSE log_directory not provided, logs disabled.");
         auto pluginName = SKSE::PluginDeclaration::GetSingleton()->GetName();
         auto logFilePath = *logsFolder / "DeviousDevicesNG.log";
-        std::shared_ptr<spdlog::logger> loggerPtr;
+        spdlog::sink_ptr loc_sink;
         if (IsDebuggerPresent()) 
         {
-            loggerPtr = std::make_shared<spdlog::logger>("log", std::make_shared<spdlog::sinks::msvc_sink_mt>());
+            loc_sink = std::make_shared<spdlog::sinks::msvc_sink_mt>();
         } 
         else 
         {
-            loggerPtr = std::make_shared<spdlog::logger>("log", std::make_shared<spdlog::sinks::basic_file_sink_mt>(logFilePath.string(), true));
+            loc_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(logFilePath.string(), true);
         }
-        spdlog::set_default_logger(std::move(loggerPtr));
-        spdlog::set_level(spdlog::level::trace);
-        spdlog::flush_on(spdlog::level::trace);
+
+        // Logger is async from the start, config can only switch it to synchronous, see ConfigureLogging
+        DeviousDevices::Logging::Setup(loc_sink);
+        std::atexit([]{ DeviousDevices::Logging::Shutdown(); });
         DEBUG("Logging set - Log gfile = {}",logFilePath.string())
     }
 
+    void ConfigureLogging()
+    {
+        // Synchronous logging is opt-in, for finding cause of crashes. Mode is only picked here, as default logger can't
+        // be safely replaced later
+        const bool loc_async = !DeviousDevices::ConfigManager::GetSingleton()->GetConfig().Main_bSyncLogging;
+        DeviousDevices::Logging::SetAsync(loc_async);
+        DEBUG("Logging mode = {}",loc_async ? "async" : "sync")
+    }
+
     void InitializePapyrus() 
     {
         //log::trace("Initializing Papyrus binding...");
@@ -75,6 +85,8 @@ namespace {
                     break;
                 case MessagingInterface::kDataLoaded:  // All ESM/ESL/ESP plugins have loaded, main menu is now
                                                         // active.  
+                {
+                    DD_TRACE_SCOPE("DataLoaded")
                     DeviousDevices::DeviceHiderManager::GetSingleton()->Setup();
                     DeviousDevices::LibFunctions::GetSingleton()->Setup();
                     DeviousDevices::DeviceReader::GetSingleton()->Setup();
@@ -83,13 +95,16 @@ namespace {
                     DeviousDevices::UpdateManager::GetSingleton()->Setup();
                     DeviousDevices::ExpressionManager::GetSingleton()->Setup();
                     DeviousDevices::HooksVirtual::GetSingleton()->Setup();
+                    DeviousDevices::Settings::GetSingleton().Setup();
                     if (!DeviousDevicesAPI::g_API) DeviousDevicesAPI::g_API = new DeviousDevicesAPI::DeviousDevicesAPI;
                     DEBUG("API ready - 0x{:016X}",(uintptr_t)DeviousDevicesAPI::g_API);
                     break;
+                }
                 case MessagingInterface::kPostLoadGame:  // Player's selected save game has finished loading.
                                                             // Data will be a boolean indicating whether the load was
                                                             // successful.
                 case MessagingInterface::kNewGame: //also when player makes new game, as kPostLoadGame event is called too late on new game
+                    DeviousDevices::Settings::GetSingleton().Refresh();
                     break;
             }
             
@@ -121,6 +136,8 @@ SKSEPluginLoad(const LoadInterface* skse)
 
     InitializeLogging();
     DeviousDevices::ConfigManager::GetSingleton()->Setup();
+    ConfigureLogging();
+    DeviousDevices::Instrumentation::Setup();
 
     InitializePapyrus();
     InitializeMessaging();
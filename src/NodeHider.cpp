@@ -11,15 +11,7 @@ void DeviousDevices::NodeHider::Setup()
     if (!_installed)
     {
         DEBUG("NodeHider::Setup() - called")
-        _WeaponNodes = ConfigManager::GetSingleton()->GetArrayText("NodeHider.asWeaponNodes",false);
-
-        _ArmNodes       = ConfigManager::GetSingleton()->GetArray<std::string>("NodeHider.asArmNodes");
-        _HandNodes      = ConfigManager::GetSingleton()->GetArray<std::string>("NodeHider.asHandNodes");
-        _FingerNodes    = ConfigManager::GetSingleton()->GetArray<std::string>("NodeHider.asFingerNodes");
-
-        _ArmHiddingKeywords     = ConfigManager::GetSingleton()->GetArrayText("NodeHider.asArmHiddingKeywords",false);
-        _HandHiddingKeywords    = ConfigManager::GetSingleton()->GetArrayText("NodeHider.asHandHiddingKeywords",false);
-        _FingerHiddingKeywords  = ConfigManager::GetSingleton()->GetArrayText("NodeHider.asFingerHiddingKeywords",false);
+        LoadNodes(ConfigManager::GetSingleton()->GetConfig());
 
         DEBUG("NodeHider::Setup() - Hidding nodes")
         for (auto&& it : _ArmNodes) DEBUG("Arm node: {}",it)
@@ -30,11 +22,32 @@ void DeviousDevices::NodeHider::Setup()
         for (auto&& it : _HandHiddingKeywords) DEBUG("Hand kw: {}",it)
         for (auto&& it : _FingerHiddingKeywords) DEBUG("Finger kw: {}",it)
 
+        //nodes hidden using old lists are shown first, and hidden again by next update using new lists
+        ConfigManager::GetSingleton()->AddReloadListener([this](const ConfigSnapshot& a_old, const ConfigSnapshot& a_new)
+        {
+            UniqueLock lock(SaveLock);
+            ShowAllNodes(a_old.NodeHider_bEnabled,a_old.NodeHider_bHideArms);
+            LoadNodes(a_new);
+        });
+
         _installed = true;
         DEBUG("NodeHider::Setup() - complete")
     }
 }
 
+void DeviousDevices::NodeHider::LoadNodes(const ConfigSnapshot& a_config)
+{
+    _WeaponNodes = a_config.NodeHider_asWeaponNodes;
+
+    _ArmNodes       = a_config.NodeHider_asArmNodes;
+    _HandNodes      = a_config.NodeHider_asHandNodes;
+    _FingerNodes    = a_config.NodeHider_asFingerNodes;
+
+    _ArmHiddingKeywords     = a_config.NodeHider_asArmHiddingKeywords;
+    _HandHiddingKeywords    = a_config.NodeHider_asHandHiddingKeywords;
+    _FingerHiddingKeywords  = a_config.NodeHider_asFingerHiddingKeywords;
+}
+
 void DeviousDevices::NodeHider::HideArmNodes(RE::Actor* a_actor, std::unordered_map<uint32_t, HidderState>& a_states, std::vector<std::string> a_nodes)
 {
     if (a_actor == nullptr) return;
@@ -45,7 +58,7 @@ void DeviousDevices::NodeHider::HideArmNodes(RE::Actor* a_actor, std::unordered_
     RE::NiNode* thirdpersonNode = a_actor->Get3D(0)->AsNode();
     if (thirdpersonNode == nullptr) return;
 
-    static bool loc_hidefirstperson = ConfigManager::GetSingleton()->GetVariable<bool>("NodeHider.bHideArmsFirstPerson",true);
+    const bool loc_hidefirstperson = ConfigManager::GetSingleton()->GetConfig().NodeHider_bHideArmsFirstPerson;
 
     RE::NiNode* firstpersonnode = loc_hidefirstperson ? a_actor->Get3D(1)->AsNode() : nullptr;
     if (loc_hidefirstperson && firstpersonnode == nullptr) return;
@@ -87,7 +100,7 @@ void DeviousDevices::NodeHider::ShowArmNodes(RE::Actor* a_actor, std::unordered_
     RE::NiNode* thirdpersonNode = a_actor->Get3D(0) ? a_actor->Get3D(0)->AsNode() : nullptr;
     if (thirdpersonNode == nullptr) return;
 
-    static bool loc_hidefirstperson = ConfigManager::GetSingleton()->GetVariable<bool>("NodeHider.bHideArmsFirstPerson",true);
+    const bool loc_hidefirstperson = ConfigManager::GetSingleton()->GetConfig().NodeHider_bHideArmsFirstPerson;
 
     RE::NiNode* firstpersonnode = loc_hidefirstperson ? (a_actor->Get3D(1) ? a_actor->Get3D(1)->AsNode() : nullptr) : nullptr;
     if (loc_hidefirstperson && firstpersonnode == nullptr) return;
@@ -171,10 +184,11 @@ void DeviousDevices::NodeHider::UpdateWeapons(RE::Actor* a_actor)
 
 void DeviousDevices::NodeHider::UpdatePlayer(RE::Actor* a_actor)
 {
+    DD_PROFILE_SCOPE(pNodeHiderUpdate)
     UniqueLock lock(SaveLock);
 
     if (a_actor == nullptr) return;
-    static bool loc_hidearms = ConfigManager::GetSingleton()->GetVariable<bool>("NodeHider.bHideArms",false);
+    const bool loc_hidearms = ConfigManager::GetSingleton()->GetConfig().NodeHider_bHideArms;
     if (loc_hidearms)
     {
         UpdateArms(a_actor);
@@ -216,53 +230,30 @@ void DeviousDevices::NodeHider::ShowWeapons(RE::Actor* a_actor)
     LOG("NodeHider::ShowWeapons({}) - Weapon nodes shown",a_actor->GetName())
 }
 
-void DeviousDevices::NodeHider::UpdateTimed(RE::Actor* a_actor)
+void DeviousDevices::NodeHider::UpdateNPC(RE::Actor* a_actor)
 {
+    DD_PROFILE_SCOPE(pNodeHiderUpdate)
     UniqueLock lock(SaveLock);
     if (!a_actor) return;
 
-    //LOG("NodeHider::UpdateTimed({}) called", a_actor ? a_actor->GetName() : "NONE")
-
-    auto loc_refBase = a_actor->GetActorBase();
-    if(a_actor->IsDisabled() || !a_actor->Is3DLoaded() || !(a_actor->Is(RE::FormType::NPC) || (loc_refBase && loc_refBase->Is(RE::FormType::NPC))))
-    {
-        LOG("NodeHider::UpdateTimed({}) - Actor is invalid",a_actor ? a_actor->GetName() : "NONE")
-        return;
-    }
-    
-    auto loc_id = _UpdatedActors.find(a_actor);
-
-    if (loc_id == _UpdatedActors.end())
-    {
-        _UpdatedActors[a_actor] = {0,_UpdateCounter};
-        LOG("NodeHider::UpdateTimed({}) - Actor registered",a_actor ? a_actor->GetName() : "NONE")
-        return;
-    }
-
-    loc_id->second.elapsedFrames++;
-    loc_id->second.lastUpdateFrame = _UpdateCounter;
-
-    static bool loc_hidearms = ConfigManager::GetSingleton()->GetVariable<bool>("NodeHider.bHideArms",false);
-
-    static const int loc_updatetime = ConfigManager::GetSingleton()->GetVariable<int>("NodeHider.iNPCUpdateTime",60);
+    const bool loc_hidearms = ConfigManager::GetSingleton()->GetConfig().NodeHider_bHideArms;
 
-    if (loc_id->second.elapsedFrames >= loc_updatetime)
-    {
-        loc_id->second.elapsedFrames -= loc_updatetime;
-        UpdateWeapons(a_actor);
-        if (loc_hidearms) UpdateArms(a_actor);
-    }
+    UpdateWeapons(a_actor);
+    if (loc_hidearms) UpdateArms(a_actor);
 }
 
 void DeviousDevices::NodeHider::Reload()
 {
     UniqueLock lock(SaveLock);
+    const ConfigSnapshot& loc_config = ConfigManager::GetSingleton()->GetConfig();
+    ShowAllNodes(loc_config.NodeHider_bEnabled,loc_config.NodeHider_bHideArms);
+}
 
-    const bool loc_nodehider = ConfigManager::GetSingleton()->GetVariable<bool>("NodeHider.bEnabled",true);
-    if (loc_nodehider)
+void DeviousDevices::NodeHider::ShowAllNodes(bool a_enabled, bool a_hidearms)
+{
+    if (a_enabled)
     {
-        bool loc_hidearms = ConfigManager::GetSingleton()->GetVariable<bool>("NodeHider.bHideArms",false);
-        if (loc_hidearms)
+        if (a_hidearms)
         {
             for (auto&& [handle,state] : _armhiddenstates)
             {
@@ -299,29 +290,22 @@ void DeviousDevices::NodeHider::Reload()
             }
         }
     }
-    _UpdatedActors.clear();
     _lastupdatestack.clear();
     _armhiddenstates.clear();
     _handhiddenstates.clear();
     _fingerhiddenstates.clear();
     _weaponhiddenstates.clear();
+    _weaponnodestates.clear();
 }
 
-void DeviousDevices::NodeHider::CleanUnusedActors()
+void DeviousDevices::NodeHider::ForgetActor(uint32_t a_handle)
 {
     UniqueLock lock(SaveLock);
-    for (auto&& [actor,updateHandle] : _UpdatedActors)
-    {
-        if ((updateHandle.lastUpdateFrame + 120) < _UpdateCounter)
-        {
-            _UpdatedActors.erase(actor);
-        }
-    }
-}
-
-void DeviousDevices::NodeHider::IncUpdateCounter()
-{
-    _UpdateCounter++;
+    _armhiddenstates.erase(a_handle);
+    _handhiddenstates.erase(a_handle);
+    _fingerhiddenstates.erase(a_handle);
+    _weaponhiddenstates.erase(a_handle);
+    _weaponnodestates.erase(a_handle);
 }
 
 bool DeviousDevices::NodeHider::ActorIsValid(RE::Actor* a_actor) const
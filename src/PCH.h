@@ -104,6 +104,7 @@
 #include <Psapi.h>
 #undef cdecl // Workaround for Clang 14 CMake configure error.
 
+#include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/msvc_sink.h>
 
@@ -123,17 +124,28 @@
 
 #include <Switches.h>
 #include <Config.h>
+#include <Logging.h>
+#include <Instrumentation.h>
 
 // Compatible declarations with other sample projects.
 #define DLLEXPORT __declspec(dllexport)
 
 #define PAPYRUSFUNCHANDLE RE::BSScript::Internal::VirtualMachine* a_vm, const RE::VMStackID a_stackID, RE::StaticFunctionTag*
 
-//print message to log file
-#define LOG(...)    { if (!DeviousDevices::ConfigManager::GetSingleton()->GetLoggingDisable() && DeviousDevices::ConfigManager::GetSingleton()->GetVariable<int>("Main.iLogging",1) >= 2) SKSE::log::info(__VA_ARGS__);}
-#define WARN(...)   { if (DeviousDevices::ConfigManager::GetSingleton()->GetVariable<int>("Main.iLogging",1) >= 1) SKSE::log::warn(__VA_ARGS__);}
+//print message to log file. Arguments are only formatted if message level is enabled
+#if (DD_LOGLEVEL_S >= 2U)
+    #define LOG(...)    { if (!DeviousDevices::ConfigManager::GetSingleton()->GetLoggingDisable() && DeviousDevices::ConfigManager::GetSingleton()->GetConfig().Main_iLogging >= 2) SKSE::log::info(__VA_ARGS__);}
+    #define DEBUG(...)  { if (DeviousDevices::ConfigManager::GetSingleton()->GetConfig().Main_iLogging >= 2) SKSE::log::debug(__VA_ARGS__);}
+#else
+    #define LOG(...)    {}
+    #define DEBUG(...)  {}
+#endif
+#if (DD_LOGLEVEL_S >= 1U)
+    #define WARN(...)   { if (DeviousDevices::ConfigManager::GetSingleton()->GetConfig().Main_iLogging >= 1) SKSE::log::warn(__VA_ARGS__);}
+#else
+    #define WARN(...)   {}
+#endif
 #define ERROR(...)  { SKSE::log::error(__VA_ARGS__);}
-#define DEBUG(...)  { SKSE::log::debug(__VA_ARGS__);}
 
 //print message to console
 #define CLOG(...) {if(RE::ConsoleLog::GetSingleton() != nullptr) RE::ConsoleLog::GetSingleton()->Print((std::string("[DDNG] ") + std::format(__VA_ARGS__)).c_str());} 
@@ -145,10 +157,4 @@ namespace logger = SKSE::log;
 
 namespace util {
     using SKSE::stl::report_and_fail;
-}
-
-struct UpdateHandle
-{
-    uint64_t    elapsedFrames   = 0UL;
-    uint64_t    lastUpdateFrame = 0UL;
-};
\ No newline at end of file
+}
\ No newline at end of file
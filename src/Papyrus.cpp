@@ -4,6 +4,8 @@
 #include "NodeHider.h"
 #include "DeviceReader.h"
 #include "LibFunctions.h"
+#include "Settings.h"
+#include "UpdateManager.h"
 #include <functional>
 #include <algorithm>
 
@@ -115,6 +117,8 @@ bool DeviousDevices::RegisterFunctions(IVirtualMachine* vm) {
     REGISTERPAPYRUSFUNC(ApplyExpression,true);
     REGISTERPAPYRUSFUNC(GetExpression,true);
     REGISTERPAPYRUSFUNC(ResetExpression,true);
+    REGISTERPAPYRUSFUNC(ApplyExpressionLayer,true);
+    REGISTERPAPYRUSFUNC(ResetExpressionLayer,true);
     REGISTERPAPYRUSFUNC(UpdateGagExpression,true);
     REGISTERPAPYRUSFUNC(RegisterGagType,true);
     REGISTERPAPYRUSFUNC(RegisterDefaultGagType,true);
@@ -141,8 +145,20 @@ bool DeviousDevices::RegisterFunctions(IVirtualMachine* vm) {
     REGISTERPAPYRUSFUNC(GetPropertyFloatArray,true);
     REGISTERPAPYRUSFUNC(GetPropertyBoolArray,true);
     REGISTERPAPYRUSFUNC(GetPropertyStringArray,true);
+    REGISTERPAPYRUSFUNC(GetPropertiesForm,true);
+    REGISTERPAPYRUSFUNC(GetPropertiesInt,true);
+    REGISTERPAPYRUSFUNC(GetPropertiesFloat,true);
+    REGISTERPAPYRUSFUNC(GetPropertiesBool,true);
+    REGISTERPAPYRUSFUNC(GetPropertiesString,true);
+    REGISTERPAPYRUSFUNC(GetDeviceVersionCount,true);
+    REGISTERPAPYRUSFUNC(GetPropertyFormAtVersion,true);
+    REGISTERPAPYRUSFUNC(GetPropertyIntAtVersion,true);
+    REGISTERPAPYRUSFUNC(GetPropertyFloatAtVersion,true);
+    REGISTERPAPYRUSFUNC(GetPropertyBoolAtVersion,true);
+    REGISTERPAPYRUSFUNC(GetPropertyStringAtVersion,true);
     REGISTERPAPYRUSFUNC(GetEditingMods,true);
     REGISTERPAPYRUSFUNC(GetDeviceByName,true);
+    REGISTERPAPYRUSFUNC(SearchDevices,true);
 
     REGISTERPAPYRUSFUNC(SetManipulated, true);
     REGISTERPAPYRUSFUNC(GetManipulated, true);
@@ -153,6 +169,13 @@ bool DeviousDevices::RegisterFunctions(IVirtualMachine* vm) {
     REGISTERPAPYRUSFUNC(PluginInstalled, true);
     REGISTERPAPYRUSFUNC(ExecuteConsoleCmd, false);
 
+    //Settings.h
+    REGISTERPAPYRUSFUNC(RefreshSettings, false);
+
+    //UpdateManager.h
+    REGISTERPAPYRUSFUNC(PrintProfile, false);
+    REGISTERPAPYRUSFUNC(ExportTrace, false);
+
     #undef REGISTERPAPYRUSFUNC
     return true;
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "Serialization.h"
 #include "NodeHider.h"
 #include "Hider.h"
-#include "Expression.h"
+#include "UpdateManager.h"
 
 void DeviousDevices::OnGameLoaded(SKSE::SerializationInterface* a_serde)
 {
@@ -18,5 +18,6 @@ void DeviousDevices::OnRevert(SKSE::SerializationInterface* a_serde)
     LOG("DeviousDevices::OnRevert called")
     NodeHider::GetSingleton()->Reload();
     DeviceHiderManager::GetSingleton()->Reload();
+    UpdateManager::GetSingleton()->Reload();
     ExpressionManager::GetSingleton()->Reload();
 }
@@ -0,0 +1,174 @@
+#include "TimerWheel.h"
+
+bool DeviousDevices::TimerTask::Cancel()
+{
+    TaskState loc_state = _state.load(std::memory_order_acquire);
+    while (loc_state == sPending || loc_state == sRunning)
+    {
+        if (_state.compare_exchange_weak(loc_state,sCancelled,std::memory_order_acq_rel)) return true;
+    }
+    return false;
+}
+
+DeviousDevices::TimerTaskHandle DeviousDevices::TimerWheel::ScheduleOnce(uint64_t a_delayMs, std::function<void()> a_callback)
+{
+    return Schedule(a_delayMs,0ULL,std::move(a_callback));
+}
+
+DeviousDevices::TimerTaskHandle DeviousDevices::TimerWheel::SchedulePeriodic(uint64_t a_periodMs, std::function<void()> a_callback, uint64_t a_firstDelayMs)
+{
+    const uint64_t loc_period = std::max<uint64_t>(a_periodMs,1ULL);
+    return Schedule((a_firstDelayMs > 0) ? a_firstDelayMs : loc_period,loc_period,std::move(a_callback));
+}
+
+DeviousDevices::TimerTaskHandle DeviousDevices::TimerWheel::Schedule(uint64_t a_delay, uint64_t a_period, std::function<void()> a_callback)
+{
+    TimerTaskHandle loc_task = std::make_shared<TimerTask>(std::move(a_callback),a_period);
+
+    //delay is converted to expiry time once the task is moved to wheel, as current time is owned by thread which advances the wheel
+    loc_task->_expiry = std::max<uint64_t>(a_delay,1ULL);
+
+    UniqueLock lock(_pendingLock);
+    _pending.push_back(loc_task);
+    _hasPending.store(true,std::memory_order_release);
+    _taskCount++;
+    return loc_task;
+}
+
+size_t DeviousDevices::TimerWheel::Advance(float a_delta)
+{
+    if (a_delta <= 0.0f) return AdvanceTicks(0ULL);
+
+    const double loc_ticks = _remainder + static_cast<double>(a_delta)*1000.0;
+    const uint64_t loc_whole = static_cast<uint64_t>(loc_ticks);
+    _remainder = loc_ticks - static_cast<double>(loc_whole);
+    return AdvanceTicks(loc_whole);
+}
+
+size_t DeviousDevices::TimerWheel::AdvanceTicks(uint64_t a_ticks)
+{
+    InsertPending();
+
+    const uint64_t loc_end = _now + a_ticks;
+    size_t loc_res = 0;
+    for (uint64_t i = 0; i < a_ticks; i++)
+    {
+        //tasks scheduled by callbacks of previous tick
+        InsertPending();
+
+        _now++;
+
+        //move tasks from higher levels once lower level wraps around
+        for (uint32_t loc_level = LevelCount - 1; loc_level > 0; loc_level--)
+        {
+            if ((_now & ((1ULL << (SlotBits*loc_level)) - 1ULL)) == 0) Cascade(loc_level);
+        }
+
+        auto& loc_slot = _wheel[0][_now & (SlotCount - 1)];
+        if (loc_slot.empty()) continue;
+
+        //callbacks can schedule new tasks, so slot is swapped out before executing them
+        _expired.swap(loc_slot);
+        for (auto&& loc_task : _expired)
+        {
+            TimerTask::TaskState loc_state = TimerTask::sPending;
+            if (!loc_task->_state.compare_exchange_strong(loc_state,TimerTask::sRunning,std::memory_order_acq_rel))
+            {
+                //cancelled
+                _taskCount--;
+                continue;
+            }
+
+            loc_task->_callback();
+            loc_res++;
+
+            loc_state = TimerTask::sRunning;
+            if (loc_task->IsPeriodic() && loc_task->_state.compare_exchange_strong(loc_state,TimerTask::sPending,std::memory_order_acq_rel))
+            {
+                //periods which would expire again in this advance are skipped, so long frame does not cause burst of
+                //executions. Expiry stays aligned to the period, so normal frames don't drift
+                loc_task->_expiry = _now + loc_task->_period;
+                if (loc_task->_expiry <= loc_end)
+                {
+                    loc_task->_expiry += ((loc_end - loc_task->_expiry)/loc_task->_period + 1)*loc_task->_period;
+                }
+                Insert(loc_task);
+            }
+            else
+            {
+                //keep cancelled state if task was cancelled by callback
+                loc_state = TimerTask::sRunning;
+                loc_task->_state.compare_exchange_strong(loc_state,TimerTask::sFinished,std::memory_order_acq_rel);
+                _taskCount--;
+            }
+        }
+        _expired.clear();
+    }
+    return loc_res;
+}
+
+void DeviousDevices::TimerWheel::Clear()
+{
+    UniqueLock lock(_pendingLock);
+    for (auto&& it : _pending) it->Cancel();
+    _pending.clear();
+    _hasPending.store(false,std::memory_order_release);
+    for (auto&& loc_level : _wheel)
+    {
+        for (auto&& loc_slot : loc_level)
+        {
+            for (auto&& it : loc_slot) it->Cancel();
+            loc_slot.clear();
+        }
+    }
+    _taskCount = 0;
+}
+
+size_t DeviousDevices::TimerWheel::GetTaskCount() const
+{
+    return _taskCount.load(std::memory_order_relaxed);
+}
+
+void DeviousDevices::TimerWheel::InsertPending()
+{
+    if (!_hasPending.load(std::memory_order_acquire)) return;
+
+    UniqueLock lock(_pendingLock);
+    for (auto&& it : _pending)
+    {
+        it->_expiry += _now;
+        Insert(it);
+    }
+    _pending.clear();
+    _hasPending.store(false,std::memory_order_release);
+}
+
+void DeviousDevices::TimerWheel::Insert(TimerTaskHandle a_task)
+{
+    const uint64_t loc_expiry = std::min<uint64_t>(std::max<uint64_t>(a_task->_expiry,_now),_now + MaxDelay);
+    const uint64_t loc_delta  = loc_expiry - _now;
+
+    uint32_t loc_level = 0;
+    while (loc_level < LevelCount - 1 && loc_delta >= (1ULL << (SlotBits*(loc_level + 1)))) loc_level++;
+
+    //tasks which expire in current tick are executed in the same tick, as the slot is processed after cascading
+    _wheel[loc_level][(loc_expiry >> (SlotBits*loc_level)) & (SlotCount - 1)].push_back(std::move(a_task));
+}
+
+void DeviousDevices::TimerWheel::Cascade(uint32_t a_level)
+{
+    auto& loc_slot = _wheel[a_level][(_now >> (SlotBits*a_level)) & (SlotCount - 1)];
+    if (loc_slot.empty()) return;
+
+    std::vector<TimerTaskHandle> loc_tasks;
+    loc_tasks.swap(loc_slot);
+    for (auto&& it : loc_tasks)
+    {
+        if (it->GetState() == TimerTask::sCancelled)
+        {
+            _taskCount--;
+            continue;
+        }
+        Insert(std::move(it));
+    }
+}
@@ -1,4 +1,5 @@
 #include "UpdateManager.h"
+#include "InventoryFilter.h"
 
 SINGLETONBODY(DeviousDevices::UpdateManager)
 
@@ -14,9 +15,103 @@ void DeviousDevices::UpdateManager::Setup()
         UpdateCharacter_old = vtbl_character.write_vfunc(REL::Module::GetRuntime() != REL::Module::Runtime::VR ? 0x0AD : 0x0AF, UpdateCharacter);
 
         DEBUG("UpdateManager::Setup() - Updates hooked")
+
+        ApplyConfig(ConfigManager::GetSingleton()->GetConfig());
+        ConfigManager::GetSingleton()->AddReloadListener([this](const ConfigSnapshot&, const ConfigSnapshot& a_new)
+        {
+            ApplyConfig(a_new);
+        });
+
+        _statsTask = _scheduler.SchedulePeriodic(60000,[this]
+        {
+            const UpdateQueue::DrainStats loc_stats = _npcQueue.GetDrainStats();
+            LOG("UpdateManager - NPC queue: actors = {}, drain time p50 = {:.1f} us, p99 = {:.1f} us, max = {:.1f} us, backlog = {}",
+                _npcQueue.GetActorCount(),loc_stats.p50,loc_stats.p99,loc_stats.max,loc_stats.backlog)
+
+            const ExpressionManager::WriteStats loc_writes = ExpressionManager::GetSingleton()->GetWriteStats(true);
+            LOG("UpdateManager - Face writes: written = {}, avoided = {}, lock hold avg = {:.2f} us, max = {:.2f} us",
+                loc_writes.written,loc_writes.skipped,loc_writes.locks ? loc_writes.lockTime/1000.0/loc_writes.locks : 0.0,loc_writes.maxLockTime/1000.0)
+
+            const EquipVerdictCache::Stats loc_verdicts = InventoryFilter::GetSingleton()->GetEquipVerdictStats(true);
+            LOG("UpdateManager - Equip verdict cache: hits = {}, misses = {}, hit rate = {:.1f} %",
+                loc_verdicts.hits,loc_verdicts.misses,(loc_verdicts.hits + loc_verdicts.misses) ? 100.0*loc_verdicts.hits/(loc_verdicts.hits + loc_verdicts.misses) : 0.0)
+
+            if (ConfigManager::GetSingleton()->GetConfig().Main_bLockStats)
+            {
+                auto loc_log = [](const char* a_name, const Spinlock::Stats& a_stats)
+                {
+                    LOG("UpdateManager - Lock {}: contended = {}, sleeps = {}, wait avg = {:.2f} us, max = {:.2f} us",
+                        a_name,a_stats.contended,a_stats.sleeps,a_stats.contended ? a_stats.waitTime/1000.0/a_stats.contended : 0.0,a_stats.maxWait/1000.0)
+                };
+                loc_log("NPC queue",_npcQueue.GetLockStats(true));
+                loc_log("NodeHider",NodeHider::GetSingleton()->SaveLock.GetStats());
+                NodeHider::GetSingleton()->SaveLock.ResetStats();
+            }
+
+            if (Instrumentation::IsEnabled()) LogProfile(false);
+        },60000);
+
+        DEBUG("UpdateManager::Setup() - Tasks scheduled")
     }
 }
 
+void DeviousDevices::UpdateManager::ApplyConfig(const ConfigSnapshot& a_config)
+{
+    //tasks are scheduled again, so changed intervals are used right away
+    for (auto&& it : {_gagTask,_gagPresetTask,_nodeHiderTask,_configTask})
+    {
+        if (it) it->Cancel();
+    }
+    _gagTask        = nullptr;
+    _gagPresetTask  = nullptr;
+    _nodeHiderTask  = nullptr;
+    _configTask     = nullptr;
+
+    _gagTask = _scheduler.SchedulePeriodic(a_config.GagExpression_iUpdatePlayerTime,[]
+    {
+        ExpressionManager::GetSingleton()->UpdateGagExpression(RE::PlayerCharacter::GetSingleton());
+    });
+
+    //gag presets are cached, so faction ranks changed by other mods are only picked up after refresh
+    if (a_config.GagExpression_iPresetRefreshTime > 0)
+    {
+        _gagPresetTask = _scheduler.SchedulePeriodic(a_config.GagExpression_iPresetRefreshTime,[]
+        {
+            ExpressionManager::GetSingleton()->InvalidateGagPreset(nullptr);
+        });
+    }
+
+    if (a_config.NodeHider_bEnabled)
+    {
+        _nodeHiderTask = _scheduler.SchedulePeriodic(a_config.NodeHider_iUpdatePlayerTime,[]
+        {
+            NodeHider::GetSingleton()->UpdatePlayer(RE::PlayerCharacter::GetSingleton());
+        });
+    }
+
+    if (a_config.Main_iConfigPollTime > 0)
+    {
+        _configTask = _scheduler.SchedulePeriodic(a_config.Main_iConfigPollTime,[]
+        {
+            ConfigManager::GetSingleton()->CheckForChanges();
+        });
+    }
+
+    _npcQueue.SetInterval(tGagExpression,a_config.GagExpression_bNPCsEnabled ? a_config.GagExpression_iNPCUpdateTime : 0);
+    _npcQueue.SetInterval(tNodeHider,a_config.NodeHider_bEnabled ? a_config.NodeHider_iNPCUpdateTime : 0);
+    _npcQueue.SetBudget(a_config.UpdateManager_iNPCFrameBudget);
+
+    Spinlock::EnableStats(a_config.Main_bLockStats);
+
+    auto loc_lod = std::make_unique<UpdateLODSettings>();
+    loc_lod->enabled        = a_config.UpdateManager_bLODEnabled;
+    loc_lod->nearDistance   = a_config.UpdateManager_fLODNearDistance;
+    loc_lod->farDistance    = a_config.UpdateManager_fLODFarDistance;
+    loc_lod->farMultiplier  = a_config.UpdateManager_fLODFarMultiplier;
+    loc_lod->deferOffscreen = a_config.UpdateManager_bLODDeferOffscreen;
+    if (*loc_lod != _lodSettings.Get()) _lodSettings.Publish(std::move(loc_lod));
+}
+
 //this function is only called if no menu is open. It also looks like that it is not called when player is in free cam mode
 void DeviousDevices::UpdateManager::UpdatePlayer(RE::Actor* a_actor, float a_delta)
 {
@@ -26,44 +121,24 @@ void DeviousDevices::UpdateManager::UpdatePlayer(RE::Actor* a_actor, float a_del
 
     if (a_actor == loc_player)
     {
-        if (!loc_manager->UpdateThread1) 
-        {
-            loc_manager->UpdateThread1 = true;
-            ExpressionManager::GetSingleton()->UpdateGagExpression(loc_player);
-            std::thread([loc_manager]
-            {
-                //wait
-                std::this_thread::sleep_for(std::chrono::milliseconds(ConfigManager::GetSingleton()->GetVariable<int>("GagExpression.iUpdatePlayerTime",500))); //wait x ms before updating again
-                loc_manager->UpdateThread1 = false;
-            }).detach();
-        }
+        DD_PROFILE_SCOPE(pUpdatePlayer)
+        loc_manager->_scheduler.Advance(a_delta);
 
-        static const bool loc_nodehider = ConfigManager::GetSingleton()->GetVariable<bool>("NodeHider.bEnabled",true);
-        if (loc_nodehider && !loc_manager->UpdateThread2) 
+        loc_manager->_npcQueue.Drain([loc_manager](const UpdateQueue::Job& a_job)
         {
-            loc_manager->UpdateThread2 = true;
-            NodeHider::GetSingleton()->UpdatePlayer(loc_player);
-            std::thread([loc_manager]
-            {
-                //wait
-                std::this_thread::sleep_for(std::chrono::milliseconds(ConfigManager::GetSingleton()->GetVariable<int>("NodeHider.iUpdatePlayerTime",500))); //wait x ms before updating again
-                loc_manager->UpdateThread2 = false;
-            }).detach();
-        }
+            loc_manager->ProcessNPCJob(a_job);
+        });
 
-        if (!loc_manager->UpdateThread3) 
+        //sweep only visits expired generations, so it is cheap enough to be called every frame
+        loc_manager->_npcQueue.Sweep(loc_manager->_frame,[](uint32_t a_handle)
         {
-            loc_manager->UpdateThread3 = true;
-            ExpressionManager::GetSingleton()->CleanUnusedActors();
-            std::thread([loc_manager]
-            {
-                //wait
-                std::this_thread::sleep_for(std::chrono::seconds(ConfigManager::GetSingleton()->GetVariable<int>("GagExpression.iCleanTime",10))); //wait 30 seconds
-                loc_manager->UpdateThread3 = false;
-            }).detach();
-        }
-        ExpressionManager::GetSingleton()->IncUpdateCounter();
-        NodeHider::GetSingleton()->IncUpdateCounter();
+            NodeHider::GetSingleton()->ForgetActor(a_handle);
+        });
+
+        //gag updates are done above, so their fades start in the same frame
+        ExpressionManager::GetSingleton()->UpdateLayers(a_delta);
+
+        loc_manager->_frame++;
     }
     UpdatePlayer_old(a_actor,a_delta);
 }
@@ -71,23 +146,78 @@ void DeviousDevices::UpdateManager::UpdatePlayer(RE::Actor* a_actor, float a_del
 //this function is only called if no menu is open. It also looks like that it is not called when player is in free cam mode
 void DeviousDevices::UpdateManager::UpdateCharacter(RE::Actor* a_actor, float a_delta)
 {
-    const auto loc_refBase = a_actor->GetActorBase();
-    if(a_actor->Is(RE::FormType::NPC) || (loc_refBase && loc_refBase->Is(RE::FormType::NPC)))
     {
-        if (a_actor->GetRace()->GetPlayable())
+        DD_PROFILE_SCOPE(pUpdateCharacter)
+        const auto loc_refBase = a_actor->GetActorBase();
+        if(a_actor->Is(RE::FormType::NPC) || (loc_refBase && loc_refBase->Is(RE::FormType::NPC)))
         {
-            static const bool loc_gag = ConfigManager::GetSingleton()->GetVariable<bool>("GagExpression.bNPCsEnabled", true);
-            if (loc_gag)
-            {
-                ExpressionManager::GetSingleton()->UpdateGagExpressionTimed(a_actor);
-            }
-
-            static const bool loc_nodehider = ConfigManager::GetSingleton()->GetVariable<bool>("NodeHider.bEnabled",true);
-            if (loc_nodehider)
+            if (a_actor->GetRace()->GetPlayable() && !a_actor->IsDisabled() && a_actor->Is3DLoaded())
             {
-                NodeHider::GetSingleton()->UpdateTimed(a_actor);
+                //actual updates are done by player update, in limited amount per frame
+                UpdateManager* loc_manager = UpdateManager::GetSingleton();
+                loc_manager->_npcQueue.Touch(a_actor->GetHandle().native_handle(),loc_manager->_frame,loc_manager->GetLODMultiplier(a_actor));
             }
         }
     }
     UpdateCharacter_old(a_actor,a_delta);
-}
\ No newline at end of file
+}
+
+void DeviousDevices::UpdateManager::Reload()
+{
+    _npcQueue.Clear();
+}
+
+float DeviousDevices::UpdateManager::GetLODMultiplier(RE::Actor* a_actor) const
+{
+    //settings are read once, so reload in meantime can't mix old and new values
+    const UpdateLODSettings& loc_settings = _lodSettings.Get();
+    if (!loc_settings.enabled) return 1.0f;
+
+    RE::NiCamera* loc_camera = RE::Main::WorldRootCamera();
+    RE::NiAVObject* loc_3d = a_actor->Get3D();
+    if (loc_camera == nullptr || loc_3d == nullptr) return 1.0f;
+
+    //frustum test of actor bound, occlusion is not taken in to account
+    const RE::NiBound& loc_bound = loc_3d->worldBound;
+    const bool loc_visible = RE::NiCamera::PointInFrustum(loc_bound.center,loc_camera,loc_bound.radius);
+    const float loc_distance = loc_camera->world.translate.GetDistance(loc_bound.center);
+
+    return GetUpdateLODMultiplier(loc_settings,loc_distance,loc_visible);
+}
+
+void DeviousDevices::UpdateManager::ProcessNPCJob(const UpdateQueue::Job& a_job)
+{
+    DD_TRACE_SCOPE("ProcessNPCJob")
+    auto loc_actor = RE::Actor::LookupByHandle(a_job.handle);
+    if (loc_actor == nullptr || loc_actor->IsDisabled() || !loc_actor->Is3DLoaded())
+    {
+        LOG("UpdateManager::ProcessNPCJob - Actor with handle 0x{:08X} is invalid",a_job.handle)
+        return;
+    }
+
+    switch (a_job.type)
+    {
+        case tGagExpression:
+            ExpressionManager::GetSingleton()->UpdateGagExpression(loc_actor.get());
+            break;
+        case tNodeHider:
+            NodeHider::GetSingleton()->UpdateNPC(loc_actor.get());
+            break;
+        default:
+            break;
+    }
+}
+
+void DeviousDevices::UpdateManager::LogProfile(bool a_console)
+{
+    for (auto&& it : Instrumentation::Collect())
+    {
+        if (it.calls == 0) continue;
+        if (a_console)
+        {
+            CLOG("{}: {:.0f} calls/s, p50 = {:.1f} us, p95 = {:.1f} us, p99 = {:.1f} us, max = {:.1f} us",it.name,it.rate,it.p50/1000.0,it.p95/1000.0,it.p99/1000.0,it.max/1000.0)
+        }
+        else LOG("UpdateManager - Profile {}: calls = {}, {:.0f} calls/s, p50 = {:.1f} us, p95 = {:.1f} us, p99 = {:.1f} us, max = {:.1f} us",
+                it.name,it.calls,it.rate,it.p50/1000.0,it.p95/1000.0,it.p99/1000.0,it.max/1000.0)
+    }
+}
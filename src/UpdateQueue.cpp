@@ -0,0 +1,175 @@
+#include "UpdateQueue.h"
+
+float DeviousDevices::GetUpdateLODMultiplier(const UpdateLODSettings& a_settings, float a_distance, bool a_visible)
+{
+    if (!a_settings.enabled) return 1.0f;
+    if (!a_visible && a_settings.deferOffscreen) return 0.0f;
+    if (a_distance <= a_settings.nearDistance || a_settings.farDistance <= a_settings.nearDistance) return 1.0f;
+    if (a_distance >= a_settings.farDistance) return std::max(a_settings.farMultiplier,1.0f);
+
+    const float loc_t = (a_distance - a_settings.nearDistance)/(a_settings.farDistance - a_settings.nearDistance);
+    return 1.0f + loc_t*(std::max(a_settings.farMultiplier,1.0f) - 1.0f);
+}
+
+DeviousDevices::UpdateQueue::UpdateQueue()
+{
+    _intervals.fill(0U);
+}
+
+void DeviousDevices::UpdateQueue::SetInterval(UpdateType a_type, uint32_t a_frames)
+{
+    if (a_type >= tUpdateTypeCount) return;
+    UniqueLock lock(_lock);
+    _intervals[a_type] = a_frames;
+}
+
+void DeviousDevices::UpdateQueue::SetBudget(uint32_t a_microseconds)
+{
+    UniqueLock lock(_lock);
+    _budget = a_microseconds;
+}
+
+void DeviousDevices::UpdateQueue::Touch(uint32_t a_handle, uint64_t a_frame, float a_lodMultiplier)
+{
+    UniqueLock lock(_lock);
+    auto [loc_state,loc_registered] = _actors.Touch(a_handle,a_frame);
+
+    for (uint8_t i = 0; i < tUpdateTypeCount; i++)
+    {
+        const uint32_t loc_interval = _intervals[i];
+        if (loc_interval == 0) continue;
+
+        if (loc_registered)
+        {
+            //pretend that last update was done before actor was loaded, so first update happens after offset
+            loc_state->lastFrame[i] = static_cast<int64_t>(a_frame) + StaggerOffset(a_handle,loc_interval) - loc_interval;
+        }
+
+        //deferred actor stays due, so it is updated as soon as it is visible again
+        if (loc_state->queued[i] || a_lodMultiplier <= 0.0f) continue;
+
+        const int64_t loc_scaled = static_cast<int64_t>(loc_interval*a_lodMultiplier);
+        if (static_cast<int64_t>(a_frame) - loc_state->lastFrame[i] >= loc_scaled)
+        {
+            //next update is counted from now, so actors which waited in queue do not catch up
+            loc_state->lastFrame[i] = static_cast<int64_t>(a_frame);
+            loc_state->queued[i]    = true;
+            _jobs.push_back({a_handle,static_cast<UpdateType>(i)});
+        }
+    }
+}
+
+size_t DeviousDevices::UpdateQueue::Drain(const std::function<void(const Job&)>& a_func)
+{
+    const auto loc_start = std::chrono::steady_clock::now();
+    size_t loc_res = 0;
+    uint32_t loc_budget;
+    {
+        UniqueLock lock(_lock);
+        loc_budget = _budget;
+    }
+
+    while (true)
+    {
+        Job loc_job;
+        {
+            UniqueLock lock(_lock);
+            if (_jobs.empty()) break;
+            loc_job = _jobs.front();
+            _jobs.pop_front();
+
+            //actor was removed from queue before its job was processed
+            ActorState* loc_state = _actors.Find(loc_job.handle);
+            if (loc_state == nullptr) continue;
+            loc_state->queued[loc_job.type] = false;
+        }
+
+        //lock is not held while job is executed, so NPC updates are not blocked
+        a_func(loc_job);
+        loc_res++;
+
+        const auto loc_elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - loc_start).count();
+        if (loc_elapsed >= loc_budget) break;
+    }
+
+    const float loc_time = std::chrono::duration<float,std::micro>(std::chrono::steady_clock::now() - loc_start).count();
+    UniqueLock lock(_lock);
+    _samples[_sampleCount % StatsSamples] = loc_time;
+    _sampleCount++;
+    return loc_res;
+}
+
+size_t DeviousDevices::UpdateQueue::Sweep(uint64_t a_frame, const std::function<void(uint32_t)>& a_onExpired)
+{
+    std::vector<uint32_t> loc_expired;
+    {
+        UniqueLock lock(_lock);
+        _actors.Sweep(a_frame,[&loc_expired](const uint32_t& a_handle, ActorState&)
+        {
+            loc_expired.push_back(a_handle);
+        });
+    }
+
+    for (auto&& it : loc_expired) a_onExpired(it);
+    return loc_expired.size();
+}
+
+void DeviousDevices::UpdateQueue::Clear()
+{
+    UniqueLock lock(_lock);
+    _actors.Clear();
+    _jobs.clear();
+}
+
+size_t DeviousDevices::UpdateQueue::GetActorCount() const
+{
+    UniqueLock lock(_lock);
+    return _actors.Size();
+}
+
+size_t DeviousDevices::UpdateQueue::GetBacklog() const
+{
+    UniqueLock lock(_lock);
+    return _jobs.size();
+}
+
+DeviousDevices::UpdateQueue::DrainStats DeviousDevices::UpdateQueue::GetDrainStats() const
+{
+    std::vector<float> loc_samples;
+    DrainStats loc_res;
+    {
+        UniqueLock lock(_lock);
+        const size_t loc_size = static_cast<size_t>(std::min<uint64_t>(_sampleCount,StatsSamples));
+        loc_samples.assign(_samples.begin(),_samples.begin() + loc_size);
+        loc_res.backlog = _jobs.size();
+    }
+
+    if (loc_samples.empty()) return loc_res;
+
+    loc_res.frames = loc_samples.size();
+    auto loc_percentile = [&loc_samples](float a_percentile)
+    {
+        const size_t loc_index = std::min(loc_samples.size() - 1,static_cast<size_t>(a_percentile*loc_samples.size()));
+        std::nth_element(loc_samples.begin(),loc_samples.begin() + loc_index,loc_samples.end());
+        return loc_samples[loc_index];
+    };
+    loc_res.p50 = loc_percentile(0.50f);
+    loc_res.p99 = loc_percentile(0.99f);
+    loc_res.max = *std::max_element(loc_samples.begin(),loc_samples.end());
+    return loc_res;
+}
+
+uint32_t DeviousDevices::UpdateQueue::StaggerOffset(uint32_t a_handle, uint32_t a_interval)
+{
+    if (a_interval == 0) return 0;
+    //fibonacci hashing, so consecutive handles are spread evenly over interval
+    const uint64_t loc_hash = (static_cast<uint64_t>(a_handle)*0x9E3779B97F4A7C15ULL) >> 32;
+    return static_cast<uint32_t>(loc_hash % a_interval);
+}
+
+DeviousDevices::Spinlock::Stats DeviousDevices::UpdateQueue::GetLockStats(bool a_reset)
+{
+    const Spinlock::Stats loc_res = _lock.GetStats();
+    if (a_reset) _lock.ResetStats();
+    return loc_res;
+}
@@ -0,0 +1,89 @@
+#include "WhitelistMatcher.h"
+
+void DeviousDevices::WhitelistMatcher::AddPattern(std::string_view a_pattern, uint8_t a_mask)
+{
+    if (a_pattern.empty() || a_pattern == " " || a_mask == 0) return;
+
+    std::string loc_pattern(a_pattern);
+    std::transform(loc_pattern.begin(),loc_pattern.end(),loc_pattern.begin(),Fold);
+    _patterns.push_back({std::move(loc_pattern),a_mask});
+    _mask |= a_mask;
+}
+
+void DeviousDevices::WhitelistMatcher::Build()
+{
+    //only bytes used by patterns get own class, rest share class 0. Keeps table small even for long whitelists
+    _classMap.fill(0);
+    _classes = 1;
+    std::array<uint16_t,256> loc_folded = {};
+    for (auto&& [pattern,mask] : _patterns)
+    {
+        for (char it : pattern)
+        {
+            uint16_t& loc_class = loc_folded[static_cast<unsigned char>(it)];
+            if (loc_class == 0) loc_class = static_cast<uint16_t>(_classes++);
+        }
+    }
+    for (size_t i = 0; i < 256; i++) _classMap[i] = loc_folded[static_cast<unsigned char>(Fold(static_cast<char>(i)))];
+
+    //trie. 0 in table = no edge (root can't be target of edge)
+    _next.assign(_classes,0);
+    _output.assign(1,0);
+    for (auto&& [pattern,mask] : _patterns)
+    {
+        uint32_t loc_state = 0;
+        for (char it : pattern)
+        {
+            uint32_t& loc_edge = _next[loc_state*_classes + _classMap[static_cast<unsigned char>(it)]];
+            if (loc_edge == 0)
+            {
+                loc_edge = static_cast<uint32_t>(_output.size());
+                _output.push_back(0);
+                _next.resize(_next.size() + _classes,0);
+            }
+            loc_state = _next[loc_state*_classes + _classMap[static_cast<unsigned char>(it)]];  //resize could invalidate loc_edge
+        }
+        _output[loc_state] |= mask;
+    }
+
+    //failure links in BFS order. Missing edges are replaced with edge of failure state, which turns trie to DFA
+    std::vector<uint32_t> loc_fail(_output.size(),0);
+    std::deque<uint32_t> loc_queue;
+    for (uint32_t c = 0; c < _classes; c++)
+    {
+        if (_next[c] != 0) loc_queue.push_back(_next[c]);
+    }
+    while (!loc_queue.empty())
+    {
+        const uint32_t loc_state = loc_queue.front();
+        loc_queue.pop_front();
+        _output[loc_state] |= _output[loc_fail[loc_state]];
+        for (uint32_t c = 0; c < _classes; c++)
+        {
+            uint32_t& loc_edge = _next[loc_state*_classes + c];
+            const uint32_t loc_failEdge = _next[loc_fail[loc_state]*_classes + c];
+            if (loc_edge != 0)
+            {
+                loc_fail[loc_edge] = loc_failEdge;
+                loc_queue.push_back(loc_edge);
+            }
+            else loc_edge = loc_failEdge;
+        }
+    }
+}
+
+uint8_t DeviousDevices::WhitelistMatcher::Match(std::string_view a_text, uint8_t a_stopMask) const
+{
+    if (_mask == 0) return 0;
+    a_stopMask &= _mask;
+
+    uint8_t  loc_res   = 0;
+    uint32_t loc_state = 0;
+    for (char it : a_text)
+    {
+        loc_state = _next[loc_state*_classes + _classMap[static_cast<unsigned char>(it)]];
+        loc_res |= _output[loc_state];
+        if ((loc_res & a_stopMask) == a_stopMask) break;
+    }
+    return loc_res;
+}
@@ -0,0 +1,346 @@
+#include <catch.hpp>
+#include "EspBuilder.h"
+
+using DeviousDevices::DeviceHistory;
+using DeviousDevices::DeviceMod;
+using DeviousDevices::FormResolver;
+using namespace DeviousDevices::Fixtures;
+
+namespace
+{
+    std::unique_ptr<DeviceMod> Parse(const std::vector<uint8_t>& a_data, const std::string& a_name = "Test.esp", const FormResolver* a_resolver = nullptr)
+    {
+        //DeviceMod takes ownership of raw data
+        uint8_t* loc_raw = new uint8_t[a_data.size()];
+        std::copy(a_data.begin(),a_data.end(),loc_raw);
+        return std::make_unique<DeviceMod>(a_name,loc_raw,a_data.size(),a_resolver);
+    }
+
+    VmadBuilder MakeAllTypes()
+    {
+        return VmadBuilder()
+            .AddScript("zadEquipScript")
+            .AddObject("deviceInventory",0x02000801U)
+            .AddString("deviceName","Test Device")
+            .AddInt("LockAccessDifficulty",-30)
+            .AddFloat("BaseEscapeChance",12.5f)
+            .AddBool("AllowLockPick",true)
+            .AddObjectArray("EquipConflictingDevices",{0x01000010U,0x00000D62U})
+            .AddStringArray("Messages",{"first","","third"})
+            .AddIntArray("Levels",{1,-2,3})
+            .AddFloatArray("Chances",{0.5f,1.5f})
+            .AddBoolArray("Flags",{true,false,true});
+    }
+
+    EspBuilder MakeDevices(size_t a_count)
+    {
+        EspBuilder loc_esp;
+        loc_esp.AddMaster("Skyrim.esm").AddMaster("Devious Devices - Integration.esm");
+        for (uint32_t i = 0; i < a_count; i++)
+        {
+            loc_esp.AddRecord(RecordBuilder("ARMO",loc_esp.GetFormID(0x800 + i))
+                .SetEditorID("zadTestDevice" + std::to_string(i))
+                .SetScripts(VmadBuilder().AddScript("zadEquipScript").AddObject("deviceInventory",loc_esp.GetFormID(0x800 + i)).AddInt("index",static_cast<int32_t>(i))));
+        }
+        return loc_esp;
+    }
+}
+
+TEST_CASE("Parser reads masters and all property types", "[DeviceParser]")
+{
+    EspBuilder loc_esp;
+    loc_esp.SetFlags(EspBuilder::fLight).AddMaster("Skyrim.esm").AddMaster("Devious Devices - Assets.esm");
+    loc_esp.AddRecord(RecordBuilder("ARMO",loc_esp.GetFormID(0x801))
+        .SetEditorID("zadTestDevice")
+        .SetScripts(MakeAllTypes())
+        .SetKeywords({0x01000001U,0x01000002U,0x02000003U}));
+
+    const auto loc_mod = Parse(loc_esp.Build());
+    REQUIRE(loc_mod->masters == std::vector<std::string>{"Skyrim.esm","Devious Devices - Assets.esm","Test.esp"});
+    REQUIRE(loc_mod->devicerecords.size() == 1);
+
+    const auto& loc_device = *loc_mod->devicerecords[0];
+    REQUIRE(loc_device.source == "Test.esp");
+    REQUIRE(loc_device.editorID == "zadTestDevice");
+    REQUIRE(loc_device.scripts.scripts.size() == 1);
+    REQUIRE(loc_device.scripts.scripts[0]->scriptName == "zadEquipScript");
+
+    REQUIRE(loc_device.GetPropertyOBJ("deviceinventory",0,true) == 0x02000801U);   //names are case insensitive
+    REQUIRE(loc_device.GetPropertySTR("deviceName","") == "Test Device");
+    REQUIRE(loc_device.GetPropertyINT("LockAccessDifficulty",0) == -30);
+    REQUIRE(loc_device.GetPropertyFLT("BaseEscapeChance",0.0f) == 12.5f);
+    REQUIRE(loc_device.GetPropertyBOL("AllowLockPick",false));
+    REQUIRE(loc_device.GetPropertyOBJA("EquipConflictingDevices") == std::vector<uint32_t>{0x01000010U,0x00000D62U});
+    REQUIRE(loc_device.GetPropertySTRA("Messages") == std::vector<std::string>{"first","","third"});
+    REQUIRE(loc_device.GetPropertyINTA("Levels") == std::vector<int32_t>{1,-2,3});
+    REQUIRE(loc_device.GetPropertyFLTA("Chances") == std::vector<float>{0.5f,1.5f});
+    REQUIRE(loc_device.GetPropertyBOLA("Flags") == std::vector<bool>{true,false,true});
+
+    //missing property returns default, wrong type returns empty value
+    REQUIRE(loc_device.GetPropertyINT("Missing",7) == 7);
+    REQUIRE(loc_device.GetPropertyINTA("Chances").empty());
+
+    REQUIRE(loc_device.keywords.ksiz.keywordcount == 3);
+    REQUIRE(loc_device.keywords.kwda.data.get()[2] == 0x02000003U);
+    REQUIRE(loc_mod->GetSource(0x01000010U) == "Devious Devices - Assets.esm");
+    REQUIRE(loc_mod->GetSource(0x05000010U) == "Test.esp");
+}
+
+TEST_CASE("Parser skips other groups and compressed records", "[DeviceParser]")
+{
+    EspBuilder loc_esp = MakeDevices(3);
+    loc_esp.AddRecord(RecordBuilder("WEAP",loc_esp.GetFormID(0x900)).SetEditorID("zadTestWeapon"));
+    loc_esp.AddRecord(RecordBuilder("ARMO",loc_esp.GetFormID(0x901))
+        .SetScripts(VmadBuilder().AddObject("deviceInventory",loc_esp.GetFormID(0x901)))
+        .SetKeywords({0x01000001U})
+        .SetCompressed(true));
+    loc_esp.AddRecord(RecordBuilder("ARMO",loc_esp.GetFormID(0x902)).SetScripts(VmadBuilder().AddInt("index",42)));
+
+    const auto loc_mod = Parse(loc_esp.Build());
+    REQUIRE(loc_mod->devicerecords.size() == 5);
+    REQUIRE(loc_mod->devicerecords[2]->GetPropertyINT("index",-1) == 2);
+
+    //compressed record is kept, but its data is not read as fields
+    REQUIRE(loc_mod->devicerecords[3]->record.formId == loc_esp.GetFormID(0x901));
+    REQUIRE(loc_mod->devicerecords[3]->scripts.scripts.empty());
+    REQUIRE(loc_mod->devicerecords[3]->keywords.kwda.data == nullptr);
+    REQUIRE(loc_mod->devicerecords[4]->GetPropertyINT("index",-1) == 42);
+}
+
+TEST_CASE("Parser only loads records with existing forms", "[DeviceParser]")
+{
+    struct OddResolver : FormResolver
+    {
+        bool HasForm(uint32_t a_formID, const std::string& a_mod) const override { return a_mod == "Test.esp" && (a_formID & 1U); }
+    } loc_resolver;
+
+    const auto loc_mod = Parse(MakeDevices(4).Build(),"Test.esp",&loc_resolver);
+    REQUIRE(loc_mod->devicerecords.size() == 4);
+    for (size_t i = 0; i < 4; i++) REQUIRE(loc_mod->devicerecords[i]->scripts.scripts.empty() == (i % 2 == 0));
+}
+
+TEST_CASE("Parser survives truncated files", "[DeviceParser]")
+{
+    const std::vector<uint8_t> loc_data = MakeDevices(5).Build();
+    for (size_t loc_size = 0; loc_size < loc_data.size(); loc_size += 7)
+    {
+        const auto loc_mod = Parse(std::vector<uint8_t>(loc_data.begin(),loc_data.begin() + loc_size));
+        REQUIRE(loc_mod->devicerecords.size() <= 5);
+    }
+}
+
+TEST_CASE("Parser discards devices with malformed scripts", "[DeviceParser]")
+{
+    auto loc_parse = [](const std::function<void(RecordBuilder&)>& a_scripts)
+    {
+        EspBuilder loc_esp;
+        loc_esp.AddMaster("Skyrim.esm");
+        RecordBuilder loc_broken("ARMO",loc_esp.GetFormID(0x801));
+        loc_broken.SetEditorID("zadBrokenDevice");
+        a_scripts(loc_broken);
+        loc_esp.AddRecord(loc_broken.SetKeywords({0x01000001U}));
+        loc_esp.AddRecord(RecordBuilder("ARMO",loc_esp.GetFormID(0x802)).SetScripts(VmadBuilder().AddScript("zadEquipScript").AddInt("index",42)));
+
+        //broken device is kept without scripts and keywords, and next device is still read
+        const auto loc_mod = Parse(loc_esp.Build());
+        REQUIRE(loc_mod->devicerecords.size() == 2);
+        REQUIRE(loc_mod->devicerecords[0]->editorID == "zadBrokenDevice");
+        REQUIRE(loc_mod->devicerecords[0]->scripts.scripts.empty());
+        REQUIRE(loc_mod->devicerecords[0]->keywords.kwda.data == nullptr);
+        REQUIRE(loc_mod->devicerecords[1]->GetPropertyINT("index",-1) == 42);
+    };
+
+    //cut inside every value of every property type
+    const size_t loc_size = MakeAllTypes().Build().size();
+    for (size_t loc_cut = 0; loc_cut < loc_size; loc_cut++)
+    {
+        loc_parse([&](RecordBuilder& a_record){ a_record.SetTruncatedScripts(MakeAllTypes(),loc_cut); });
+    }
+
+    //lengths and counts which do not fit. 0x40000000 ints would overflow 32 bit size to 0
+    for (uint32_t loc_count : {0xFFFFFFFFU,0x40000000U,4U})
+    {
+        loc_parse([&](RecordBuilder& a_record)
+        {
+            a_record.AddField("VMAD",[&](ByteWriter& a_out)
+            {
+                a_out.U16(5U);
+                a_out.U16(2U);
+                a_out.U16(1U);
+                a_out.WString("zadEquipScript");
+                a_out.U8(0U);
+                a_out.U16(1U);
+                a_out.WString("Levels");
+                a_out.U8(static_cast<uint8_t>(DeviousDevices::Property::PropertyTypes::kArrayInt));
+                a_out.U8(1U);
+                a_out.U32(loc_count);
+                a_out.U32(1U);
+            });
+        });
+    }
+    loc_parse([](RecordBuilder& a_record)
+    {
+        a_record.AddField("VMAD",[](ByteWriter& a_out){ a_out.U16(5U); a_out.U16(2U); a_out.U16(1U); a_out.U16(0xFFFFU); a_out.ZString("zadEquipScript"); });
+    });
+}
+
+TEST_CASE("Parser stops at truncated header", "[DeviceParser]")
+{
+    //plugin without records is only TES4 header. Master field added to its end claims more data than header has
+    EspBuilder loc_esp;
+    loc_esp.AddMaster("Skyrim.esm");
+    std::vector<uint8_t> loc_data = loc_esp.Build();
+    const std::vector<uint8_t> loc_field = {'M','A','S','T',0xFF,0x00,'X'};
+    loc_data.insert(loc_data.end(),loc_field.begin(),loc_field.end());
+    loc_data[4] = static_cast<uint8_t>(loc_data[4] + loc_field.size());
+
+    const auto loc_mod = Parse(loc_data);
+    REQUIRE(loc_mod->masters == std::vector<std::string>{"Skyrim.esm","Test.esp"});
+}
+
+TEST_CASE("Compressed record data is valid zlib stream", "[DeviceParser]")
+{
+    const std::vector<uint8_t> loc_data(70000,0xAB);   //more than one stored block
+    const std::vector<uint8_t> loc_compressed = RecordBuilder::Compress(loc_data);
+    REQUIRE(loc_compressed.size() == 4 + 2 + 2*5 + loc_data.size() + 4);
+    REQUIRE(loc_compressed[4] == 0x78);
+    REQUIRE(((loc_compressed[4] << 8) | loc_compressed[5]) % 31 == 0);
+    REQUIRE(loc_compressed[6] == 0);                                //first block is not final
+    REQUIRE(loc_compressed[6 + 5 + 0xFFFF] == 1);                   //second block is final
+}
+
+TEST_CASE("Bulk property getters match single getters", "[DeviceParser]")
+{
+    EspBuilder loc_esp;
+    loc_esp.AddMaster("Skyrim.esm");
+    loc_esp.AddRecord(RecordBuilder("ARMO",loc_esp.GetFormID(0x801))
+        .SetScripts(VmadBuilder()
+            .AddScript("zadEquipScript")
+            .AddObject("deviceKey",0x00000010U)
+            .AddString("deviceName","Test Device")
+            .AddInt("LockAccessDifficulty",-30)
+            .AddFloat("BaseEscapeChance",12.5f)
+            .AddBool("AllowLockPick",true)));
+
+    const auto loc_mod = Parse(loc_esp.Build());
+    const auto& loc_device = *loc_mod->devicerecords[0];
+
+    //existing property, different case, missing property and property of incorrect type
+    const std::vector<std::string> loc_names = {"LockAccessDifficulty","baseescapechance","Missing","deviceName"};
+    REQUIRE(loc_device.GetPropertiesINT(loc_names,{1,2,3,4}) == std::vector<int32_t>{-30,0,3,0});
+    REQUIRE(loc_device.GetPropertiesFLT(loc_names,{}) == std::vector<float>{0.0f,12.5f,0.0f,0.0f});
+    REQUIRE(loc_device.GetPropertiesSTR(loc_names,{"a","b","c"}) == std::vector<std::string>{"","","c","Test Device"});
+    REQUIRE(loc_device.GetPropertiesBOL({"AllowLockPick","Missing"},{false,true}) == std::vector<bool>{true,true});
+    REQUIRE(loc_device.GetPropertiesOBJ({"DEVICEKEY","Missing"},{}) == std::vector<uint32_t>{0x00000010U,0U});
+    REQUIRE(loc_device.GetPropertiesSTR({"deviceName","DEVICENAME"},{}) == std::vector<std::string>{"Test Device","Test Device"});
+    REQUIRE(loc_device.GetPropertiesINT({},{}).empty());
+
+    for (size_t i = 0; i < loc_names.size(); i++)
+    {
+        REQUIRE(loc_device.GetPropertiesINT({loc_names[i]},{7})[0] == loc_device.GetPropertyINT(loc_names[i],7));
+        REQUIRE(loc_device.GetPropertiesFLT({loc_names[i]},{7.0f})[0] == loc_device.GetPropertyFLT(loc_names[i],7.0f));
+        REQUIRE(loc_device.GetPropertiesSTR({loc_names[i]},{"x"})[0] == loc_device.GetPropertySTR(loc_names[i],"x"));
+        REQUIRE((loc_device.FindProperty(loc_names[i]) != nullptr) == (loc_device.GetPropertyRaw(loc_names[i]).first != nullptr));
+    }
+}
+
+TEST_CASE("Device history gives access to every override", "[DeviceParser]")
+{
+    //original device in master, overridden by two patches
+    EspBuilder loc_base;
+    loc_base.SetFlags(EspBuilder::fMaster);
+    loc_base.AddRecord(RecordBuilder("ARMO",0x00000801U).SetScripts(VmadBuilder()
+        .AddString("deviceName","Base").AddInt("LockAccessDifficulty",10).AddObject("deviceKey",0x00000900U)));
+
+    EspBuilder loc_patch1;
+    loc_patch1.AddMaster("Base.esm");
+    loc_patch1.AddRecord(RecordBuilder("ARMO",0x00000801U).SetScripts(VmadBuilder()
+        .AddString("deviceName","Patch1").AddInt("LockAccessDifficulty",20)));
+
+    EspBuilder loc_patch2;
+    loc_patch2.AddMaster("Base.esm").AddMaster("Patch1.esp");
+    loc_patch2.AddRecord(RecordBuilder("ARMO",0x00000801U).SetScripts(VmadBuilder()
+        .AddString("deviceName","Patch2").AddInt("LockAccessDifficulty",30).AddFloat("BaseEscapeChance",5.0f).AddObject("deviceKey",0x00000900U)));
+
+    const std::shared_ptr<DeviceMod> loc_mods[3] = {Parse(loc_base.Build(),"Base.esm"),Parse(loc_patch1.Build(),"Patch1.esp"),Parse(loc_patch2.Build(),"Patch2.esp")};
+
+    //versions are sorted by load order, no matter in which order they were found
+    const DeviceHistory loc_history({{2,loc_mods[2]->devicerecords[0]},{0,loc_mods[0]->devicerecords[0]},{1,loc_mods[1]->devicerecords[0]}});
+    REQUIRE(loc_history.GetVersionCount() == 3);
+    REQUIRE(loc_history.GetModNames() == std::vector<std::string>{"Base.esm","Patch1.esp","Patch2.esp"});
+    REQUIRE(loc_history.GetOriginal() == loc_mods[0]->devicerecords[0].get());
+    REQUIRE(loc_history.GetFinal() == loc_mods[2]->devicerecords[0].get());
+    REQUIRE(loc_history.GetVersion(1) == loc_mods[1]->devicerecords[0].get());
+    REQUIRE(loc_history.GetVersion(-2) == loc_mods[1]->devicerecords[0].get());
+    REQUIRE(loc_history.GetVersion(-3) == loc_history.GetOriginal());
+    REQUIRE(loc_history.GetVersion(3) == nullptr);
+    REQUIRE(loc_history.GetVersion(-4) == nullptr);
+
+    for (int i = 0; i < 3; i++)
+    {
+        REQUIRE(loc_history.GetPropertyAtVersion<int32_t>(i,"LockAccessDifficulty",0) == 10*(i + 1));
+        REQUIRE(loc_history.GetPropertyAtVersion<std::string>(i - 3,"deviceName","") == loc_history.GetModNames()[i].substr(0,loc_history.GetModNames()[i].find('.')));
+    }
+    REQUIRE(loc_history.GetPropertyAtVersion<float>(-1,"BaseEscapeChance",1.0f) == 5.0f);
+    REQUIRE(loc_history.GetPropertyAtVersion<float>(0,"BaseEscapeChance",1.0f) == 1.0f);     //missing in older versions
+    REQUIRE(loc_history.GetPropertyAtVersion<bool>(5,"deviceName",true));                      //missing version
+
+    //same raw form id is resolved through masters of version it was read from
+    REQUIRE(loc_history.GetPropertyAtVersion<uint32_t>(0,"deviceKey",0U) == 0x00000900U);
+    REQUIRE(loc_history.GetPropertyAtVersion<uint32_t>(1,"deviceKey",0U) == 0U);
+    REQUIRE(loc_history.GetOriginal()->mod->GetSource(0x00000900U) == "Base.esm");
+    REQUIRE(loc_history.GetFinal()->mod->GetSource(0x00000900U) == "Base.esm");
+    REQUIRE(loc_history.GetFinal()->mod->GetSource(0x01000900U) == "Patch1.esp");
+
+    const DeviceHistory loc_empty;
+    REQUIRE(loc_empty.GetOriginal() == nullptr);
+    REQUIRE(loc_empty.GetFinal() == nullptr);
+    REQUIRE(loc_empty.GetPropertyAtVersion<int32_t>(0,"LockAccessDifficulty",-1) == -1);
+}
+
+TEST_CASE("Device init benchmark", "[.benchmark][DeviceParser]")
+{
+    //zadEquipScript has around 60 properties, and most of them are read when device is initialized
+    constexpr size_t loc_count = 60;
+    VmadBuilder loc_vmad;
+    loc_vmad.AddScript("zadEquipScript");
+    std::vector<std::string> loc_names;
+    for (size_t i = 0; i < loc_count; i++)
+    {
+        loc_names.push_back("zad_Property" + std::to_string(i));
+        loc_vmad.AddInt(loc_names.back(),static_cast<int32_t>(i));
+    }
+
+    EspBuilder loc_esp;
+    loc_esp.AddMaster("Skyrim.esm");
+    loc_esp.AddRecord(RecordBuilder("ARMO",loc_esp.GetFormID(0x801)).SetScripts(loc_vmad));
+    const auto loc_mod = Parse(loc_esp.Build());
+    const auto& loc_device = *loc_mod->devicerecords[0];
+
+    constexpr size_t loc_repeats = 2000;
+    int64_t loc_sum = 0;
+    auto loc_measure = [&](auto a_function)
+    {
+        const auto loc_start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < loc_repeats; r++) a_function();
+        return std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now() - loc_start).count()/loc_repeats;
+    };
+
+    const double loc_single = loc_measure([&]{ for (auto&& it : loc_names) loc_sum += loc_device.GetPropertyINT(it,0); });
+    const double loc_bulk   = loc_measure([&]{ for (auto&& it : loc_device.GetPropertiesINT(loc_names,{})) loc_sum += it; });
+    REQUIRE(loc_sum == 2*loc_repeats*(loc_count*(loc_count - 1)/2));
+    std::printf("%zu properties: single = %.2f us, bulk = %.2f us per device\n",loc_count,loc_single,loc_bulk);
+}
+
+TEST_CASE("Parser scaling benchmark", "[.benchmark][DeviceParser]")
+{
+    for (size_t loc_devices : {1000,10000,50000})
+    {
+        const std::vector<uint8_t> loc_data = MakeDevices(loc_devices).Build();
+        const auto loc_start = std::chrono::steady_clock::now();
+        const auto loc_mod = Parse(loc_data);
+        const double loc_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - loc_start).count();
+        REQUIRE(loc_mod->devicerecords.size() == loc_devices);
+        std::printf("%zu devices: %.2f ms, %.1f MB/s\n",loc_devices,loc_time*1000.0,loc_data.size()/loc_time/(1024.0*1024.0));
+    }
+}
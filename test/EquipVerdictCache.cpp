@@ -0,0 +1,134 @@
+#include <catch.hpp>
+#include "EquipVerdictCache.h"
+
+using DeviousDevices::EquipVerdictCache;
+
+TEST_CASE("Equip verdict cache is invalidated per actor and globally", "[EquipVerdictCache]")
+{
+    EquipVerdictCache loc_cache;
+    uint64_t loc_ticket = 0;
+    REQUIRE_FALSE(loc_cache.Find(1,0x100,loc_ticket).has_value());
+    loc_cache.Store(1,0x100,loc_ticket,true);
+    REQUIRE(loc_cache.Find(2,0x200,loc_ticket) == std::nullopt);
+    loc_cache.Store(2,0x200,loc_ticket,false);
+
+    REQUIRE(loc_cache.Find(1,0x100,loc_ticket) == true);
+    REQUIRE(loc_cache.Find(2,0x200,loc_ticket) == false);
+    REQUIRE(loc_cache.Find(1,0x200,loc_ticket) == std::nullopt);
+
+    loc_cache.InvalidateActor(1);
+    REQUIRE(loc_cache.Find(1,0x100,loc_ticket) == std::nullopt);
+    REQUIRE(loc_cache.Find(2,0x200,loc_ticket) == false);
+
+    loc_cache.InvalidateAll();
+    REQUIRE(loc_cache.Find(2,0x200,loc_ticket) == std::nullopt);
+    REQUIRE(loc_cache.Size() == 0);
+
+    const EquipVerdictCache::Stats loc_stats = loc_cache.GetStats(true);
+    REQUIRE(loc_stats.hits == 3);
+    REQUIRE(loc_stats.misses == 5);
+    REQUIRE(loc_cache.GetStats(false).hits == 0);
+}
+
+TEST_CASE("Equip verdict computed before invalidation is not stored", "[EquipVerdictCache]")
+{
+    EquipVerdictCache loc_cache;
+    uint64_t loc_ticket = 0;
+
+    //actor equipment changed while verdict was computed
+    loc_cache.Find(1,0x100,loc_ticket);
+    loc_cache.InvalidateActor(1);
+    loc_cache.Store(1,0x100,loc_ticket,true);
+    REQUIRE(loc_cache.Find(1,0x100,loc_ticket) == std::nullopt);
+
+    //menu was opened while verdict was computed
+    loc_cache.InvalidateAll();
+    loc_cache.Find(1,0x100,loc_ticket);
+    loc_cache.InvalidateAll();
+    loc_cache.Store(1,0x100,loc_ticket,true);
+    REQUIRE(loc_cache.Find(1,0x100,loc_ticket) == std::nullopt);
+
+    //same after clear, even though actor generations are reset
+    loc_cache.Find(1,0x100,loc_ticket);
+    loc_cache.Clear();
+    loc_cache.Store(1,0x100,loc_ticket,true);
+    REQUIRE(loc_cache.Find(1,0x100,loc_ticket) == std::nullopt);
+
+    loc_cache.Store(1,0x100,loc_ticket,false);
+    REQUIRE(loc_cache.Find(1,0x100,loc_ticket) == false);
+}
+
+TEST_CASE("Equip verdict outfit churn benchmark", "[.benchmark][EquipVerdictCache]")
+{
+    //outfit churn trace - follower/outfit mods re-equip whole outfit of NPC every few frames.
+    //Equip event of actor invalidates its verdicts, menu opens invalidate everything
+    enum EventType { eEquip, eEquipEvent, eMenu };
+    struct Event { EventType type; uint32_t actor; uint32_t item; };
+
+    constexpr uint32_t loc_actors = 24;
+    constexpr uint32_t loc_outfit = 7;
+    std::mt19937 loc_rnd(38U);
+    std::vector<Event> loc_trace;
+    for (int loc_tick = 0; loc_tick < 20000; loc_tick++)
+    {
+        const uint32_t loc_actor = loc_rnd() % loc_actors;
+        for (uint32_t i = 0; i < loc_outfit; i++) loc_trace.push_back({eEquip,loc_actor,0x1000 + loc_actor*16 + i});
+        if (loc_rnd() % 20 == 0) loc_trace.push_back({eEquipEvent,loc_actor,0});
+        if (loc_rnd() % 500 == 0) loc_trace.push_back({eMenu,0,0});
+    }
+
+    //filter cost - whitelist, device slot conflict, two scans of worn items for heavy bondage and mittens
+    std::vector<std::vector<uint32_t>> loc_worn(loc_actors);
+    for (auto&& it : loc_worn) for (int i = 0; i < 24; i++) it.push_back(loc_rnd());
+    volatile uint32_t loc_sink = 0;
+    auto loc_compute = [&](uint32_t a_actor, uint32_t a_item)
+    {
+        uint32_t loc_res = a_item;
+        for (int k = 0; k < 3; k++)
+            for (uint32_t it : loc_worn[a_actor]) loc_res ^= (it * 0x9E3779B9U) >> (k + 3);
+        std::string loc_name = std::to_string(a_item) + " iron armor of the north";
+        std::transform(loc_name.begin(),loc_name.end(),loc_name.begin(),::tolower);
+        loc_res ^= static_cast<uint32_t>(loc_name.find("ebony"));
+        return (loc_res & 0x7) == 0;
+    };
+
+    const auto loc_start = std::chrono::steady_clock::now();
+    size_t loc_equips = 0;
+    for (auto&& it : loc_trace)
+    {
+        if (it.type != eEquip) continue;
+        loc_sink = loc_sink + loc_compute(it.actor,it.item);
+        loc_equips++;
+    }
+    const double loc_oldTime = std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - loc_start).count()/loc_equips;
+
+    EquipVerdictCache loc_cache;
+    const auto loc_start2 = std::chrono::steady_clock::now();
+    for (auto&& it : loc_trace)
+    {
+        switch (it.type)
+        {
+            case eEquip:
+            {
+                uint64_t loc_ticket = 0;
+                const auto loc_verdict = loc_cache.Find(it.actor,it.item,loc_ticket);
+                if (loc_verdict.has_value())
+                {
+                    loc_sink = loc_sink + *loc_verdict;
+                    break;
+                }
+                const bool loc_res = loc_compute(it.actor,it.item);
+                loc_cache.Store(it.actor,it.item,loc_ticket,loc_res);
+                loc_sink = loc_sink + loc_res;
+                break;
+            }
+            case eEquipEvent: loc_cache.InvalidateActor(it.actor); break;
+            case eMenu: loc_cache.InvalidateAll(); break;
+        }
+    }
+    const double loc_newTime = std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - loc_start2).count()/loc_equips;
+    const EquipVerdictCache::Stats loc_stats = loc_cache.GetStats(false);
+
+    std::printf("%zu equips: uncached %.1f ns, cached %.1f ns per equip (hit rate %.1f %%)\n",loc_equips,loc_oldTime,loc_newTime,
+        100.0*loc_stats.hits/(loc_stats.hits + loc_stats.misses));
+}
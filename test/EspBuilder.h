@@ -0,0 +1,288 @@
+#pragma once
+
+#include "DeviceParser.h"
+
+// Builder of synthetic plugin files for parser tests, fuzz seeds and benchmarks. Output follows TES4 plugin format:
+// TES4 header record with masters, followed by top level groups of records. Header only and uses only standard library,
+// so it is shared by test and host bench projects
+
+namespace DeviousDevices::Fixtures
+{
+    class ByteWriter
+    {
+    public:
+        void U8(uint8_t a_value) { data.push_back(a_value); }
+        void U16(uint16_t a_value) { for (int i = 0; i < 2; i++) data.push_back(static_cast<uint8_t>(a_value >> (8*i))); }
+        void U32(uint32_t a_value) { for (int i = 0; i < 4; i++) data.push_back(static_cast<uint8_t>(a_value >> (8*i))); }
+        void F32(float a_value)
+        {
+            uint32_t loc_raw;
+            std::memcpy(&loc_raw,&a_value,sizeof(loc_raw));
+            U32(loc_raw);
+        }
+        void Tag(std::string_view a_tag) { data.insert(data.end(),a_tag.begin(),a_tag.begin() + 4); }
+        void Bytes(const std::vector<uint8_t>& a_bytes) { data.insert(data.end(),a_bytes.begin(),a_bytes.end()); }
+        void ZString(std::string_view a_value) { data.insert(data.end(),a_value.begin(),a_value.end()); data.push_back(0U); }
+        void WString(std::string_view a_value)
+        {
+            U16(static_cast<uint16_t>(a_value.size()));
+            data.insert(data.end(),a_value.begin(),a_value.end());
+        }
+
+        std::vector<uint8_t> data;
+    };
+
+    // VMAD field. Properties are added to last added script
+    class VmadBuilder
+    {
+    public:
+        VmadBuilder& AddScript(std::string_view a_name)
+        {
+            _scripts.push_back({std::string(a_name),0,{}});
+            return *this;
+        }
+
+        VmadBuilder& AddObject(std::string_view a_name, uint32_t a_formID)  { return Add(a_name,Property::PropertyTypes::kObject,[&](ByteWriter& a_out){ Object(a_out,a_formID); }); }
+        VmadBuilder& AddString(std::string_view a_name, std::string_view a_value) { return Add(a_name,Property::PropertyTypes::kWString,[&](ByteWriter& a_out){ a_out.WString(a_value); }); }
+        VmadBuilder& AddInt(std::string_view a_name, int32_t a_value)       { return Add(a_name,Property::PropertyTypes::kInt,[&](ByteWriter& a_out){ a_out.U32(static_cast<uint32_t>(a_value)); }); }
+        VmadBuilder& AddFloat(std::string_view a_name, float a_value)       { return Add(a_name,Property::PropertyTypes::kFloat,[&](ByteWriter& a_out){ a_out.F32(a_value); }); }
+        VmadBuilder& AddBool(std::string_view a_name, bool a_value)         { return Add(a_name,Property::PropertyTypes::kBool,[&](ByteWriter& a_out){ a_out.U8(a_value ? 1U : 0U); }); }
+
+        VmadBuilder& AddObjectArray(std::string_view a_name, const std::vector<uint32_t>& a_values)
+        {
+            return Add(a_name,Property::PropertyTypes::kArrayObject,[&](ByteWriter& a_out){ a_out.U32(static_cast<uint32_t>(a_values.size())); for (auto&& it : a_values) Object(a_out,it); });
+        }
+        VmadBuilder& AddStringArray(std::string_view a_name, const std::vector<std::string>& a_values)
+        {
+            return Add(a_name,Property::PropertyTypes::kArrayWString,[&](ByteWriter& a_out){ a_out.U32(static_cast<uint32_t>(a_values.size())); for (auto&& it : a_values) a_out.WString(it); });
+        }
+        VmadBuilder& AddIntArray(std::string_view a_name, const std::vector<int32_t>& a_values)
+        {
+            return Add(a_name,Property::PropertyTypes::kArrayInt,[&](ByteWriter& a_out){ a_out.U32(static_cast<uint32_t>(a_values.size())); for (auto&& it : a_values) a_out.U32(static_cast<uint32_t>(it)); });
+        }
+        VmadBuilder& AddFloatArray(std::string_view a_name, const std::vector<float>& a_values)
+        {
+            return Add(a_name,Property::PropertyTypes::kArrayFloat,[&](ByteWriter& a_out){ a_out.U32(static_cast<uint32_t>(a_values.size())); for (auto&& it : a_values) a_out.F32(it); });
+        }
+        VmadBuilder& AddBoolArray(std::string_view a_name, const std::vector<bool>& a_values)
+        {
+            return Add(a_name,Property::PropertyTypes::kArrayBool,[&](ByteWriter& a_out){ a_out.U32(static_cast<uint32_t>(a_values.size())); for (bool it : a_values) a_out.U8(it ? 1U : 0U); });
+        }
+
+        std::vector<uint8_t> Build() const
+        {
+            ByteWriter loc_out;
+            loc_out.U16(5U);    //version
+            loc_out.U16(2U);    //object format - formID after alias
+            loc_out.U16(static_cast<uint16_t>(_scripts.size()));
+            for (auto&& it : _scripts)
+            {
+                loc_out.WString(it.name);
+                loc_out.U8(0U);
+                loc_out.U16(it.count);
+                loc_out.Bytes(it.properties);
+            }
+            return loc_out.data;
+        }
+
+    private:
+        struct ScriptData
+        {
+            std::string             name;
+            uint16_t                count;
+            std::vector<uint8_t>    properties;
+        };
+
+        static void Object(ByteWriter& a_out, uint32_t a_formID)
+        {
+            a_out.U16(0U);          //unused
+            a_out.U16(0xFFFFU);     //alias
+            a_out.U32(a_formID);
+        }
+
+        template <typename F>
+        VmadBuilder& Add(std::string_view a_name, Property::PropertyTypes a_type, F&& a_value)
+        {
+            if (_scripts.empty()) AddScript("zadEquipScript");
+            ByteWriter loc_out;
+            loc_out.WString(a_name);
+            loc_out.U8(static_cast<uint8_t>(a_type));
+            loc_out.U8(1U);         //status - edited
+            a_value(loc_out);
+            _scripts.back().properties.insert(_scripts.back().properties.end(),loc_out.data.begin(),loc_out.data.end());
+            _scripts.back().count++;
+            return *this;
+        }
+
+        std::vector<ScriptData> _scripts;
+    };
+
+    class RecordBuilder
+    {
+    public:
+        RecordBuilder(std::string_view a_type, uint32_t a_formID) : _type(a_type), _formID(a_formID) {}
+
+        RecordBuilder& SetEditorID(std::string_view a_editorID) { return AddField("EDID",[&](ByteWriter& a_out){ a_out.ZString(a_editorID); }); }
+        RecordBuilder& SetScripts(const VmadBuilder& a_vmad) { return AddField("VMAD",[&](ByteWriter& a_out){ a_out.Bytes(a_vmad.Build()); }); }
+
+        // Scripts cut to first a_size bytes. Field and record sizes are still correct, so only scripts are malformed
+        RecordBuilder& SetTruncatedScripts(const VmadBuilder& a_vmad, size_t a_size)
+        {
+            return AddField("VMAD",[&](ByteWriter& a_out)
+            {
+                const std::vector<uint8_t> loc_data = a_vmad.Build();
+                a_out.Bytes(std::vector<uint8_t>(loc_data.begin(),loc_data.begin() + std::min(a_size,loc_data.size())));
+            });
+        }
+        RecordBuilder& SetKeywords(const std::vector<uint32_t>& a_keywords)
+        {
+            AddField("KSIZ",[&](ByteWriter& a_out){ a_out.U32(static_cast<uint32_t>(a_keywords.size())); });
+            return AddField("KWDA",[&](ByteWriter& a_out){ for (auto&& it : a_keywords) a_out.U32(it); });
+        }
+
+        // Data is stored as zlib stream of uncompressed deflate blocks. It is valid for game and tools, and needs no compressor
+        RecordBuilder& SetCompressed(bool a_compressed) { _compressed = a_compressed; return *this; }
+
+        template <typename F>
+        RecordBuilder& AddField(std::string_view a_tag, F&& a_writer)
+        {
+            ByteWriter loc_data;
+            a_writer(loc_data);
+            _fields.Tag(a_tag);
+            _fields.U16(static_cast<uint16_t>(loc_data.data.size()));
+            _fields.Bytes(loc_data.data);
+            return *this;
+        }
+
+        const std::string& GetType() const { return _type; }
+
+        std::vector<uint8_t> Build(uint32_t a_flags = 0U) const
+        {
+            const std::vector<uint8_t> loc_data = _compressed ? Compress(_fields.data) : _fields.data;
+            ByteWriter loc_out;
+            loc_out.Tag(_type);
+            loc_out.U32(static_cast<uint32_t>(loc_data.size()));
+            loc_out.U32(a_flags | (_compressed ? DeviceRecord::fCompressed : 0U));
+            loc_out.U32(_formID);
+            loc_out.U32(0U);        //timestamp + version control
+            loc_out.U16(44U);       //internal version
+            loc_out.U16(0U);
+            loc_out.Bytes(loc_data);
+            return loc_out.data;
+        }
+
+        // Decompressed size followed by zlib stream
+        static std::vector<uint8_t> Compress(const std::vector<uint8_t>& a_data)
+        {
+            ByteWriter loc_out;
+            loc_out.U32(static_cast<uint32_t>(a_data.size()));
+            loc_out.U8(0x78U);
+            loc_out.U8(0x01U);
+            size_t loc_offset = 0;
+            do
+            {
+                const uint16_t loc_size = static_cast<uint16_t>(std::min<size_t>(a_data.size() - loc_offset,0xFFFF));
+                loc_out.U8((loc_offset + loc_size == a_data.size()) ? 1U : 0U);
+                loc_out.U16(loc_size);
+                loc_out.U16(static_cast<uint16_t>(~loc_size));
+                loc_out.data.insert(loc_out.data.end(),a_data.begin() + loc_offset,a_data.begin() + loc_offset + loc_size);
+                loc_offset += loc_size;
+            } while (loc_offset < a_data.size());
+
+            //adler32, big endian
+            uint32_t loc_a = 1, loc_b = 0;
+            for (uint8_t it : a_data)
+            {
+                loc_a = (loc_a + it) % 65521U;
+                loc_b = (loc_b + loc_a) % 65521U;
+            }
+            const uint32_t loc_adler = (loc_b << 16) | loc_a;
+            for (int i = 3; i >= 0; i--) loc_out.U8(static_cast<uint8_t>(loc_adler >> (8*i)));
+            return loc_out.data;
+        }
+
+    private:
+        std::string _type;
+        uint32_t    _formID;
+        bool        _compressed = false;
+        ByteWriter  _fields;
+    };
+
+    class EspBuilder
+    {
+    public:
+        enum Flags : uint32_t
+        {
+            fMaster = 0x00000001,
+            fLight  = 0x00000200
+        };
+
+        EspBuilder& SetFlags(uint32_t a_flags) { _flags = a_flags; return *this; }
+        EspBuilder& AddMaster(std::string_view a_master) { _masters.emplace_back(a_master); return *this; }
+
+        // Records are grouped by type in order in which types were first added
+        EspBuilder& AddRecord(const RecordBuilder& a_record)
+        {
+            auto loc_group = std::find_if(_groups.begin(),_groups.end(),[&](const auto& a_group){ return a_group.first == a_record.GetType(); });
+            if (loc_group == _groups.end())
+            {
+                _groups.emplace_back(a_record.GetType(),std::vector<uint8_t>());
+                loc_group = std::prev(_groups.end());
+            }
+            const std::vector<uint8_t> loc_data = a_record.Build();
+            loc_group->second.insert(loc_group->second.end(),loc_data.begin(),loc_data.end());
+            _records++;
+            return *this;
+        }
+
+        // Form id of record defined by this plugin. Its mod index is after last master
+        uint32_t GetFormID(uint32_t a_localID) const { return (static_cast<uint32_t>(_masters.size()) << 24) | (a_localID & 0x00FFFFFF); }
+
+        size_t GetRecordCount() const { return _records; }
+
+        std::vector<uint8_t> Build() const
+        {
+            RecordBuilder loc_header("TES4",0U);
+            loc_header.AddField("HEDR",[&](ByteWriter& a_out)
+            {
+                a_out.F32(1.7f);
+                a_out.U32(static_cast<uint32_t>(_records));
+                a_out.U32(0x800U);  //next object id
+            });
+            for (auto&& it : _masters)
+            {
+                loc_header.AddField("MAST",[&](ByteWriter& a_out){ a_out.ZString(it); });
+                loc_header.AddField("DATA",[](ByteWriter& a_out){ a_out.U32(0U); a_out.U32(0U); });
+            }
+
+            ByteWriter loc_out;
+            loc_out.Bytes(loc_header.Build(_flags));
+            for (auto&& [type,records] : _groups)
+            {
+                loc_out.Tag("GRUP");
+                loc_out.U32(static_cast<uint32_t>(records.size() + 24));    //group size includes header
+                loc_out.Tag(type);
+                loc_out.U32(0U);    //top group
+                loc_out.U32(0U);    //timestamp + version control
+                loc_out.U32(0U);
+                loc_out.Bytes(records);
+            }
+            return loc_out.data;
+        }
+
+        bool WriteFile(const std::filesystem::path& a_path) const
+        {
+            const std::vector<uint8_t> loc_data = Build();
+            std::ofstream loc_file(a_path,std::ios::binary | std::ios::out | std::ios::trunc);
+            if (!loc_file.is_open()) return false;
+            loc_file.write(reinterpret_cast<const char*>(loc_data.data()),static_cast<std::streamsize>(loc_data.size()));
+            return loc_file.good();
+        }
+
+    private:
+        uint32_t                                                _flags      = 0U;
+        size_t                                                  _records    = 0;
+        std::vector<std::string>                                _masters;
+        std::vector<std::pair<std::string,std::vector<uint8_t>>> _groups;
+    };
+}
@@ -0,0 +1,259 @@
+#include <catch.hpp>
+#include "ExpressionLayers.h"
+
+using DeviousDevices::ComposedExpression;
+using DeviousDevices::Expression;
+using DeviousDevices::ExpressionLayerStack;
+
+namespace
+{
+    Expression MakeExpression(float a_value, float a_mood = 0.0f, float a_moodStrength = 0.0f)
+    {
+        Expression loc_res;
+        for (size_t i = 0; i < Expression::ExpressionID; i++) loc_res[i] = a_value;
+        loc_res[Expression::ExpressionID]  = a_mood;
+        loc_res[Expression::ExpressionStr] = a_moodStrength;
+        return loc_res;
+    }
+
+    //composes until stack settles, returns number of composes
+    int Settle(ExpressionLayerStack& a_stack, float a_delta, ComposedExpression& a_result)
+    {
+        int loc_res = 0;
+        while (!a_stack.IsSettled() && loc_res < 10000)
+        {
+            a_stack.Compose(a_delta,a_result);
+            loc_res++;
+        }
+        return loc_res;
+    }
+}
+
+TEST_CASE("Instant layer is applied on first compose", "[ExpressionLayers]")
+{
+    ExpressionLayerStack loc_stack;
+    ComposedExpression loc_res;
+
+    loc_stack.SetLayer(DeviousDevices::lMod,0,MakeExpression(0.5f,3.0f,0.8f),DeviousDevices::ExpressionAllMask,1.0f,0.0f);
+    REQUIRE(loc_stack.Compose(0.0f,loc_res) == DeviousDevices::ExpressionAllMask);
+    REQUIRE(loc_res.values == MakeExpression(0.5f,3.0f,0.8f));
+    REQUIRE(loc_res.mood);
+    REQUIRE(loc_stack.IsSettled());
+
+    //nothing changed, so nothing have to be written
+    REQUIRE(loc_stack.Compose(0.016f,loc_res) == 0);
+}
+
+TEST_CASE("Higher priority layer wins", "[ExpressionLayers]")
+{
+    ExpressionLayerStack loc_stack;
+    ComposedExpression loc_res;
+
+    loc_stack.SetLayer(DeviousDevices::lMod,50,MakeExpression(0.7f,2.0f,1.0f),DeviousDevices::ExpressionAllMask,1.0f,0.0f);
+    loc_stack.SetLayer(DeviousDevices::lMod,10,MakeExpression(0.2f,5.0f,0.5f),DeviousDevices::ExpressionAllMask,1.0f,0.0f);
+    loc_stack.Compose(0.0f,loc_res);
+    REQUIRE(loc_res.values == MakeExpression(0.7f,2.0f,1.0f));
+    REQUIRE(loc_stack.GetTopPriority(DeviousDevices::lMod) == 50);
+    REQUIRE(loc_stack.GetTopPriority(DeviousDevices::lGag) == INT_MIN);
+
+    //removing the top layer reveals the lower one
+    REQUIRE(loc_stack.RemoveLayers(DeviousDevices::lMod,50,0.0f) == 2);
+    loc_stack.SetLayer(DeviousDevices::lMod,10,MakeExpression(0.2f,5.0f,0.5f),DeviousDevices::ExpressionAllMask,1.0f,0.0f);
+    loc_stack.Compose(0.0f,loc_res);
+    REQUIRE(loc_res.values == MakeExpression(0.2f,5.0f,0.5f));
+}
+
+TEST_CASE("Partial weight blends over lower layers", "[ExpressionLayers]")
+{
+    ExpressionLayerStack loc_stack;
+    ComposedExpression loc_res;
+
+    loc_stack.SetLayer(DeviousDevices::lMod,0,MakeExpression(0.0f),DeviousDevices::ExpressionAllMask,1.0f,0.0f);
+    loc_stack.SetLayer(DeviousDevices::lMod,1,MakeExpression(1.0f),DeviousDevices::ExpressionAllMask,0.25f,0.0f);
+    loc_stack.Compose(0.0f,loc_res);
+    for (size_t i = 0; i < Expression::ExpressionID; i++) REQUIRE(loc_res.values[i] == Approx(0.25f));
+}
+
+TEST_CASE("Gag layer only overrides phonemes", "[ExpressionLayers]")
+{
+    ExpressionLayerStack loc_stack;
+    ComposedExpression loc_res;
+
+    loc_stack.SetLayer(DeviousDevices::lMod,100,MakeExpression(0.3f,1.0f,0.6f),DeviousDevices::ExpressionAllMask,1.0f,0.0f);
+    loc_stack.SetLayer(DeviousDevices::lGag,INT_MAX,MakeExpression(0.9f),DeviousDevices::ExpressionPhonemeMask,1.0f,0.0f);
+    loc_stack.Compose(0.0f,loc_res);
+
+    for (size_t i = 0; i < Expression::PhonemeCount; i++) REQUIRE(loc_res.values[i] == 0.9f);
+    for (size_t i = Expression::ModifierOffset; i < Expression::ExpressionID; i++) REQUIRE(loc_res.values[i] == 0.3f);
+    REQUIRE(loc_res.values[Expression::ExpressionID] == 1.0f);
+    REQUIRE(loc_res.values[Expression::ExpressionStr] == 0.6f);
+
+    //mod changes under the gag still only change modifiers and mood
+    loc_stack.SetLayer(DeviousDevices::lMod,100,MakeExpression(0.4f,1.0f,0.6f),DeviousDevices::ExpressionAllMask,1.0f,0.0f);
+    loc_stack.Compose(0.0f,loc_res);
+    REQUIRE(loc_res.values[0] == 0.9f);
+    REQUIRE(loc_res.values[Expression::ModifierOffset] == 0.4f);
+}
+
+TEST_CASE("Layers fade in and out over fade time", "[ExpressionLayers]")
+{
+    ExpressionLayerStack loc_stack;
+    ComposedExpression loc_res;
+
+    loc_stack.SetLayer(DeviousDevices::lMod,0,MakeExpression(1.0f,4.0f,1.0f),DeviousDevices::ExpressionAllMask,1.0f,1.0f);
+    loc_stack.Compose(0.5f,loc_res);
+    REQUIRE(loc_res.values[0] == Approx(0.5f));
+    REQUIRE(loc_res.values[Expression::ExpressionID] == 4.0f);
+    REQUIRE(loc_res.values[Expression::ExpressionStr] == Approx(0.5f));
+    REQUIRE_FALSE(loc_stack.IsSettled());
+
+    REQUIRE(Settle(loc_stack,0.1f,loc_res) <= 6);
+    REQUIRE(loc_res.values[0] == 1.0f);
+
+    //fade out, the stack is empty once the last values are composed
+    loc_stack.RemoveLayers(DeviousDevices::lMod,0,1.0f);
+    REQUIRE(loc_stack.GetTopPriority(DeviousDevices::lMod) == INT_MIN);
+    loc_stack.Compose(0.25f,loc_res);
+    REQUIRE(loc_res.values[0] == Approx(0.75f));
+    REQUIRE_FALSE(loc_stack.IsEmpty());
+
+    Settle(loc_stack,0.1f,loc_res);
+    REQUIRE(loc_stack.IsEmpty());
+    REQUIRE(loc_res.values == Expression());
+    REQUIRE_FALSE(loc_res.mood);
+}
+
+TEST_CASE("Layers fade in from base and back to it", "[ExpressionLayers]")
+{
+    ExpressionLayerStack loc_stack;
+    ComposedExpression loc_res;
+
+    //face which was on actor before first layer was added
+    ComposedExpression loc_base;
+    loc_base.values = MakeExpression(0.4f,3.0f,0.6f);
+    loc_base.mood   = true;
+    loc_stack.SetBase(loc_base);
+    REQUIRE(loc_stack.IsSettled());
+
+    //first compose does not move the face away from the base
+    loc_stack.SetLayer(DeviousDevices::lMod,0,MakeExpression(0.8f,3.0f,1.0f),DeviousDevices::ExpressionAllMask,0.5f,1.0f);
+    loc_stack.Compose(0.0f,loc_res);
+    REQUIRE(loc_res.values == loc_base.values);
+    REQUIRE(loc_res.mood);
+
+    //layer with half weight only covers half of the base
+    Settle(loc_stack,0.1f,loc_res);
+    REQUIRE(loc_res.values[0] == Approx(0.6f));
+    REQUIRE(loc_res.values[Expression::ExpressionStr] == Approx(0.8f));
+
+    loc_stack.RemoveLayers(DeviousDevices::lMod,0,0.5f);
+    loc_stack.Compose(0.25f,loc_res);
+    REQUIRE(loc_res.values[0] == Approx(0.5f));
+    Settle(loc_stack,0.1f,loc_res);
+    REQUIRE(loc_stack.IsEmpty());
+    REQUIRE(loc_res.values == loc_base.values);
+}
+
+TEST_CASE("Changing layer interpolates from current values", "[ExpressionLayers]")
+{
+    ExpressionLayerStack loc_stack;
+    ComposedExpression loc_res;
+
+    loc_stack.SetLayer(DeviousDevices::lMod,0,MakeExpression(0.2f),DeviousDevices::ExpressionAllMask,1.0f,1.0f);
+    Settle(loc_stack,0.1f,loc_res);
+    REQUIRE(loc_res.values[5] == Approx(0.2f));
+
+    loc_stack.SetLayer(DeviousDevices::lMod,0,MakeExpression(0.6f),DeviousDevices::ExpressionAllMask,1.0f,1.0f);
+    const uint32_t loc_changed = loc_stack.Compose(0.5f,loc_res);
+    REQUIRE(loc_changed == DeviousDevices::ExpressionAllMask);
+    REQUIRE(loc_res.values[5] == Approx(0.4f));
+
+    //changing values in the middle of interpolation starts from the value in the middle
+    loc_stack.SetLayer(DeviousDevices::lMod,0,MakeExpression(0.0f),DeviousDevices::ExpressionAllMask,1.0f,1.0f);
+    loc_stack.Compose(0.5f,loc_res);
+    REQUIRE(loc_res.values[5] == Approx(0.2f));
+}
+
+TEST_CASE("Only changed channels are reported", "[ExpressionLayers]")
+{
+    ExpressionLayerStack loc_stack;
+    ComposedExpression loc_res;
+
+    loc_stack.SetLayer(DeviousDevices::lMod,0,MakeExpression(0.5f),DeviousDevices::ExpressionModifierMask,1.0f,0.0f);
+    REQUIRE(loc_stack.Compose(0.0f,loc_res) == DeviousDevices::ExpressionModifierMask);
+
+    Expression loc_exp = MakeExpression(0.5f);
+    loc_exp[Expression::ModifierOffset + 2] = 0.75f;
+    loc_stack.SetLayer(DeviousDevices::lMod,1,loc_exp,1U << (Expression::ModifierOffset + 2),1.0f,0.0f);
+    REQUIRE(loc_stack.Compose(0.0f,loc_res) == (1U << (Expression::ModifierOffset + 2)));
+}
+
+TEST_CASE("Changed channels ignore differences below epsilon", "[ExpressionLayers]")
+{
+    const Expression loc_current = MakeExpression(0.5f,3.0f,0.5f);
+    REQUIRE(DeviousDevices::GetChangedChannels(loc_current,loc_current,DeviousDevices::ExpressionAllMask) == 0);
+
+    Expression loc_target = loc_current;
+    loc_target[1]  += DeviousDevices::ExpressionWriteEpsilon*0.5f;
+    loc_target[2]  += 0.1f;
+    loc_target[20] -= 0.1f;
+    REQUIRE(DeviousDevices::GetChangedChannels(loc_current,loc_target,DeviousDevices::ExpressionAllMask) == ((1U << 2) | (1U << 20)));
+
+    //channels outside of mask are not checked
+    REQUIRE(DeviousDevices::GetChangedChannels(loc_current,loc_target,DeviousDevices::ExpressionPhonemeMask) == (1U << 2));
+
+    //mood is written as whole
+    loc_target = loc_current;
+    loc_target[Expression::ExpressionID] = 4.0f;
+    REQUIRE(DeviousDevices::GetChangedChannels(loc_current,loc_target,DeviousDevices::ExpressionAllMask) == DeviousDevices::ExpressionMoodMask);
+    loc_target = loc_current;
+    loc_target[Expression::ExpressionStr] = 0.6f;
+    REQUIRE(DeviousDevices::GetChangedChannels(loc_current,loc_target,DeviousDevices::ExpressionAllMask) == DeviousDevices::ExpressionMoodMask);
+}
+
+TEST_CASE("Expression compositor benchmark", "[.benchmark][ExpressionLayers]")
+{
+    constexpr int loc_actors = 30;
+    constexpr int loc_frames = 60*60;
+    std::mt19937 loc_rnd(11U);
+    std::vector<ExpressionLayerStack> loc_stacks(loc_actors);
+    std::vector<Expression> loc_faces(loc_actors);
+
+    uint64_t loc_writes = 0;
+    uint64_t loc_facewrites = 0;
+    uint64_t loc_composes = 0;
+    const auto loc_start = std::chrono::steady_clock::now();
+    for (int loc_frame = 0; loc_frame < loc_frames; loc_frame++)
+    {
+        for (int i = 0; i < loc_actors; i++)
+        {
+            auto& loc_stack = loc_stacks[i];
+            //mods change expression every few seconds, gag is refreshed every 2 seconds
+            if ((loc_rnd() % 240) == 0)
+            {
+                const float loc_value = (loc_rnd() % 100)/100.0f;
+                loc_stack.SetLayer(DeviousDevices::lMod,loc_rnd() % 3,MakeExpression(loc_value,loc_rnd() % 17,loc_value),DeviousDevices::ExpressionAllMask,1.0f,0.25f);
+            }
+            if (((loc_frame + i) % 120) == 0)
+            {
+                loc_stack.SetLayer(DeviousDevices::lGag,INT_MAX,MakeExpression(0.7f),DeviousDevices::ExpressionPhonemeMask,1.0f,0.25f);
+            }
+
+            if (loc_stack.IsSettled()) continue;
+            ComposedExpression loc_res;
+            const uint32_t loc_changed = loc_stack.Compose(1.0f/60.0f,loc_res);
+            loc_writes += std::popcount(loc_changed);
+            loc_composes++;
+
+            //only channels which differ from the face are written
+            const uint32_t loc_write = DeviousDevices::GetChangedChannels(loc_faces[i],loc_res.values,loc_changed);
+            for (size_t c = 0; c < Expression::Size; c++) if (loc_write & (1U << c)) loc_faces[i][c] = loc_res.values[c];
+            loc_facewrites += std::popcount(loc_write);
+        }
+    }
+    const double loc_time = std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now() - loc_start).count();
+
+    std::printf("%d actors: %.2f us per frame, %.1f composes per frame, %.1f changed channels per frame, %.1f face writes per frame (%d without diffing)\n",
+        loc_actors,loc_time/loc_frames,static_cast<double>(loc_composes)/loc_frames,static_cast<double>(loc_writes)/loc_frames,
+        static_cast<double>(loc_facewrites)/loc_frames,loc_actors*32);
+}
@@ -0,0 +1,115 @@
+#include <catch.hpp>
+#include "ExpressionVector.h"
+
+using DeviousDevices::Expression;
+using DeviousDevices::GagPreset;
+
+namespace
+{
+    //previous implementation, used as reference
+    std::vector<float> ApplyStrengthReference(const std::vector<float>& a_expression, float a_strength)
+    {
+        std::vector<float> loc_res = a_expression;
+        const float loc_mult  = std::clamp(a_strength,0.0f,1.0f);
+        for (int i = 0; i < 30; i++) loc_res[i] *= loc_mult;
+        loc_res[31] *= loc_mult;
+        return loc_res;
+    }
+
+    std::vector<float> RandomExpression(std::mt19937& a_rnd)
+    {
+        std::uniform_real_distribution<float> loc_dist(0.0f,1.0f);
+        std::vector<float> loc_res(32);
+        for (auto&& it : loc_res) it = loc_dist(a_rnd);
+        loc_res[30] = static_cast<float>(a_rnd() % 17);
+        return loc_res;
+    }
+}
+
+TEST_CASE("Expression is aligned for SIMD", "[Expression]")
+{
+    REQUIRE(alignof(Expression) == 32);
+    REQUIRE(sizeof(Expression) == 32*sizeof(float));
+    REQUIRE(alignof(GagPreset) == 32);
+}
+
+TEST_CASE("Expression strength matches scalar implementation", "[Expression]")
+{
+    std::mt19937 loc_rnd(7U);
+    for (int loc_test = 0; loc_test < 1000; loc_test++)
+    {
+        const std::vector<float> loc_input = RandomExpression(loc_rnd);
+        const float loc_strength = std::uniform_real_distribution<float>(-0.5f,1.5f)(loc_rnd);
+
+        Expression loc_exp;
+        REQUIRE(Expression::FromVector(loc_input,loc_exp));
+        loc_exp.ApplyStrength(loc_strength);
+
+        REQUIRE(loc_exp.ToVector() == ApplyStrengthReference(loc_input,loc_strength));
+        REQUIRE(loc_exp[Expression::ExpressionID] == loc_input[30]);
+    }
+}
+
+TEST_CASE("Expression conversion and comparison", "[Expression]")
+{
+    Expression loc_exp;
+    REQUIRE_FALSE(Expression::FromVector(std::vector<float>(16,0.0f),loc_exp));
+    REQUIRE_FALSE(Expression::FromVector(std::vector<float>(),loc_exp));
+
+    std::vector<float> loc_vec(32,0.5f);
+    REQUIRE(Expression::FromVector(loc_vec,loc_exp));
+
+    Expression loc_other = loc_exp;
+    REQUIRE(loc_other == loc_exp);
+    for (size_t i = 0; i < Expression::Size; i++)
+    {
+        loc_other = loc_exp;
+        loc_other[i] = 0.25f;
+        REQUIRE(loc_other != loc_exp);
+    }
+
+    GagPreset loc_gag1, loc_gag2;
+    REQUIRE(loc_gag1 == loc_gag2);
+    loc_gag2[15] = 1.0f;
+    REQUIRE(loc_gag1 != loc_gag2);
+}
+
+TEST_CASE("Expression microbenchmark", "[.benchmark][Expression]")
+{
+    constexpr int loc_iterations = 1000000;
+    std::mt19937 loc_rnd(7U);
+    const std::vector<float> loc_input = RandomExpression(loc_rnd);
+    volatile float loc_sink = 0.0f;
+
+    //old path - copy, strength and compare using vectors
+    {
+        const auto loc_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < loc_iterations; i++)
+        {
+            std::vector<float> loc_exp = loc_input;
+            loc_exp[0] = 0.75f;
+            loc_exp = ApplyStrengthReference(loc_exp,0.5f + (i & 1)*0.25f);
+            std::vector<float> loc_current;
+            for (int j = 0; j < 32; j++) loc_current.push_back(loc_input[j]);
+            if (loc_current != loc_exp) loc_sink = loc_sink + loc_exp[31];
+        }
+        const double loc_time = std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - loc_start).count();
+        std::printf("std::vector: %.1f ns per apply\n",loc_time/loc_iterations);
+    }
+
+    //new path
+    {
+        Expression loc_base;
+        Expression::FromVector(loc_input,loc_base);
+        const auto loc_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < loc_iterations; i++)
+        {
+            Expression loc_exp = loc_base;
+            loc_exp[0] = 0.75f;
+            loc_exp.ApplyStrength(0.5f + (i & 1)*0.25f);
+            if (loc_base != loc_exp) loc_sink = loc_sink + loc_exp[31];
+        }
+        const double loc_time = std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - loc_start).count();
+        std::printf("Expression: %.1f ns per apply\n",loc_time/loc_iterations);
+    }
+}
@@ -0,0 +1,152 @@
+#include <catch.hpp>
+#include "GagPresetCache.h"
+
+using DeviousDevices::GagPreset;
+using DeviousDevices::GagPresetCache;
+using DeviousDevices::GagTypeIndex;
+
+namespace
+{
+    //keywords are only compared by address, so fake addresses are enough
+    const RE::BGSKeyword* FakeKeyword(uintptr_t a_id)
+    {
+        return reinterpret_cast<const RE::BGSKeyword*>(a_id*16);
+    }
+
+    GagPreset MakePreset(float a_value)
+    {
+        GagPreset loc_res;
+        loc_res.values.fill(a_value);
+        return loc_res;
+    }
+}
+
+TEST_CASE("Gag type index returns first registered type", "[GagPresetCache]")
+{
+    GagTypeIndex loc_index;
+    loc_index.Add(FakeKeyword(1),0);
+    loc_index.Add(FakeKeyword(2),1);
+    loc_index.Add(FakeKeyword(3),2);
+    loc_index.Add(FakeKeyword(2),3);    //already registered
+    REQUIRE(loc_index.Size() == 3);
+
+    const RE::BGSKeyword* loc_gag1[] = {FakeKeyword(10),FakeKeyword(3),FakeKeyword(2)};
+    REQUIRE(loc_index.Find(loc_gag1,3) == 1);
+
+    const RE::BGSKeyword* loc_gag2[] = {FakeKeyword(10),FakeKeyword(11)};
+    REQUIRE(loc_index.Find(loc_gag2,2) == GagTypeIndex::npos);
+    REQUIRE(loc_index.Find(nullptr,0) == GagTypeIndex::npos);
+}
+
+TEST_CASE("Gag preset cache is keyed by gag and generation", "[GagPresetCache]")
+{
+    GagPresetCache loc_cache;
+    REQUIRE(loc_cache.Find(1,0x100) == nullptr);
+
+    loc_cache.Store(1,0x100,MakePreset(0.5f));
+    loc_cache.Store(2,0x200,MakePreset(0.25f));
+    REQUIRE(loc_cache.Find(1,0x100) != nullptr);
+    REQUIRE(*loc_cache.Find(1,0x100) == MakePreset(0.5f));
+
+    //different gag worn. Outdated entry is erased
+    REQUIRE(loc_cache.Find(1,0x200) == nullptr);
+    REQUIRE(loc_cache.Size() == 1);
+    REQUIRE(loc_cache.Find(1,0x100) == nullptr);
+
+    loc_cache.Store(1,0x100,MakePreset(0.5f));
+    loc_cache.Invalidate(1);
+    REQUIRE(loc_cache.Find(1,0x100) == nullptr);
+    REQUIRE(loc_cache.Find(2,0x200) != nullptr);
+
+    loc_cache.InvalidateAll();
+    REQUIRE(loc_cache.Size() == 1);
+    REQUIRE(loc_cache.Find(2,0x200) == nullptr);
+    REQUIRE(loc_cache.Size() == 0);
+
+    loc_cache.Store(2,0x200,MakePreset(0.75f));
+    REQUIRE(*loc_cache.Find(2,0x200) == MakePreset(0.75f));
+
+    loc_cache.Clear();
+    REQUIRE(loc_cache.Size() == 0);
+}
+
+TEST_CASE("Gag preset benchmark", "[.benchmark][GagPresetCache]")
+{
+    constexpr int loc_actors     = 30;
+    constexpr int loc_types      = 8;
+    constexpr int loc_iterations = 200000;
+    std::mt19937 loc_rnd(5U);
+
+    //each gag has a few generic keywords and one gag type keyword. Each actor has a list of factions with ranks
+    std::vector<std::vector<const RE::BGSKeyword*>> loc_gags(loc_actors);
+    std::vector<std::vector<std::pair<uint32_t,int>>> loc_ranks(loc_actors);
+    for (int i = 0; i < loc_actors; i++)
+    {
+        for (int k = 0; k < 12; k++) loc_gags[i].push_back(FakeKeyword(100 + loc_rnd() % 50));
+        loc_gags[i].push_back(FakeKeyword(1 + loc_rnd() % loc_types));
+        for (int f = 0; f < 40; f++) loc_ranks[i].push_back({static_cast<uint32_t>(loc_rnd() % 200),static_cast<int>(loc_rnd() % 100)});
+    }
+
+    volatile float loc_sink = 0.0f;
+    auto loc_resolve = [&](int a_actor, size_t a_type)
+    {
+        //16 faction rank reads, each is a search over actor factions
+        GagPreset loc_res;
+        for (uint32_t p = 0; p < GagPreset::Size; p++)
+        {
+            const uint32_t loc_faction = static_cast<uint32_t>(a_type*16 + p);
+            auto loc_it = std::find_if(loc_ranks[a_actor].begin(),loc_ranks[a_actor].end(),[loc_faction](const auto& a_rank){ return a_rank.first == loc_faction; });
+            loc_res[p] = (loc_it != loc_ranks[a_actor].end()) ? loc_it->second/100.0f : 0.0f;
+        }
+        return loc_res;
+    };
+
+    //old path - linear scan over gag types, and rank reads every update
+    {
+        const auto loc_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < loc_iterations; i++)
+        {
+            const int loc_actor = i % loc_actors;
+            const auto& loc_kws = loc_gags[loc_actor];
+            size_t loc_type = 0;
+            for (size_t t = 1; t <= loc_types; t++)
+            {
+                if (std::find(loc_kws.begin(),loc_kws.end(),FakeKeyword(t)) != loc_kws.end())
+                {
+                    loc_type = t;
+                    break;
+                }
+            }
+            loc_sink = loc_sink + loc_resolve(loc_actor,loc_type)[0];
+        }
+        const double loc_time = std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - loc_start).count();
+        std::printf("linear scan + ranks: %.1f ns per update\n",loc_time/loc_iterations);
+    }
+
+    //new path - cache hit in steady state, index used only on miss
+    {
+        GagTypeIndex loc_index;
+        for (size_t t = 1; t <= loc_types; t++) loc_index.Add(FakeKeyword(t),t);
+        GagPresetCache loc_cache;
+
+        size_t loc_misses = 0;
+        const auto loc_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < loc_iterations; i++)
+        {
+            const int loc_actor = i % loc_actors;
+            const uint32_t loc_gag = 0x1000 + loc_actor;
+            const GagPreset* loc_cached = loc_cache.Find(loc_actor,loc_gag);
+            if (loc_cached == nullptr)
+            {
+                const auto& loc_kws = loc_gags[loc_actor];
+                const size_t loc_type = loc_index.Find(loc_kws.data(),loc_kws.size());
+                loc_cache.Store(loc_actor,loc_gag,loc_resolve(loc_actor,loc_type));
+                loc_cached = loc_cache.Find(loc_actor,loc_gag);
+                loc_misses++;
+            }
+            loc_sink = loc_sink + (*loc_cached)[0];
+        }
+        const double loc_time = std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - loc_start).count();
+        std::printf("cached: %.1f ns per update (%zu misses)\n",loc_time/loc_iterations,loc_misses);
+    }
+}
@@ -0,0 +1,175 @@
+#include <catch.hpp>
+#include "Instrumentation.h"
+
+using DeviousDevices::Instrumentation;
+using DeviousDevices::LatencyHistogram;
+using DeviousDevices::ProfileScope;
+using DeviousDevices::TraceBuffer;
+
+TEST_CASE("Latency histogram buckets are within 12.5 percent", "[Instrumentation]")
+{
+    for (uint64_t loc_value : {0ULL,1ULL,15ULL,16ULL,17ULL,100ULL,1000ULL,123456ULL,1000000007ULL,(1ULL << 62) + 12345ULL})
+    {
+        const size_t loc_bucket = LatencyHistogram::GetBucket(loc_value);
+        REQUIRE(loc_bucket < LatencyHistogram::Buckets);
+        REQUIRE(LatencyHistogram::GetBucketValue(loc_bucket) <= loc_value);
+        REQUIRE(loc_value - LatencyHistogram::GetBucketValue(loc_bucket) <= loc_value/8);
+    }
+    for (size_t i = 0; i + 1 < LatencyHistogram::Buckets; i++) REQUIRE(LatencyHistogram::GetBucketValue(i) < LatencyHistogram::GetBucketValue(i + 1));
+    REQUIRE(LatencyHistogram::GetBucket(std::numeric_limits<uint64_t>::max()) == LatencyHistogram::Buckets - 1);
+
+    LatencyHistogram loc_histogram;
+    for (uint64_t i = 1; i <= 1000; i++) loc_histogram.Add(i*1000);
+    REQUIRE(loc_histogram.GetCount() == 1000);
+    REQUIRE(loc_histogram.GetPercentile(50.0) == Approx(500000).epsilon(0.125));
+    REQUIRE(loc_histogram.GetPercentile(99.0) == Approx(990000).epsilon(0.125));
+    REQUIRE(LatencyHistogram().GetPercentile(50.0) == 0);
+}
+
+TEST_CASE("Instrumentation aggregates threads and reports difference", "[Instrumentation]")
+{
+    Instrumentation::Collect();
+
+    //disabled scopes are not recorded
+    Instrumentation::SetEnabled(false);
+    { ProfileScope loc_scope(DeviousDevices::pDeviceReader); }
+    REQUIRE(Instrumentation::Collect()[DeviousDevices::pDeviceReader].calls == 0);
+
+    Instrumentation::SetEnabled(true);
+    std::vector<std::thread> loc_threads;
+    for (int t = 0; t < 4; t++)
+    {
+        loc_threads.emplace_back([]
+        {
+            for (int i = 0; i < 1000; i++) Instrumentation::Record(DeviousDevices::pDeviceReader,1000 + i);
+            Instrumentation::Record(DeviousDevices::pEquipFilter,50000);
+        });
+    }
+    for (auto&& it : loc_threads) it.join();
+    Instrumentation::SetEnabled(false);
+
+    const auto loc_stats = Instrumentation::Collect();
+    REQUIRE(loc_stats[DeviousDevices::pDeviceReader].calls == 4000);
+    REQUIRE(loc_stats[DeviousDevices::pDeviceReader].p50 == Approx(1500).epsilon(0.125));
+    REQUIRE(loc_stats[DeviousDevices::pDeviceReader].max == 1999);
+    REQUIRE(loc_stats[DeviousDevices::pEquipFilter].calls == 4);
+    REQUIRE(loc_stats[DeviousDevices::pEquipFilter].p99 == Approx(50000).epsilon(0.125));
+    REQUIRE(std::string(loc_stats[DeviousDevices::pEquipFilter].name) == "EquipFilter");
+
+    //data of ended threads is kept, but only reported once
+    REQUIRE(Instrumentation::Collect()[DeviousDevices::pDeviceReader].calls == 0);
+}
+
+TEST_CASE("Nested scopes of the same zone are recorded once", "[Instrumentation]")
+{
+    Instrumentation::SetEnabled(true);
+    Instrumentation::Collect();
+    {
+        ProfileScope loc_outer(DeviousDevices::pDeviceReader);
+        { ProfileScope loc_inner(DeviousDevices::pDeviceReader); }
+        { ProfileScope loc_other(DeviousDevices::pEquipFilter); }
+    }
+    { ProfileScope loc_next(DeviousDevices::pDeviceReader); }
+    Instrumentation::SetEnabled(false);
+
+    const auto loc_stats = Instrumentation::Collect();
+    REQUIRE(loc_stats[DeviousDevices::pDeviceReader].calls == 2);
+    REQUIRE(loc_stats[DeviousDevices::pEquipFilter].calls == 1);
+}
+
+TEST_CASE("Trace buffer keeps newest events", "[Instrumentation]")
+{
+    TraceBuffer loc_buffer(4,7);
+    REQUIRE(loc_buffer.Read().empty());
+    for (uint64_t i = 0; i < 10; i++) loc_buffer.Add("Span",i*100,i);
+
+    const auto loc_events = loc_buffer.Read();
+    REQUIRE(loc_events.size() == 4);
+    for (size_t i = 0; i < loc_events.size(); i++)
+    {
+        REQUIRE(loc_events[i].start == (6 + i)*100);
+        REQUIRE(loc_events[i].duration == 6 + i);
+    }
+    REQUIRE(loc_buffer.GetThread() == 7);
+}
+
+TEST_CASE("Trace buffer reader never returns torn events", "[Instrumentation]")
+{
+    //every event has duration equal to its start, so partially overwritten event is detected
+    TraceBuffer loc_buffer(64,0);
+    std::atomic<bool> loc_done = false;
+    std::thread loc_writer([&]
+    {
+        for (uint64_t i = 1; i <= 500000; i++) loc_buffer.Add("Span",i,i);
+        loc_done = true;
+    });
+    size_t loc_reads = 0;
+    while (!loc_done || loc_reads == 0)
+    {
+        const auto loc_events = loc_buffer.Read();
+        for (size_t i = 0; i < loc_events.size(); i++)
+        {
+            REQUIRE(loc_events[i].start == loc_events[i].duration);
+            if (i > 0) REQUIRE(loc_events[i].start == loc_events[i - 1].start + 1);
+        }
+        loc_reads++;
+    }
+    loc_writer.join();
+    REQUIRE(loc_buffer.Read().back().start == 500000);
+}
+
+TEST_CASE("Trace is exported as Chrome trace JSON", "[Instrumentation]")
+{
+    Instrumentation::SetTracing(true,128);
+    std::thread([]
+    {
+        DeviousDevices::TraceScope loc_outer("LoadDB");
+        { ProfileScope loc_scope(DeviousDevices::pEquipFilter); }
+    }).join();
+    Instrumentation::SetTracing(false,128);
+    { DeviousDevices::TraceScope loc_scope("NotRecorded"); }
+    Instrumentation::SetEnabled(false);
+    Instrumentation::Collect();
+
+    std::ostringstream loc_stream;
+    size_t loc_count = 0;
+    Instrumentation::ExportTrace(loc_stream,&loc_count);
+    const std::string loc_json = loc_stream.str();
+
+    REQUIRE(loc_count >= 2);
+    REQUIRE(loc_json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[",0) == 0);
+    REQUIRE(loc_json.find("\"name\":\"LoadDB\",\"ph\":\"X\"") != std::string::npos);
+    REQUIRE(loc_json.find("\"name\":\"EquipFilter\",\"ph\":\"X\"") != std::string::npos);
+    REQUIRE(loc_json.find("NotRecorded") == std::string::npos);
+    REQUIRE(loc_json.find("thread_name") != std::string::npos);
+    REQUIRE(loc_json.substr(loc_json.size() - 4) == "\n]}\n");
+}
+
+TEST_CASE("Instrumentation overhead benchmark", "[.benchmark][Instrumentation]")
+{
+    constexpr int loc_iterations = 5000000;
+    volatile uint64_t loc_sink = 0;
+    auto loc_run = [&]
+    {
+        const auto loc_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < loc_iterations; i++)
+        {
+            ProfileScope loc_scope(DeviousDevices::pDeviceReader);
+            loc_sink = loc_sink + i;
+        }
+        return std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - loc_start).count()/loc_iterations;
+    };
+
+    const auto loc_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < loc_iterations; i++) loc_sink = loc_sink + i;
+    const double loc_baseTime = std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - loc_start).count()/loc_iterations;
+
+    Instrumentation::SetEnabled(false);
+    const double loc_offTime = loc_run();
+    Instrumentation::SetEnabled(true);
+    const double loc_onTime = loc_run();
+    Instrumentation::SetEnabled(false);
+    Instrumentation::Collect();
+
+    std::printf("no scope %.2f ns, disabled scope %.2f ns, enabled scope %.2f ns\n",loc_baseTime,loc_offTime,loc_onTime);
+}
@@ -0,0 +1,134 @@
+#include <catch.hpp>
+#include "KeywordSlotTable.h"
+
+using DeviousDevices::KeywordSlotTable;
+
+namespace
+{
+    const std::vector<std::string> KeywordIDs =
+    {
+        "zad_DeviousPlug","zad_DeviousBelt","zad_DeviousBra","zad_DeviousCollar","zad_DeviousArmCuffs","zad_DeviousLegCuffs",
+        "zad_DeviousArmbinder","zad_DeviousArmbinderElbow","zad_DeviousHeavyBondage","zad_DeviousHobbleSkirt","zad_DeviousHobbleSkirtRelaxed",
+        "zad_DeviousAnkleShackles","zad_DeviousStraitJacket","zad_DeviousCuffsFront","zad_DeviousPetSuit","zad_DeviousYoke","zad_DeviousYokeBB",
+        "zad_DeviousCorset","zad_DeviousClamps","zad_DeviousGloves","zad_DeviousHood","zad_DeviousSuit","zad_DeviousElbowTie","zad_DeviousGag",
+        "zad_DeviousGagRing","zad_DeviousGagLarge","zad_DeviousGagPanel","zad_DeviousPlugVaginal","zad_DeviousPlugAnal","zad_DeviousHarness",
+        "zad_DeviousBlindfold","zad_DeviousBoots","zad_DeviousPiercingsNipple","zad_DeviousPiercingsVaginal","zad_DeviousBondageMittens",
+        "zad_DeviousPonyGear","zad_Lockable","zad_InventoryDevice"
+    };
+
+    //keywords are only compared by address, so fake addresses are enough
+    const RE::BGSKeyword* FakeKeyword(const std::string& a_editorID)
+    {
+        const size_t loc_index = std::find(KeywordIDs.begin(),KeywordIDs.end(),a_editorID) - KeywordIDs.begin();
+        return reinterpret_cast<const RE::BGSKeyword*>(0x10000 + loc_index*0x40);
+    }
+
+    //original if/else mapping of InventoryFilter::GetMaskForKeyword (without strait jacket check), returning slot
+    int OriginalSlot(const RE::BGSKeyword* kwd)
+    {
+        if (kwd == FakeKeyword("zad_DeviousArmCuffs"))              return 59;
+        else if (kwd == FakeKeyword("zad_DeviousGag"))              return 44;
+        else if (kwd == FakeKeyword("zad_DeviousHarness"))          return 58;
+        else if (kwd == FakeKeyword("zad_DeviousCorset"))           return 58;
+        else if (kwd == FakeKeyword("zad_DeviousCollar"))           return 45;
+        else if (kwd == FakeKeyword("zad_DeviousHeavyBondage"))     return 46;
+        else if (kwd == FakeKeyword("zad_DeviousPlugAnal"))         return 48;
+        else if (kwd == FakeKeyword("zad_DeviousBelt"))             return 49;
+        else if (kwd == FakeKeyword("zad_DeviousPiercingsVaginal")) return 50;
+        else if (kwd == FakeKeyword("zad_DeviousPiercingsNipple"))  return 51;
+        else if (kwd == FakeKeyword("zad_DeviousLegCuffs"))         return 53;
+        else if (kwd == FakeKeyword("zad_DeviousBlindfold"))        return 55;
+        else if (kwd == FakeKeyword("zad_DeviousBra"))              return 56;
+        else if (kwd == FakeKeyword("zad_DeviousPlugVaginal"))      return 57;
+        else if (kwd == FakeKeyword("zad_DeviousSuit"))             return 32;
+        else if (kwd == FakeKeyword("zad_DeviousGloves"))           return 33;
+        else if (kwd == FakeKeyword("zad_DeviousHood"))             return 30;
+        else if (kwd == FakeKeyword("zad_DeviousBoots"))            return 37;
+        else if (kwd == FakeKeyword("zad_DeviousBondageMittens"))   return 33;
+        else return -1;
+    }
+
+    KeywordSlotTable BuildDefault()
+    {
+        KeywordSlotTable loc_table;
+        for (auto&& it : KeywordSlotTable::DefaultEntries)
+        {
+            std::string loc_id;
+            uint32_t loc_slot = 0;
+            REQUIRE(KeywordSlotTable::ParseEntry(it,loc_id,loc_slot));
+            REQUIRE(loc_table.Add(FakeKeyword(loc_id),loc_slot));
+        }
+        return loc_table;
+    }
+}
+
+TEST_CASE("Default keyword slot table is equivalent to original mapping", "[KeywordSlotTable]")
+{
+    const KeywordSlotTable loc_table = BuildDefault();
+    REQUIRE(loc_table.Size() == KeywordSlotTable::DefaultEntries.size());
+    for (auto&& it : KeywordIDs) REQUIRE(loc_table.Find(FakeKeyword(it)) == OriginalSlot(FakeKeyword(it)));
+    REQUIRE(loc_table.Find(nullptr) == -1);
+    REQUIRE(KeywordSlotTable().Find(FakeKeyword("zad_DeviousGag")) == -1);
+}
+
+TEST_CASE("Keyword slot entries are parsed", "[KeywordSlotTable]")
+{
+    std::string loc_id;
+    uint32_t loc_slot = 0;
+    REQUIRE(KeywordSlotTable::ParseEntry(" zad_DeviousGag : 44 ",loc_id,loc_slot));
+    REQUIRE(loc_id == "zad_DeviousGag");
+    REQUIRE(loc_slot == 44);
+
+    REQUIRE_FALSE(KeywordSlotTable::ParseEntry("zad_DeviousGag",loc_id,loc_slot));
+    REQUIRE_FALSE(KeywordSlotTable::ParseEntry("zad_DeviousGag:",loc_id,loc_slot));
+    REQUIRE_FALSE(KeywordSlotTable::ParseEntry(":44",loc_id,loc_slot));
+    REQUIRE_FALSE(KeywordSlotTable::ParseEntry("zad_DeviousGag:4x",loc_id,loc_slot));
+    REQUIRE_FALSE(KeywordSlotTable::ParseEntry("zad_DeviousGag:29",loc_id,loc_slot));
+    REQUIRE_FALSE(KeywordSlotTable::ParseEntry("zad_DeviousGag:61",loc_id,loc_slot));
+
+    KeywordSlotTable loc_table;
+    REQUIRE(loc_table.Add(FakeKeyword("zad_DeviousGag"),44));
+    REQUIRE_FALSE(loc_table.Add(FakeKeyword("zad_DeviousGag"),45));
+    REQUIRE_FALSE(loc_table.Add(nullptr,45));
+    REQUIRE(loc_table.Find(FakeKeyword("zad_DeviousGag")) == 44);
+}
+
+TEST_CASE("Keyword slot table benchmark", "[.benchmark][KeywordSlotTable]")
+{
+    const KeywordSlotTable loc_table = BuildDefault();
+    std::vector<const RE::BGSKeyword*> loc_queries;
+    std::mt19937 loc_rnd(39U);
+    for (int i = 0; i < 4096; i++) loc_queries.push_back(FakeKeyword(KeywordIDs[loc_rnd() % KeywordIDs.size()]));
+
+    //original chain compares against keyword members, so they are precomputed here too
+    std::array<const RE::BGSKeyword*,19> loc_members;
+    for (size_t i = 0; i < loc_members.size(); i++)
+    {
+        std::string loc_id;
+        uint32_t loc_slot;
+        KeywordSlotTable::ParseEntry(KeywordSlotTable::DefaultEntries[i],loc_id,loc_slot);
+        loc_members[i] = FakeKeyword(loc_id);
+    }
+    constexpr std::array<int,19> loc_slots = {59,44,58,58,45,46,48,49,50,51,53,55,56,57,32,33,30,37,33};
+
+    constexpr int loc_iterations = 2000000;
+    volatile int loc_sink = 0;
+    auto loc_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < loc_iterations; i++)
+    {
+        const RE::BGSKeyword* loc_kwd = loc_queries[i & 4095];
+        int loc_res = -1;
+        for (size_t k = 0; k < loc_members.size(); k++)
+        {
+            if (loc_kwd == loc_members[k]) { loc_res = loc_slots[k]; break; }
+        }
+        loc_sink = loc_sink + loc_res;
+    }
+    const double loc_oldTime = std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - loc_start).count()/loc_iterations;
+
+    loc_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < loc_iterations; i++) loc_sink = loc_sink + loc_table.Find(loc_queries[i & 4095]);
+    const double loc_newTime = std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - loc_start).count()/loc_iterations;
+
+    std::printf("if/else chain %.2f ns, table %.2f ns per lookup\n",loc_oldTime,loc_newTime);
+}
@@ -0,0 +1,114 @@
+#include <catch.hpp>
+#include <spdlog/async.h>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/sinks/null_sink.h>
+
+namespace
+{
+    // time per papyrus call, where every call logs one line like the native wrappers do
+    template<typename F>
+    double MeasureCalls(int a_calls, F a_log)
+    {
+        const auto loc_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < a_calls; i++) a_log(i);
+        return std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - loc_start).count()/a_calls;
+    }
+
+    std::vector<std::string> ReadLines(const std::filesystem::path& a_path)
+    {
+        std::ifstream loc_file(a_path);
+        std::vector<std::string> loc_res;
+        for (std::string loc_line; std::getline(loc_file,loc_line);) loc_res.push_back(loc_line);
+        return loc_res;
+    }
+
+    // Loggers keep their sink until next Setup, so the file is released before it is deleted
+    void ReleaseLogFile(const std::filesystem::path& a_path)
+    {
+        DeviousDevices::Logging::Setup(std::make_shared<spdlog::sinks::null_sink_mt>());
+        DeviousDevices::Logging::Shutdown();
+        std::filesystem::remove(a_path);
+    }
+}
+
+TEST_CASE("Logging is async by default and writes queue at shutdown", "[Logging]")
+{
+    using DeviousDevices::Logging;
+    const auto loc_path = std::filesystem::temp_directory_path() / "DeviousDevicesLogTest.log";
+    auto loc_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(loc_path.string(),true);
+    loc_sink->set_pattern("%v");
+    Logging::Setup(loc_sink);
+    REQUIRE(Logging::IsAsync());
+
+    for (int i = 0; i < 1000; i++) spdlog::info("message {}",i);
+    spdlog::error("error");
+
+    //shutdown writes everything queued before it, and messages logged after it are written directly
+    Logging::Shutdown();
+    REQUIRE_FALSE(Logging::IsAsync());
+    spdlog::info("after shutdown");
+
+    const auto loc_lines = ReadLines(loc_path);
+    REQUIRE(loc_lines.size() == 1002);
+    REQUIRE(loc_lines.front() == "message 0");
+    REQUIRE(loc_lines[1000] == "error");
+    REQUIRE(loc_lines.back() == "after shutdown");
+
+    ReleaseLogFile(loc_path);
+    REQUIRE_FALSE(std::filesystem::exists(loc_path));
+}
+
+TEST_CASE("Synchronous logging writes messages right away", "[Logging]")
+{
+    using DeviousDevices::Logging;
+    const auto loc_path = std::filesystem::temp_directory_path() / "DeviousDevicesSyncLogTest.log";
+    auto loc_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(loc_path.string(),true);
+    loc_sink->set_pattern("%v");
+    Logging::Setup(loc_sink);
+    Logging::SetAsync(false);
+    REQUIRE_FALSE(Logging::IsAsync());
+
+    //file is read without flushing or waiting for background thread
+    for (int i = 0; i < 100; i++) spdlog::debug("message {}",i);
+    const auto loc_lines = ReadLines(loc_path);
+    REQUIRE(loc_lines.size() == 100);
+    REQUIRE(loc_lines.back() == "message 99");
+
+    ReleaseLogFile(loc_path);
+    REQUIRE_FALSE(std::filesystem::exists(loc_path));
+}
+
+TEST_CASE("Logging overhead benchmark", "[.benchmark][Logging]")
+{
+    constexpr int loc_calls = 100000;
+    const auto loc_path = std::filesystem::temp_directory_path() / "DeviousDevicesLogBench.log";
+
+    //old setup - synchronous file sink, flushed after every message
+    {
+        auto loc_logger = std::make_shared<spdlog::logger>("sync",std::make_shared<spdlog::sinks::basic_file_sink_mt>(loc_path.string(),true));
+        loc_logger->set_level(spdlog::level::trace);
+        loc_logger->flush_on(spdlog::level::trace);
+        const double loc_time = MeasureCalls(loc_calls,[&](int i){ loc_logger->info("GetPropertyInt({:08X},{}) called",0x0A000800 + i,"iEscapeChance"); });
+        std::printf("sync + flush:        %8.1f ns per call\n",loc_time);
+    }
+
+    //new setup - async logger with background writer
+    {
+        auto loc_pool   = std::make_shared<spdlog::details::thread_pool>(8192,1);
+        auto loc_logger = std::make_shared<spdlog::async_logger>("async",std::make_shared<spdlog::sinks::basic_file_sink_mt>(loc_path.string(),true),
+                                                                 loc_pool,spdlog::async_overflow_policy::overrun_oldest);
+        loc_logger->set_level(spdlog::level::trace);
+        loc_logger->flush_on(spdlog::level::warn);
+        const double loc_time = MeasureCalls(loc_calls,[&](int i){ loc_logger->info("GetPropertyInt({:08X},{}) called",0x0A000800 + i,"iEscapeChance"); });
+        std::printf("async:               %8.1f ns per call (dropped %zu)\n",loc_time,loc_pool->overrun_counter());
+    }
+
+    //level disabled by runtime check in macro - arguments are not formatted
+    {
+        volatile int loc_level = 1;
+        auto loc_logger = std::make_shared<spdlog::logger>("off",std::make_shared<spdlog::sinks::basic_file_sink_mt>(loc_path.string(),true));
+        const double loc_time = MeasureCalls(loc_calls,[&](int i){ if (loc_level >= 2) loc_logger->info("GetPropertyInt({:08X},{}) called",0x0A000800 + i,"iEscapeChance"); });
+        std::printf("disabled by level:   %8.1f ns per call\n",loc_time);
+    }
+    std::filesystem::remove(loc_path);
+}
@@ -0,0 +1,122 @@
+#include <catch.hpp>
+#include "NameIndex.h"
+
+using DeviousDevices::NameIndex;
+
+namespace
+{
+    NameIndex<int> MakeIndex()
+    {
+        NameIndex<int> loc_index;
+        loc_index.Add("Black Ebonite Armbinder",1);
+        loc_index.Add("zadx_ArmbinderEboniteBlackInventory",1);
+        loc_index.Add("Red Ebonite Armbinder",2);
+        loc_index.Add("zadx_ArmbinderEboniteRedInventory",2);
+        loc_index.Add("Iron Prisoner Chains",3);
+        loc_index.Add("",4);   //ignored
+        loc_index.Add("black ebonite armbinder",5);
+        loc_index.Build();
+        return loc_index;
+    }
+}
+
+TEST_CASE("Name index finds exact names", "[NameIndex]")
+{
+    const NameIndex<int> loc_index = MakeIndex();
+    REQUIRE(loc_index.GetNameCount() == 6);
+
+    REQUIRE(loc_index.FindExact("Red Ebonite Armbinder") == 2);
+    REQUIRE(loc_index.FindExact("zadx_ArmbinderEboniteRedInventory") == 2);
+    REQUIRE(loc_index.FindExact("black ebonite armbinder") == 5);
+    REQUIRE(loc_index.FindExact("red ebonite armbinder") == std::nullopt);
+    REQUIRE(loc_index.FindExact("") == std::nullopt);
+
+    //first added name wins
+    REQUIRE(loc_index.FindNoCase("BLACK EBONITE ARMBINDER") == 1);
+    REQUIRE(loc_index.FindNoCase("iron prisoner chains") == 3);
+    REQUIRE(loc_index.FindNoCase("Iron Prisoner") == std::nullopt);
+}
+
+TEST_CASE("Name index searches prefixes and substrings", "[NameIndex]")
+{
+    const NameIndex<int> loc_index = MakeIndex();
+
+    REQUIRE(loc_index.FindPrefix("black") == std::vector<int>{1,5});
+    REQUIRE(loc_index.FindPrefix("ZADX_") == std::vector<int>{1,2});
+    REQUIRE(loc_index.FindPrefix("ebonite").empty());
+    REQUIRE(loc_index.FindPrefix("Iron Prisoner Chains") == std::vector<int>{3});
+    REQUIRE(loc_index.FindPrefix("Iron Prisoner Chains!").empty());
+
+    //every value is returned only once, in order of names
+    REQUIRE(loc_index.FindSubstring("ebonite") == std::vector<int>{1,2,5});
+    REQUIRE(loc_index.FindSubstring("N") == std::vector<int>{1,2,3,5});
+    REQUIRE(loc_index.FindSubstring("redinv") == std::vector<int>{2});
+    REQUIRE(loc_index.FindSubstring("leather").empty());
+    REQUIRE(loc_index.FindSubstring("ebonite",2) == std::vector<int>{1,2});
+    REQUIRE(loc_index.FindSubstring("") == std::vector<int>{1,2,3,5});
+    REQUIRE(loc_index.FindPrefix("",1) == std::vector<int>{1});
+
+    NameIndex<int> loc_empty;
+    loc_empty.Add("Not built",1);
+    REQUIRE(loc_empty.FindSubstring("built").empty());
+    REQUIRE(loc_empty.FindExact("Not built") == 1);
+}
+
+TEST_CASE("Name index benchmark", "[.benchmark][NameIndex]")
+{
+    const std::array<const char*,6> loc_materials = {"Black Ebonite","Red Ebonite","White Leather","Iron","Rope","Steel"};
+    const std::array<const char*,8> loc_types = {"Armbinder","Gag","Collar","Chastity Belt","Blindfold","Boots","Mittens","Harness"};
+
+    constexpr size_t loc_devices = 2500;
+    std::vector<std::pair<std::string,std::string>> loc_names;  //display name, editor ID
+    for (size_t i = 0; i < loc_devices; i++)
+    {
+        const std::string loc_material  = loc_materials[i % loc_materials.size()];
+        const std::string loc_type      = loc_types[(i/loc_materials.size()) % loc_types.size()];
+        std::string loc_editorID        = "zadx_" + loc_type + loc_material + "Inventory" + std::to_string(i);
+        loc_editorID.erase(std::remove(loc_editorID.begin(),loc_editorID.end(),' '),loc_editorID.end());
+        loc_names.push_back({loc_material + " " + loc_type + " " + std::to_string(i),loc_editorID});
+    }
+
+    const auto loc_buildStart = std::chrono::steady_clock::now();
+    NameIndex<size_t> loc_index;
+    for (size_t i = 0; i < loc_devices; i++)
+    {
+        loc_index.Add(loc_names[i].first,i);
+        loc_index.Add(loc_names[i].second,i);
+    }
+    loc_index.Build();
+    const double loc_build = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - loc_buildStart).count();
+
+    auto loc_measure = [](size_t a_repeats, auto a_function)
+    {
+        size_t loc_sum = 0;
+        const auto loc_start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < a_repeats; r++) loc_sum += a_function(r);
+        const double loc_time = std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now() - loc_start).count()/a_repeats;
+        REQUIRE(loc_sum > 0);
+        return loc_time;
+    };
+
+    //linear scans are the same as what GetDeviceUnit(std::string) did before
+    const double loc_exactScan = loc_measure(1000,[&](size_t r)
+    {
+        const std::string& loc_name = loc_names[(r*7919) % loc_devices].first;
+        for (size_t i = 0; i < loc_devices; i++) if (loc_names[i].first == loc_name) return i + 1;
+        return size_t(0);
+    });
+    const double loc_exactIndex = loc_measure(1000,[&](size_t r){ return loc_index.FindExact(loc_names[(r*7919) % loc_devices].first).value() + 1; });
+
+    auto loc_lower = [](std::string a_string){ for (auto&& it : a_string) it = static_cast<char>(::tolower(static_cast<unsigned char>(it))); return a_string; };
+    const double loc_substringScan = loc_measure(100,[&](size_t r)
+    {
+        const std::string loc_text = loc_lower(std::to_string(100 + r));
+        size_t loc_res = 0;
+        for (auto&& it : loc_names) if (loc_lower(it.first).find(loc_text) != std::string::npos || loc_lower(it.second).find(loc_text) != std::string::npos) loc_res++;
+        return loc_res;
+    });
+    const double loc_substringIndex = loc_measure(100,[&](size_t r){ return loc_index.FindSubstring(std::to_string(100 + r)).size(); });
+
+    std::printf("%zu devices: build = %.2f ms, exact scan = %.2f us, exact index = %.2f us, substring scan = %.1f us, substring index = %.1f us\n",
+        loc_devices,loc_build,loc_exactScan,loc_exactIndex,loc_substringScan,loc_substringIndex);
+}
@@ -0,0 +1,112 @@
+#include <catch.hpp>
+#include "PropertyCache.h"
+#include "EspBuilder.h"
+
+using DeviousDevices::DeviceMod;
+using DeviousDevices::PropertyCache;
+using namespace DeviousDevices::Fixtures;
+
+TEST_CASE("Property cache resolves every key once", "[PropertyCache]")
+{
+    PropertyCache<int> loc_cache;
+    int loc_owner1 = 0, loc_owner2 = 0;
+    int loc_resolves = 0;
+    auto loc_resolve = [&](int a_value){ return [&loc_resolves,a_value]{ loc_resolves++; return a_value; }; };
+
+    REQUIRE(loc_cache.Get(&loc_owner1,"deviceKey",loc_resolve(1)) == 1);
+    REQUIRE(loc_cache.Get(&loc_owner1,"DEVICEKEY",loc_resolve(2)) == 1);   //names are case insensitive
+    REQUIRE(loc_cache.Get(&loc_owner2,"deviceKey",loc_resolve(3)) == 3);   //other version of device
+    REQUIRE(loc_cache.Get(&loc_owner1,"deviceKeys",loc_resolve(4)) == 4);
+    REQUIRE(loc_resolves == 3);
+    REQUIRE(loc_cache.Size() == 3);
+
+    const auto loc_stats = loc_cache.GetStats(true);
+    REQUIRE(loc_stats.hits == 1);
+    REQUIRE(loc_stats.misses == 3);
+    REQUIRE(loc_cache.GetStats(false).misses == 0);
+
+    loc_cache.Clear();
+    REQUIRE(loc_cache.Size() == 0);
+    REQUIRE(loc_cache.Get(&loc_owner1,"deviceKey",loc_resolve(5)) == 5);
+}
+
+TEST_CASE("Property cache is consistent when used from multiple threads", "[PropertyCache]")
+{
+    PropertyCache<std::vector<int>> loc_cache;
+    std::vector<int> loc_owners(8);
+    std::atomic<bool> loc_failed = false;
+
+    std::vector<std::thread> loc_threads;
+    for (int t = 0; t < 4; t++)
+    {
+        loc_threads.emplace_back([&]
+        {
+            for (int i = 0; i < 2000; i++)
+            {
+                const size_t loc_owner = i % loc_owners.size();
+                const int loc_property = i % 16;
+                const std::vector<int> loc_res = loc_cache.Get(&loc_owners[loc_owner],"Property" + std::to_string(loc_property),[&]
+                {
+                    return std::vector<int>{static_cast<int>(loc_owner),loc_property};
+                });
+                if (loc_res != std::vector<int>{static_cast<int>(loc_owner),loc_property}) loc_failed = true;
+            }
+        });
+    }
+    for (auto&& it : loc_threads) it.join();
+
+    REQUIRE_FALSE(loc_failed);
+    REQUIRE(loc_cache.Size() == 16);    //i % 8 and i % 16 only give 16 combinations
+}
+
+TEST_CASE("Resolved form cache benchmark", "[.benchmark][PropertyCache]")
+{
+    //device with form properties pointing to masters, resolved the same way as DeviceReader does it - property search,
+    //master lookup and form lookup by (id, file name), which is what TESDataHandler::LookupForm does
+    const std::vector<std::string> loc_names = {"zad_DeviousDevice","deviceKey","zad_DeviceMsg","zad_EquipRequiredFailMsg","zad_EquipConflictFailMsg","deviceRendered"};
+    EspBuilder loc_esp;
+    loc_esp.AddMaster("Skyrim.esm").AddMaster("Devious Devices - Assets.esm").AddMaster("Devious Devices - Integration.esm");
+    VmadBuilder loc_vmad;
+    loc_vmad.AddScript("zadEquipScript");
+    for (size_t i = 0; i < 40; i++) loc_vmad.AddInt("zad_Property" + std::to_string(i),static_cast<int32_t>(i));
+    for (size_t i = 0; i < loc_names.size(); i++) loc_vmad.AddObject(loc_names[i],static_cast<uint32_t>(0x01000800U + i));
+    loc_esp.AddRecord(RecordBuilder("ARMO",loc_esp.GetFormID(0x801)).SetScripts(loc_vmad));
+
+    const std::vector<uint8_t> loc_data = loc_esp.Build();
+    uint8_t* loc_raw = new uint8_t[loc_data.size()];
+    std::copy(loc_data.begin(),loc_data.end(),loc_raw);
+    const DeviceMod loc_mod("Test.esp",loc_raw,loc_data.size());
+    const auto& loc_device = *loc_mod.devicerecords[0];
+
+    std::map<std::pair<std::string,uint32_t>,int> loc_forms;
+    for (uint32_t i = 0; i < 0x1000; i++)
+    {
+        loc_forms[{"Devious Devices - Assets.esm",0x800 + i}] = static_cast<int>(i);
+        loc_forms[{"Skyrim.esm",0x800 + i}] = -static_cast<int>(i);
+    }
+    auto loc_resolve = [&](const std::string& a_name) -> const int*
+    {
+        const uint32_t loc_formID = loc_device.GetPropertyOBJ(a_name,0U,true);
+        const auto loc_it = loc_forms.find({loc_mod.GetSource(loc_formID),loc_formID & 0x00FFFFFF});
+        return loc_it != loc_forms.end() ? &loc_it->second : nullptr;
+    };
+
+    PropertyCache<const int*> loc_cache;
+    constexpr size_t loc_repeats = 20000;
+    auto loc_measure = [&](auto a_function)
+    {
+        int64_t loc_sum = 0;
+        const auto loc_start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < loc_repeats; r++)
+        {
+            for (auto&& it : loc_names) loc_sum += *a_function(it);
+        }
+        const double loc_time = std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - loc_start).count();
+        REQUIRE(loc_sum == static_cast<int64_t>(loc_repeats*(loc_names.size()*(loc_names.size() - 1)/2)));
+        return loc_time/(loc_repeats*loc_names.size());
+    };
+
+    const double loc_uncached   = loc_measure(loc_resolve);
+    const double loc_cached     = loc_measure([&](const std::string& a_name){ return loc_cache.Get(&loc_device,a_name,[&]{ return loc_resolve(a_name); }); });
+    std::printf("Form property lookup: uncached = %.0f ns, cached = %.0f ns\n",loc_uncached,loc_cached);
+}
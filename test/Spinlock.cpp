@@ -0,0 +1,133 @@
+#include <catch.hpp>
+#include "Spinlock.h"
+
+using DeviousDevices::Spinlock;
+using DeviousDevices::UniqueLock;
+
+namespace
+{
+    //original lock, kept for comparison in benchmark
+    class ExchangeLock
+    {
+    public:
+        void Lock()   { while (_lock.exchange(true)) {} }
+        void Unlock() { _lock.store(false); }
+    private:
+        std::atomic<bool> _lock = false;
+    };
+
+    //runs a_threads threads, each doing a_iterations short critical sections. Returns ns per lock/unlock pair
+    template<typename L>
+    double RunContended(L& a_lock, int a_threads, int a_iterations, uint64_t& a_counter)
+    {
+        std::atomic<int> loc_ready = 0;
+        std::vector<std::thread> loc_threads;
+        const auto loc_start = std::chrono::steady_clock::now();
+        for (int t = 0; t < a_threads; t++)
+        {
+            loc_threads.emplace_back([&]
+            {
+                loc_ready++;
+                while (loc_ready.load() < a_threads) {}
+                for (int i = 0; i < a_iterations; i++)
+                {
+                    a_lock.Lock();
+                    //few dependent operations to simulate small map lookup
+                    for (int k = 0; k < 8; k++) a_counter = a_counter*3 + 1;
+                    a_lock.Unlock();
+                }
+            });
+        }
+        for (auto&& it : loc_threads) it.join();
+        const double loc_time = std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - loc_start).count();
+        return loc_time/(static_cast<double>(a_threads)*a_iterations);
+    }
+}
+
+TEST_CASE("Spinlock provides mutual exclusion", "[Spinlock]")
+{
+    Spinlock loc_lock;
+    uint64_t loc_counter = 0;
+    std::vector<std::thread> loc_threads;
+    for (int t = 0; t < 8; t++)
+    {
+        loc_threads.emplace_back([&]
+        {
+            for (int i = 0; i < 20000; i++)
+            {
+                UniqueLock lock(loc_lock);
+                loc_counter++;
+            }
+        });
+    }
+    for (auto&& it : loc_threads) it.join();
+    REQUIRE(loc_counter == 8*20000);
+}
+
+TEST_CASE("Spinlock wakes up sleeping thread", "[Spinlock]")
+{
+    Spinlock loc_lock;
+    Spinlock::EnableStats(true);
+    loc_lock.Lock();
+    REQUIRE_FALSE(loc_lock.TryLock());
+
+    std::atomic<bool> loc_acquired = false;
+    std::thread loc_thread([&]
+    {
+        loc_lock.Lock();
+        loc_acquired = true;
+        loc_lock.Unlock();
+    });
+
+    //long enough for waiting thread to stop spinning and go to sleep
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE_FALSE(loc_acquired);
+    loc_lock.Unlock();
+    loc_thread.join();
+    REQUIRE(loc_acquired);
+
+    const Spinlock::Stats loc_stats = loc_lock.GetStats();
+    REQUIRE(loc_stats.contended == 1);
+    REQUIRE(loc_stats.sleeps >= 1);
+    REQUIRE(loc_stats.waitTime >= loc_stats.maxWait);
+    REQUIRE(loc_stats.maxWait >= 10000000ULL);
+
+    loc_lock.ResetStats();
+    REQUIRE(loc_lock.GetStats().contended == 0);
+    REQUIRE(loc_lock.TryLock());
+    loc_lock.Unlock();
+    Spinlock::EnableStats(false);
+}
+
+TEST_CASE("Spinlock does not record stats when disabled", "[Spinlock]")
+{
+    Spinlock loc_lock;
+    Spinlock::EnableStats(false);
+    uint64_t loc_counter = 0;
+    RunContended(loc_lock,4,10000,loc_counter);
+    REQUIRE(loc_lock.GetStats().contended == 0);
+}
+
+TEST_CASE("Spinlock contention benchmark", "[.benchmark][Spinlock]")
+{
+    constexpr int loc_iterations = 200000;
+    uint64_t loc_counter = 0;
+    for (int loc_threads : {1,2,4,8,16})
+    {
+        ExchangeLock loc_old;
+        const double loc_oldTime = RunContended(loc_old,loc_threads,loc_iterations,loc_counter);
+
+        Spinlock loc_new;
+        const double loc_newTime = RunContended(loc_new,loc_threads,loc_iterations,loc_counter);
+
+        Spinlock loc_stats;
+        Spinlock::EnableStats(true);
+        const double loc_statsTime = RunContended(loc_stats,loc_threads,loc_iterations,loc_counter);
+        Spinlock::EnableStats(false);
+        const Spinlock::Stats loc_res = loc_stats.GetStats();
+
+        std::printf("%2d threads: exchange loop %7.1f ns, TTAS backoff %7.1f ns, with stats %7.1f ns (contended %.1f %%, sleeps %llu, max wait %.1f us)\n",
+            loc_threads,loc_oldTime,loc_newTime,loc_statsTime,100.0*loc_res.contended/(static_cast<double>(loc_threads)*loc_iterations),
+            static_cast<unsigned long long>(loc_res.sleeps),loc_res.maxWait/1000.0);
+    }
+}
@@ -0,0 +1,166 @@
+#include <catch.hpp>
+#include "TimerWheel.h"
+
+using DeviousDevices::TimerWheel;
+using DeviousDevices::TimerTask;
+
+TEST_CASE("TimerWheel executes one-shot task once after its delay", "[TimerWheel]")
+{
+    TimerWheel loc_wheel;
+    int loc_calls = 0;
+    auto loc_task = loc_wheel.ScheduleOnce(100,[&]{ loc_calls++; });
+
+    loc_wheel.AdvanceTicks(99);
+    REQUIRE(loc_calls == 0);
+    loc_wheel.AdvanceTicks(1);
+    REQUIRE(loc_calls == 1);
+    REQUIRE(loc_task->GetState() == TimerTask::sFinished);
+    loc_wheel.AdvanceTicks(10000);
+    REQUIRE(loc_calls == 1);
+    REQUIRE(loc_wheel.GetTaskCount() == 0);
+}
+
+TEST_CASE("TimerWheel fires tasks exactly at expiry on all levels", "[TimerWheel]")
+{
+    TimerWheel loc_wheel;
+    loc_wheel.AdvanceTicks(12345);  //start with unaligned time
+
+    const std::vector<uint64_t> loc_delays = {1,63,64,65,4095,4096,4097,262143,262144,300000,TimerWheel::MaxDelay + 5000};
+    std::vector<uint64_t> loc_fired(loc_delays.size(),0);
+    for (size_t i = 0; i < loc_delays.size(); i++)
+    {
+        loc_wheel.ScheduleOnce(loc_delays[i],[&,i]{ loc_fired[i] = loc_wheel.GetTime(); });
+    }
+
+    const uint64_t loc_start = loc_wheel.GetTime();
+    loc_wheel.AdvanceTicks(TimerWheel::MaxDelay + 10000);
+    for (size_t i = 0; i < loc_delays.size(); i++)
+    {
+        INFO("delay " << loc_delays[i]);
+        REQUIRE(loc_fired[i] == loc_start + loc_delays[i]);
+    }
+}
+
+TEST_CASE("TimerWheel periodic task and cancel", "[TimerWheel]")
+{
+    TimerWheel loc_wheel;
+    int loc_calls = 0;
+    auto loc_task = loc_wheel.SchedulePeriodic(500,[&]{ loc_calls++; });
+
+    //first execution is after one period
+    loc_wheel.AdvanceTicks(499);
+    REQUIRE(loc_calls == 0);
+    loc_wheel.AdvanceTicks(1);
+    REQUIRE(loc_calls == 1);
+    for (int i = 0; i < 1000; i++) loc_wheel.AdvanceTicks(1);
+    REQUIRE(loc_calls == 3);
+
+    REQUIRE(loc_task->Cancel());
+    REQUIRE_FALSE(loc_task->Cancel());
+    loc_wheel.AdvanceTicks(1000);
+    REQUIRE(loc_calls == 3);
+    REQUIRE(loc_wheel.GetTaskCount() == 0);
+}
+
+TEST_CASE("TimerWheel task can cancel itself and schedule new tasks", "[TimerWheel]")
+{
+    TimerWheel loc_wheel;
+    int loc_calls = 0;
+    int loc_oneshot = 0;
+    DeviousDevices::TimerTaskHandle loc_task;
+    loc_task = loc_wheel.SchedulePeriodic(10,[&]
+    {
+        if (++loc_calls == 3) loc_task->Cancel();
+        loc_wheel.ScheduleOnce(5,[&]{ loc_oneshot++; });
+    });
+
+    for (int i = 0; i < 100; i++) loc_wheel.AdvanceTicks(1);
+    REQUIRE(loc_calls == 3);
+    REQUIRE(loc_oneshot == 3);
+    REQUIRE(loc_task->GetState() == TimerTask::sCancelled);
+}
+
+TEST_CASE("TimerWheel skips periods missed by long frame", "[TimerWheel]")
+{
+    TimerWheel loc_wheel;
+    std::vector<uint64_t> loc_fired;
+    loc_wheel.SchedulePeriodic(10,[&]{ loc_fired.push_back(loc_wheel.GetTime()); });
+
+    loc_wheel.AdvanceTicks(16);
+    REQUIRE(loc_fired == std::vector<uint64_t>{10});
+
+    //100 ms hitch fires the task once, not 10 times
+    loc_wheel.AdvanceTicks(100);
+    REQUIRE(loc_fired == std::vector<uint64_t>{10,20});
+
+    //next execution is still on the period grid, in the first period after the hitch
+    loc_wheel.AdvanceTicks(3);
+    REQUIRE(loc_fired.size() == 2);
+    loc_wheel.AdvanceTicks(1);
+    REQUIRE(loc_fired == std::vector<uint64_t>{10,20,120});
+}
+
+TEST_CASE("TimerWheel converts frame delta to ticks without drift", "[TimerWheel]")
+{
+    TimerWheel loc_wheel;
+    int loc_calls = 0;
+    loc_wheel.SchedulePeriodic(500,[&]{ loc_calls++; },500);
+
+    //one minute at 60 FPS
+    for (int i = 0; i < 3600; i++) loc_wheel.Advance(1.0f/60.0f);
+    REQUIRE(loc_wheel.GetTime() >= 59999);
+    REQUIRE(loc_wheel.GetTime() <= 60001);
+    REQUIRE(loc_calls == 120);
+}
+
+TEST_CASE("TimerWheel tasks scheduled from other threads", "[TimerWheel]")
+{
+    TimerWheel loc_wheel;
+    std::atomic<int> loc_calls = 0;
+    std::vector<std::thread> loc_threads;
+    for (int t = 0; t < 4; t++)
+    {
+        loc_threads.emplace_back([&]
+        {
+            for (int i = 0; i < 1000; i++) loc_wheel.ScheduleOnce(i % 100,[&]{ loc_calls++; });
+        });
+    }
+    for (auto&& it : loc_threads) it.join();
+
+    loc_wheel.AdvanceTicks(200);
+    REQUIRE(loc_calls == 4000);
+    REQUIRE(loc_wheel.GetTaskCount() == 0);
+}
+
+TEST_CASE("TimerWheel per-frame overhead compared to sleeper threads", "[.benchmark][TimerWheel]")
+{
+    constexpr int loc_frames = 60*60*10; //10 minutes at 60 FPS
+
+    //old behavior - every throttle spawned detached thread which slept and then reset flag
+    {
+        std::atomic<int> loc_running = 0;
+        const auto loc_start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < 1000; i++)
+        {
+            loc_running++;
+            std::thread([&]{ loc_running--; }).detach();
+        }
+        while (loc_running > 0) std::this_thread::yield();
+        const auto loc_time = std::chrono::duration<double,std::micro>(std::chrono::high_resolution_clock::now() - loc_start).count();
+        std::printf("thread creation: %.2f us per thread\n",loc_time/1000.0);
+    }
+
+    //new behavior - 3 periodic tasks in wheel, advanced every frame
+    {
+        TimerWheel loc_wheel;
+        int loc_calls = 0;
+        loc_wheel.SchedulePeriodic(500,[&]{ loc_calls++; });
+        loc_wheel.SchedulePeriodic(500,[&]{ loc_calls++; });
+        loc_wheel.SchedulePeriodic(10000,[&]{ loc_calls++; });
+
+        const auto loc_start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < loc_frames; i++) loc_wheel.Advance(1.0f/60.0f);
+        const auto loc_time = std::chrono::duration<double,std::micro>(std::chrono::high_resolution_clock::now() - loc_start).count();
+        std::printf("timer wheel: %.3f us per frame, %d callbacks, 0 threads created\n",loc_time/loc_frames,loc_calls);
+    }
+}
@@ -0,0 +1,241 @@
+#include <catch.hpp>
+#include "UpdateQueue.h"
+
+using DeviousDevices::UpdateQueue;
+
+namespace
+{
+    void BusyWait(double a_microseconds)
+    {
+        const auto loc_start = std::chrono::steady_clock::now();
+        while (std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now() - loc_start).count() < a_microseconds) {}
+    }
+}
+
+TEST_CASE("UpdateQueue queues every update type once per interval", "[UpdateQueue]")
+{
+    UpdateQueue loc_queue;
+    loc_queue.SetInterval(DeviousDevices::tGagExpression,120);
+    loc_queue.SetInterval(DeviousDevices::tNodeHider,60);
+    loc_queue.SetBudget(1000000);
+
+    std::array<int,DeviousDevices::tUpdateTypeCount> loc_calls = {};
+    for (uint64_t loc_frame = 0; loc_frame < 1200; loc_frame++)
+    {
+        loc_queue.Touch(0x100042,loc_frame);
+        loc_queue.Drain([&](const UpdateQueue::Job& a_job)
+        {
+            REQUIRE(a_job.handle == 0x100042);
+            loc_calls[a_job.type]++;
+        });
+    }
+    REQUIRE(loc_calls[DeviousDevices::tGagExpression] == 10);
+    REQUIRE(loc_calls[DeviousDevices::tNodeHider] == 20);
+}
+
+TEST_CASE("UpdateQueue does not queue disabled update types", "[UpdateQueue]")
+{
+    UpdateQueue loc_queue;
+    loc_queue.SetInterval(DeviousDevices::tNodeHider,10);
+    for (uint64_t loc_frame = 0; loc_frame < 100; loc_frame++)
+    {
+        loc_queue.Touch(1,loc_frame);
+        loc_queue.Drain([&](const UpdateQueue::Job& a_job){ REQUIRE(a_job.type == DeviousDevices::tNodeHider); });
+    }
+}
+
+TEST_CASE("UpdateQueue staggers actors loaded at once", "[UpdateQueue]")
+{
+    constexpr uint32_t loc_interval = 60;
+    constexpr uint32_t loc_actors   = 600;
+
+    UpdateQueue loc_queue;
+    loc_queue.SetInterval(DeviousDevices::tNodeHider,loc_interval);
+    loc_queue.SetBudget(1000000);
+
+    //all actors are loaded in same frame, for example after cell change. Handles are usually consecutive
+    std::vector<int> loc_perframe;
+    for (uint64_t loc_frame = 0; loc_frame < 10*loc_interval; loc_frame++)
+    {
+        for (uint32_t i = 0; i < loc_actors; i++) loc_queue.Touch(0x100000 + i,loc_frame);
+        loc_perframe.push_back(static_cast<int>(loc_queue.Drain([](const UpdateQueue::Job&){})));
+    }
+
+    //without staggering all 600 actors would be updated in single frame. Ideal is 10 per frame
+    REQUIRE(*std::max_element(loc_perframe.begin(),loc_perframe.end()) <= 25);
+    REQUIRE(std::accumulate(loc_perframe.begin(),loc_perframe.end(),0) == 10*loc_actors);
+}
+
+TEST_CASE("UpdateQueue respects frame budget and does not stall", "[UpdateQueue]")
+{
+    UpdateQueue loc_queue;
+    loc_queue.SetInterval(DeviousDevices::tGagExpression,1000);
+    loc_queue.SetBudget(0);
+
+    //with budget 0 only one job is done every frame
+    for (uint64_t loc_frame = 0; loc_frame < 1000; loc_frame++)
+    {
+        for (uint32_t i = 0; i < 10; i++) loc_queue.Touch(i,loc_frame);
+        REQUIRE(loc_queue.Drain([](const UpdateQueue::Job&){}) <= 1);
+    }
+    for (int i = 0; i < 10; i++) loc_queue.Drain([](const UpdateQueue::Job&){});
+    REQUIRE(loc_queue.GetBacklog() == 0);
+}
+
+TEST_CASE("UpdateQueue forgets actors which are no longer updated", "[UpdateQueue]")
+{
+    UpdateQueue loc_queue;
+    loc_queue.SetInterval(DeviousDevices::tGagExpression,10);
+    loc_queue.Touch(1,0);
+    loc_queue.Touch(2,0);
+
+    std::vector<uint32_t> loc_forgotten;
+    for (uint64_t loc_frame = 1; loc_frame < 200; loc_frame++)
+    {
+        loc_queue.Touch(1,loc_frame);
+        loc_queue.Sweep(loc_frame,[&](uint32_t a_handle){ loc_forgotten.push_back(a_handle); });
+    }
+    REQUIRE(loc_forgotten == std::vector<uint32_t>{2});
+    REQUIRE(loc_queue.GetActorCount() == 1);
+
+    //jobs of forgotten actors are dropped
+    loc_queue.Drain([](const UpdateQueue::Job& a_job){ REQUIRE(a_job.handle == 1); });
+}
+
+TEST_CASE("UpdateQueue drain time with 50 NPCs", "[.benchmark][UpdateQueue]")
+{
+    constexpr uint32_t loc_npcs     = 50;
+    constexpr uint64_t loc_frames   = 60*60*2; //2 minutes at 60 FPS
+    constexpr double   loc_jobtime  = 20.0;    //rough cost of single gag or node update in us
+
+    auto loc_run = [&](uint32_t a_budget)
+    {
+        UpdateQueue loc_queue;
+        loc_queue.SetInterval(DeviousDevices::tGagExpression,120);
+        loc_queue.SetInterval(DeviousDevices::tNodeHider,60);
+        loc_queue.SetBudget(a_budget);
+
+        for (uint64_t loc_frame = 0; loc_frame < loc_frames; loc_frame++)
+        {
+            for (uint32_t i = 0; i < loc_npcs; i++) loc_queue.Touch(0x100000 + i,loc_frame);
+            loc_queue.Drain([&](const UpdateQueue::Job&){ BusyWait(loc_jobtime); });
+        }
+        const UpdateQueue::DrainStats loc_stats = loc_queue.GetDrainStats();
+        std::printf("queue with budget %u us: p50 = %.1f us, p99 = %.1f us, max = %.1f us\n",a_budget,loc_stats.p50,loc_stats.p99,loc_stats.max);
+    };
+
+    //old behavior - NPCs loaded at once counted their frames from same frame, so all their updates fell to same frame
+    {
+        std::vector<float> loc_times;
+        for (uint64_t loc_frame = 0; loc_frame < loc_frames; loc_frame++)
+        {
+            const auto loc_start = std::chrono::steady_clock::now();
+            if (loc_frame % 60 == 0) for (uint32_t i = 0; i < loc_npcs; i++) BusyWait(loc_jobtime);
+            if (loc_frame % 120 == 0) for (uint32_t i = 0; i < loc_npcs; i++) BusyWait(loc_jobtime);
+            loc_times.push_back(std::chrono::duration<float,std::micro>(std::chrono::steady_clock::now() - loc_start).count());
+        }
+        std::sort(loc_times.begin(),loc_times.end());
+        std::printf("inline updates (old): p50 = %.1f us, p99 = %.1f us, max = %.1f us\n",loc_times[loc_times.size()/2],loc_times[loc_times.size()*99/100],loc_times.back());
+    }
+    loc_run(500);
+    loc_run(100000);
+}
+
+TEST_CASE("Update LOD multiplier scales with distance and visibility", "[UpdateQueue]")
+{
+    DeviousDevices::UpdateLODSettings loc_settings;
+    loc_settings.nearDistance   = 1000.0f;
+    loc_settings.farDistance    = 5000.0f;
+    loc_settings.farMultiplier  = 5.0f;
+
+    REQUIRE(DeviousDevices::GetUpdateLODMultiplier(loc_settings,0.0f,true) == 1.0f);
+    REQUIRE(DeviousDevices::GetUpdateLODMultiplier(loc_settings,1000.0f,true) == 1.0f);
+    REQUIRE(DeviousDevices::GetUpdateLODMultiplier(loc_settings,3000.0f,true) == Approx(3.0f));
+    REQUIRE(DeviousDevices::GetUpdateLODMultiplier(loc_settings,8000.0f,true) == 5.0f);
+    REQUIRE(DeviousDevices::GetUpdateLODMultiplier(loc_settings,100.0f,false) == 0.0f);
+
+    loc_settings.deferOffscreen = false;
+    REQUIRE(DeviousDevices::GetUpdateLODMultiplier(loc_settings,100.0f,false) == 1.0f);
+
+    loc_settings.enabled = false;
+    REQUIRE(DeviousDevices::GetUpdateLODMultiplier(loc_settings,8000.0f,false) == 1.0f);
+}
+
+TEST_CASE("UpdateQueue defers off-screen actors until they are visible", "[UpdateQueue]")
+{
+    UpdateQueue loc_queue;
+    loc_queue.SetInterval(DeviousDevices::tGagExpression,10);
+    loc_queue.SetBudget(1000000);
+
+    int loc_calls = 0;
+    for (uint64_t loc_frame = 0; loc_frame < 100; loc_frame++)
+    {
+        loc_queue.Touch(1,loc_frame,0.0f);
+        loc_calls += static_cast<int>(loc_queue.Drain([](const UpdateQueue::Job&){}));
+    }
+    REQUIRE(loc_calls == 0);
+
+    //actor which becomes visible is updated immediately
+    loc_queue.Touch(1,100,1.0f);
+    REQUIRE(loc_queue.Drain([](const UpdateQueue::Job&){}) == 1);
+
+    //far actor is updated less often
+    loc_calls = 0;
+    for (uint64_t loc_frame = 101; loc_frame <= 200; loc_frame++)
+    {
+        loc_queue.Touch(1,loc_frame,2.0f);
+        loc_calls += static_cast<int>(loc_queue.Drain([](const UpdateQueue::Job&){}));
+    }
+    REQUIRE(loc_calls == 5);
+}
+
+TEST_CASE("Update LOD with synthetic actor field", "[.benchmark][UpdateQueue]")
+{
+    constexpr uint32_t loc_npcs   = 200;
+    constexpr uint64_t loc_frames = 60*60*2;
+
+    struct SyntheticActor
+    {
+        float   distance;
+        float   angle;
+    };
+
+    //actors randomly placed around camera in radius of 8000 units, camera rotates slowly
+    std::mt19937 loc_rnd(42U);
+    std::uniform_real_distribution<float> loc_dist(0.0f,8000.0f);
+    std::uniform_real_distribution<float> loc_angle(0.0f,360.0f);
+    std::vector<SyntheticActor> loc_actors(loc_npcs);
+    for (auto&& it : loc_actors) it = {loc_dist(loc_rnd),loc_angle(loc_rnd)};
+
+    auto loc_run = [&](const DeviousDevices::UpdateLODSettings& a_settings)
+    {
+        UpdateQueue loc_queue;
+        loc_queue.SetInterval(DeviousDevices::tGagExpression,120);
+        loc_queue.SetInterval(DeviousDevices::tNodeHider,60);
+        loc_queue.SetBudget(1000000);
+
+        size_t loc_jobs = 0;
+        double loc_lodtime = 0.0;
+        for (uint64_t loc_frame = 0; loc_frame < loc_frames; loc_frame++)
+        {
+            const float loc_camera = std::fmod(loc_frame*0.05f,360.0f);
+            const auto loc_start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < loc_npcs; i++)
+            {
+                //90 degree field of view
+                const float loc_diff = std::fabs(std::remainder(loc_actors[i].angle - loc_camera,360.0f));
+                const float loc_lod = DeviousDevices::GetUpdateLODMultiplier(a_settings,loc_actors[i].distance,loc_diff <= 45.0f);
+                loc_queue.Touch(0x100000 + i,loc_frame,loc_lod);
+            }
+            loc_lodtime += std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now() - loc_start).count();
+            loc_jobs += loc_queue.Drain([](const UpdateQueue::Job&){});
+        }
+        std::printf("LOD %s: %.2f updates per frame, LOD + queue time %.2f us per frame\n",a_settings.enabled ? "on" : "off",static_cast<double>(loc_jobs)/loc_frames,loc_lodtime/loc_frames);
+    };
+
+    DeviousDevices::UpdateLODSettings loc_settings;
+    loc_settings.enabled = false;
+    loc_run(loc_settings);
+    loc_settings.enabled = true;
+    loc_run(loc_settings);
+}
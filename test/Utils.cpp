@@ -0,0 +1,284 @@
+#include <catch.hpp>
+#include "Utils.h"
+
+using DeviousDevices::GenerationalSweeper;
+
+namespace
+{
+    // per actor update state, as kept by update queue
+    struct UpdateHandle
+    {
+        uint64_t    elapsedFrames   = 0UL;
+        uint64_t    lastUpdateFrame = 0UL;
+    };
+}
+
+TEST_CASE("GenerationalSweeper drops keys which are no longer touched", "[Utils]")
+{
+    GenerationalSweeper<uint32_t,int> loc_sweeper(10,3);
+
+    auto [loc_value,loc_inserted] = loc_sweeper.Touch(1,0);
+    REQUIRE(loc_inserted);
+    *loc_value = 42;
+    REQUIRE_FALSE(loc_sweeper.Touch(1,5).second);
+    REQUIRE(*loc_sweeper.Find(1) == 42);
+
+    // touched in generation 0, so it is kept until generation 3
+    for (uint64_t loc_frame = 0; loc_frame < 30; loc_frame++) REQUIRE(loc_sweeper.Sweep(loc_frame,[](const uint32_t&, int&){}) == 0);
+
+    std::vector<uint32_t> loc_expired;
+    REQUIRE(loc_sweeper.Sweep(30,[&](const uint32_t& a_key, int& a_value)
+    {
+        REQUIRE(a_value == 42);
+        loc_expired.push_back(a_key);
+    }) == 1);
+    REQUIRE(loc_expired == std::vector<uint32_t>{1});
+    REQUIRE(loc_sweeper.Find(1) == nullptr);
+    REQUIRE(loc_sweeper.Size() == 0);
+}
+
+TEST_CASE("GenerationalSweeper keeps keys touched again before expiration", "[Utils]")
+{
+    GenerationalSweeper<uint32_t,int> loc_sweeper(10,3);
+    loc_sweeper.Touch(1,0);
+    loc_sweeper.Touch(2,0);
+    loc_sweeper.Touch(1,25);
+
+    REQUIRE(loc_sweeper.Sweep(30,[](const uint32_t& a_key, int&){ REQUIRE(a_key == 2); }) == 1);
+    REQUIRE(loc_sweeper.Find(1) != nullptr);
+
+    // sweep called late after many generations still removes everything
+    REQUIRE(loc_sweeper.Sweep(1000,[](const uint32_t&, int&){}) == 1);
+    REQUIRE(loc_sweeper.Size() == 0);
+}
+
+TEST_CASE("GenerationalSweeper soak test with actors streaming in and out", "[Utils][soak]")
+{
+    constexpr uint64_t loc_fps          = 60;
+    constexpr uint64_t loc_frames       = 4*60*60*loc_fps;  // 4 hours of gameplay
+    constexpr uint64_t loc_genframes    = 40;
+    constexpr uint32_t loc_generations  = 4;
+    constexpr uint32_t loc_nearby       = 20;               // actors loaded around player at once
+    constexpr uint64_t loc_cellframes   = 3*60*loc_fps;     // player changes location every 3 minutes
+
+    GenerationalSweeper<uint32_t,UpdateHandle> loc_sweeper(loc_genframes,loc_generations);
+    std::unordered_map<uint32_t,uint64_t> loc_lasttouch;    // reference model
+    std::mt19937 loc_rnd(1234U);
+
+    uint32_t loc_firsthandle = 0;
+    size_t   loc_maxsize     = 0;
+    size_t   loc_removed     = 0;
+    for (uint64_t loc_frame = 0; loc_frame < loc_frames; loc_frame++)
+    {
+        // every location have new set of actors. Some of them are shared with previous location
+        if (loc_frame % loc_cellframes == 0) loc_firsthandle += loc_nearby/2;
+
+        for (uint32_t i = 0; i < loc_nearby; i++)
+        {
+            // actors are sometimes not updated for a few frames (AI process level changes, etc.)
+            if (loc_rnd() % 100 == 0) continue;
+
+            const uint32_t loc_handle = loc_firsthandle + i;
+            auto [loc_value,loc_inserted] = loc_sweeper.Touch(loc_handle,loc_frame);
+            if (loc_inserted) *loc_value = {0,loc_frame};
+            loc_value->elapsedFrames++;
+            loc_value->lastUpdateFrame = loc_frame;
+            loc_lasttouch[loc_handle] = loc_frame;
+        }
+
+        loc_removed += loc_sweeper.Sweep(loc_frame,[&](const uint32_t& a_handle, UpdateHandle& a_value)
+        {
+            REQUIRE(a_value.lastUpdateFrame == loc_lasttouch[a_handle]);
+            REQUIRE(loc_frame - a_value.lastUpdateFrame > (loc_generations - 1)*loc_genframes);
+            loc_lasttouch.erase(a_handle);
+        });
+        loc_maxsize = std::max(loc_maxsize,loc_sweeper.Size());
+
+        if (loc_frame % (10*loc_fps) == 0)
+        {
+            // sweeper and reference model have to match exactly
+            REQUIRE(loc_sweeper.Size() == loc_lasttouch.size());
+            for (auto&& [handle,lastframe] : loc_lasttouch)
+            {
+                REQUIRE(loc_sweeper.Find(handle) != nullptr);
+                REQUIRE(loc_frame - lastframe <= loc_generations*loc_genframes);
+            }
+        }
+    }
+
+    // map is bounded by actors of current and previous location
+    REQUIRE(loc_maxsize <= loc_nearby + loc_nearby/2);
+    REQUIRE(loc_removed > loc_frames/loc_cellframes);
+}
+
+TEST_CASE("SnapshotPublisher keeps references valid after publish", "[Utils]")
+{
+    struct Settings
+    {
+        int         value   = 1;
+        std::string name    = "default";
+    };
+
+    DeviousDevices::SnapshotPublisher<Settings> loc_publisher;
+    const Settings& loc_first = loc_publisher.Get();
+    REQUIRE(loc_first.value == 1);
+    REQUIRE(loc_publisher.GetPublishCount() == 1);
+
+    auto loc_new = std::make_unique<Settings>();
+    loc_new->value  = 2;
+    loc_new->name   = "reloaded";
+    loc_publisher.Publish(std::move(loc_new));
+
+    REQUIRE(loc_publisher.Get().value == 2);
+    REQUIRE(loc_publisher.Get().name == "reloaded");
+    REQUIRE(loc_first.name == "default");
+}
+
+TEST_CASE("Config read contention benchmark", "[.benchmark][Utils]")
+{
+    struct Settings
+    {
+        int     iLogging    = 1;
+        bool    bHideArms   = false;
+    };
+
+    constexpr int loc_reads = 2000000;
+
+    //previous implementation - lock, string key hash and cast on every read
+    DeviousDevices::Spinlock loc_lock;
+    int  loc_logging  = 1;
+    bool loc_hidearms = false;
+    std::unordered_map<std::string,void*> loc_cache;
+    loc_cache["Main.iLogging"]       = &loc_logging;
+    loc_cache["NodeHider.bHideArms"] = &loc_hidearms;
+    auto loc_readold = [&]()
+    {
+        DeviousDevices::UniqueLock lock(loc_lock);
+        return *(int*)loc_cache[std::string("Main.iLogging")] + (*(bool*)loc_cache[std::string("NodeHider.bHideArms")] ? 1 : 0);
+    };
+
+    DeviousDevices::SnapshotPublisher<Settings> loc_publisher;
+    auto loc_readnew = [&]()
+    {
+        const Settings& loc_settings = loc_publisher.Get();
+        return loc_settings.iLogging + (loc_settings.bHideArms ? 1 : 0);
+    };
+
+    auto loc_run = [](int a_threads, auto&& a_read)
+    {
+        std::atomic<int64_t> loc_sink = 0;
+        const auto loc_start = std::chrono::steady_clock::now();
+        std::vector<std::thread> loc_threads;
+        for (int t = 0; t < a_threads; t++)
+        {
+            loc_threads.emplace_back([&]()
+            {
+                int64_t loc_sum = 0;
+                for (int i = 0; i < loc_reads; i++) loc_sum += a_read();
+                loc_sink += loc_sum;
+            });
+        }
+        for (auto&& it : loc_threads) it.join();
+        const double loc_time = std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - loc_start).count();
+        REQUIRE(loc_sink == static_cast<int64_t>(a_threads)*loc_reads);
+        return loc_time/loc_reads;
+    };
+
+    for (int loc_threads : {1,2,4,8})
+    {
+        const double loc_old = loc_run(loc_threads,loc_readold);
+        const double loc_new = loc_run(loc_threads,loc_readnew);
+        std::printf("%d threads: locked map %.1f ns per read, snapshot %.2f ns per read\n",loc_threads,loc_old,loc_new);
+    }
+}
+
+TEST_CASE("FastRandom is deterministic for seed and uniform", "[Utils]")
+{
+    DeviousDevices::FastRandom loc_a(40U);
+    DeviousDevices::FastRandom loc_b(40U);
+    DeviousDevices::FastRandom loc_c(41U);
+    REQUIRE(loc_a.Next() == loc_b.Next());
+    REQUIRE(loc_a.Next() != loc_c.Next());
+
+    constexpr int loc_samples = 100000;
+    std::array<int,10> loc_buckets = {};
+    int loc_below = 0;
+    for (int i = 0; i < loc_samples; i++)
+    {
+        const double loc_value = loc_a.NextDouble(0.0,100.0);
+        REQUIRE(loc_value >= 0.0);
+        REQUIRE(loc_value < 100.0);
+        loc_buckets[static_cast<size_t>(loc_value/10.0)]++;
+        if (loc_value < 80.0) loc_below++;
+    }
+    for (int it : loc_buckets) REQUIRE(std::abs(it - loc_samples/10) < loc_samples/100);
+    REQUIRE(std::abs(loc_below - loc_samples*8/10) < loc_samples/100);
+
+    REQUIRE(&DeviousDevices::FastRandom::GetThreadLocal() == &DeviousDevices::FastRandom::GetThreadLocal());
+}
+
+TEST_CASE("CallBatch groups calls inside window", "[Utils]")
+{
+    using namespace std::chrono;
+    DeviousDevices::CallBatch loc_batch(milliseconds(100));
+    const steady_clock::time_point loc_start;
+
+    REQUIRE(loc_batch.Next(loc_start));
+    REQUIRE_FALSE(loc_batch.Next(loc_start + milliseconds(50)));
+    REQUIRE(loc_batch.Next(loc_start + milliseconds(140)));          //window is measured from first call of batch
+    REQUIRE(loc_batch.Next(loc_start + milliseconds(300)));
+
+    //continuous calls never keep one batch open longer than window
+    DeviousDevices::CallBatch loc_continuous(milliseconds(100));
+    int loc_batches = 0;
+    for (int i = 0; i <= 50; i++) loc_batches += loc_continuous.Next(loc_start + seconds(1) + milliseconds(20*i));
+    REQUIRE(loc_batches == 9);
+}
+
+TEST_CASE("Take all benchmark", "[.benchmark][Utils]")
+{
+    //taking all items from 500 item container. Worn mittens check is simulated by scan over worn items
+    constexpr int loc_items = 500;
+    constexpr int loc_repeats = 20;
+    std::vector<uint32_t> loc_worn(30);
+    std::iota(loc_worn.begin(),loc_worn.end(),1U);
+    volatile int loc_sink = 0;
+    auto loc_wornCheck = [&]
+    {
+        return std::find(loc_worn.begin(),loc_worn.end(),static_cast<uint32_t>(loc_sink) + 25) != loc_worn.end();
+    };
+
+    //old path - random_device, mt19937 and worn check for every item
+    auto loc_start = std::chrono::steady_clock::now();
+    for (int r = 0; r < loc_repeats; r++)
+    {
+        for (int i = 0; i < loc_items; i++)
+        {
+            if (!loc_wornCheck()) continue;
+            std::random_device rd;
+            std::mt19937 gen(rd());
+            std::uniform_real_distribution<> distr(0.0f, 100.0f);
+            loc_sink = loc_sink + (distr(gen) < 80.0f);
+            loc_sink = 0;
+        }
+    }
+    const double loc_oldTime = std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now() - loc_start).count()/loc_repeats;
+
+    //new path - one worn check per batch and thread local generator
+    loc_start = std::chrono::steady_clock::now();
+    for (int r = 0; r < loc_repeats; r++)
+    {
+        DeviousDevices::CallBatch loc_batch(std::chrono::milliseconds(100));
+        bool loc_enabled = false;
+        for (int i = 0; i < loc_items; i++)
+        {
+            if (loc_batch.Next()) loc_enabled = loc_wornCheck();
+            if (!loc_enabled) continue;
+            loc_sink = loc_sink + (DeviousDevices::FastRandom::GetThreadLocal().NextDouble(0.0,100.0) < 80.0);
+            loc_sink = 0;
+        }
+    }
+    const double loc_newTime = std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now() - loc_start).count()/loc_repeats;
+
+    std::printf("take all (%d items): per item rng %.1f us, batched %.1f us\n",loc_items,loc_oldTime,loc_newTime);
+}
@@ -0,0 +1,130 @@
+#include <catch.hpp>
+#include "WhitelistMatcher.h"
+
+using DeviousDevices::WhitelistMatcher;
+
+namespace
+{
+    //original whitelist check - lower case name and search for every entry
+    uint8_t NaiveMatch(std::string a_name, const std::vector<std::pair<std::string,uint8_t>>& a_patterns)
+    {
+        std::transform(a_name.begin(),a_name.end(),a_name.begin(),WhitelistMatcher::Fold);
+        uint8_t loc_res = 0;
+        for (auto&& [pattern,mask] : a_patterns)
+        {
+            std::string loc_pattern = pattern;
+            std::transform(loc_pattern.begin(),loc_pattern.end(),loc_pattern.begin(),WhitelistMatcher::Fold);
+            if ((loc_pattern != "") && (loc_pattern != " ") && (a_name.find(loc_pattern) != std::string::npos)) loc_res |= mask;
+        }
+        return loc_res;
+    }
+
+    std::string RandomString(std::mt19937& a_rnd, size_t a_minLen, size_t a_maxLen, std::string_view a_alphabet)
+    {
+        std::string loc_res(a_minLen + a_rnd() % (a_maxLen - a_minLen + 1),' ');
+        for (auto&& it : loc_res) it = a_alphabet[a_rnd() % a_alphabet.size()];
+        return loc_res;
+    }
+}
+
+TEST_CASE("Whitelist matcher finds overlapping patterns", "[WhitelistMatcher]")
+{
+    WhitelistMatcher loc_matcher;
+    loc_matcher.AddPattern("he",1);
+    loc_matcher.AddPattern("she",2);
+    loc_matcher.AddPattern("his",4);
+    loc_matcher.AddPattern("hers",8);
+    loc_matcher.AddPattern("",16);
+    loc_matcher.AddPattern(" ",16);
+    loc_matcher.Build();
+
+    REQUIRE(loc_matcher.GetMask() == 15);
+    REQUIRE(loc_matcher.Match("ushers") == (1|2|8));
+    REQUIRE(loc_matcher.Match("USHERS") == (1|2|8));
+    REQUIRE(loc_matcher.Match("ahishe") == (1|2|4));
+    REQUIRE(loc_matcher.Match("xyz hs") == 0);
+    REQUIRE(loc_matcher.Match("") == 0);
+
+    //stops after first match when only one list is requested
+    REQUIRE((loc_matcher.Match("she hers",2) & 2));
+}
+
+TEST_CASE("Whitelist matcher without patterns matches nothing", "[WhitelistMatcher]")
+{
+    WhitelistMatcher loc_unbuilt;
+    REQUIRE(loc_unbuilt.Match("anything") == 0);
+
+    WhitelistMatcher loc_matcher;
+    loc_matcher.Build();
+    REQUIRE(loc_matcher.GetMask() == 0);
+    REQUIRE(loc_matcher.Match("anything") == 0);
+}
+
+TEST_CASE("Whitelist matcher is equivalent to per entry search", "[WhitelistMatcher]")
+{
+    std::mt19937 loc_rnd(37U);
+    constexpr std::string_view loc_alphabet = "abcAB c'";
+    for (int t = 0; t < 200; t++)
+    {
+        std::vector<std::pair<std::string,uint8_t>> loc_patterns;
+        WhitelistMatcher loc_matcher;
+        const int loc_count = 1 + loc_rnd() % 20;
+        for (int i = 0; i < loc_count; i++)
+        {
+            loc_patterns.push_back({RandomString(loc_rnd,0,5,loc_alphabet),static_cast<uint8_t>(1U << (loc_rnd() % 2))});
+            loc_matcher.AddPattern(loc_patterns.back().first,loc_patterns.back().second);
+        }
+        loc_matcher.Build();
+
+        for (int i = 0; i < 50; i++)
+        {
+            const std::string loc_name = RandomString(loc_rnd,0,30,loc_alphabet);
+            REQUIRE(loc_matcher.Match(loc_name) == NaiveMatch(loc_name,loc_patterns));
+        }
+    }
+}
+
+TEST_CASE("Whitelist matcher benchmark", "[.benchmark][WhitelistMatcher]")
+{
+    std::mt19937 loc_rnd(7U);
+    constexpr std::string_view loc_alphabet = "abcdefghijklmnopqrstuvwxyz ";
+    std::vector<std::string> loc_names;
+    for (int i = 0; i < 1000; i++) loc_names.push_back(RandomString(loc_rnd,10,40,loc_alphabet));
+
+    for (int loc_count : {10,50,200,1000})
+    {
+        std::vector<std::string> loc_whitelist;
+        WhitelistMatcher loc_matcher;
+        for (int i = 0; i < loc_count; i++)
+        {
+            loc_whitelist.push_back(RandomString(loc_rnd,4,16,loc_alphabet));
+            loc_matcher.AddPattern(loc_whitelist.back(),1);
+        }
+        loc_matcher.Build();
+
+        constexpr int loc_iterations = 20000;
+        volatile size_t loc_sink = 0;
+
+        //old path - whitelist copied from config, name lower cased, find for every entry
+        auto loc_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < loc_iterations; i++)
+        {
+            const std::vector<std::string> loc_copy = loc_whitelist;
+            std::string loc_name = loc_names[i % loc_names.size()];
+            std::transform(loc_name.begin(),loc_name.end(),loc_name.begin(),::tolower);
+            bool loc_found = false;
+            for (auto&& it : loc_copy)
+            {
+                if ((it != "") && (it != " ") && (loc_name.find(it) != std::string::npos)) { loc_found = true; break; }
+            }
+            loc_sink = loc_sink + loc_found;
+        }
+        const double loc_oldTime = std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - loc_start).count()/loc_iterations;
+
+        loc_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < loc_iterations; i++) loc_sink = loc_sink + loc_matcher.Match(loc_names[i % loc_names.size()],1);
+        const double loc_newTime = std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - loc_start).count()/loc_iterations;
+
+        std::printf("%4d entries: find loop %8.1f ns, automaton %6.1f ns (%zu states)\n",loc_count,loc_oldTime,loc_newTime,loc_matcher.GetStateCount());
+    }
+}